@@ -150,6 +150,10 @@ SOURCE=..\..\include\SoFont.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\SoFramePacer.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\SoImage.h
 # End Source File
 # Begin Source File
@@ -178,6 +182,10 @@ SOURCE=..\..\include\SoMesh.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\SoMode3Renderer.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\SoMode4PolygonRasterizer.h
 # End Source File
 # Begin Source File
@@ -186,6 +194,10 @@ SOURCE=..\..\include\SoMode4Renderer.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\SoMode5Renderer.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\SoMultiPlayer.h
 # End Source File
 # Begin Source File
@@ -198,6 +210,18 @@ SOURCE=..\..\include\SoPolygon.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\SoRLEImage.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\SoRenderer.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\SoSceneNode.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\SoSound.h
 # End Source File
 # Begin Source File
@@ -226,6 +250,10 @@ SOURCE=..\..\include\SoTables.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\SoTextureCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\SoTileSet.h
 # End Source File
 # Begin Source File
@@ -297,6 +325,10 @@ SOURCE=..\..\source\SoFont.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoFramePacer.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoImage.c
 # End Source File
 # Begin Source File
@@ -329,14 +361,34 @@ SOURCE=..\..\source\SoMeshCube.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoMode3Renderer.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoMode4PolygonRasterizer.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoMode4PolygonRasterizerLine.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\source\SoMode4PolygonRasterizerSpanBuffer.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\source\SoMode4PolygonRasterizerTexturedTriangle.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoMode4Renderer.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoMode5Renderer.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoMultiPlayer.c
 # End Source File
 # Begin Source File
@@ -349,6 +401,18 @@ SOURCE=..\..\source\SoPolygon.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoRLEImage.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\source\SoRenderer.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\source\SoSceneNode.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoSound.c
 # End Source File
 # Begin Source File
@@ -377,6 +441,10 @@ SOURCE=..\..\source\SoTables.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\SoTextureCache.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\SoTileSet.c
 # End Source File
 # Begin Source File
@@ -415,6 +483,10 @@ SOURCE=..\..\source\SoMode4PolygonRasterizerSolidTriangle.s
 
 SOURCE=..\..\source\SoMode4RendererClear.s
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\source\SoMode4RendererCrossFade.s
+# End Source File
 # End Group
 # End Group
 # Begin Group "Documentation"
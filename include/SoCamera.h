@@ -39,9 +39,59 @@
 #include "SoTransform.h"
 #include "SoMatrix.h"
 #include "SoMesh.h"
+#include "SoSceneNode.h"
 #include "SoPolygon.h"
 #include "SoMath.h"
 #include "SoDisplay.h"
+#include "SoRenderer.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Number of depth buckets in the frame ordering table.
+
+	Polygons submitted between \a SoCameraBeginFrame and \a SoCameraEndFrame are 
+	put in one of these buckets, according to their average camera space Z. 
+	Polygons in the same bucket are drawn in no particular order. The bucket heads
+	are stored in IWRAM (2 bytes each). Keep it even, they are cleared two at a time.
+*/
+#define SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS		256
+
+/*!
+	\brief Maximum number of triangles that can be submitted in one frame.
+
+	Polygons are split into triangles when they are submitted. These triangles
+	are stored in EWRAM, at about 75 bytes each. Triangles submitted after this
+	maximum is reached are not drawn.
+*/
+#define SO_CAMERA_ORDERING_TABLE_MAX_NUM_TRIANGLES	512
+
+/*!
+	\brief Field of view a camera starts with, in 256ths of a circle.
+
+	About 62 degrees, which puts the projection plane at 200 pixels from the eye.
+	See \a SoCameraSetFieldOfView.
+*/
+#define SO_CAMERA_DEFAULT_FIELD_OF_VIEW				44
+
+/*!
+	\brief Aspect ratio a camera starts with, the width over the height of the screen.
+
+	The GBA has square pixels, so this doesn't stretch the image.
+	See \a SoCameraSetFieldOfView.
+*/
+#define SO_CAMERA_DEFAULT_ASPECT_RATIO				SO_FIXED_FROM_FLOAT( 1.5 )
+
+/*!
+	\brief Number of pixels the guard band reaches beyond the edges of the screen.
+
+	See \a SoCameraSetGuardBandClippingEnable. Vertices in the guard band are 
+	projected with a little less precision to make room for them. Don't make this
+	any bigger, or the fixed point math of the 2D clipper overflows.
+*/
+#define SO_CAMERA_GUARD_BAND_SIZE					128
 
 // ----------------------------------------------------------------------------
 // Typedefs
@@ -61,16 +111,29 @@
 typedef struct
 {
 	SoTransform m_Transform;					//!< \internal 
+	SoMatrix	m_WorldToCameraMatrix;			//!< \internal Cached inverse of the transform.
+	bool		m_WorldToCameraMatrixDirty;		//!< \internal True if the transform changed after that was calculated.
 
 	SoVector3	m_LeftFrustumPlaneNormal;		//!< \internal 
 	SoVector3	m_TopFrustumPlaneNormal;		//!< \internal 
 
 	bool		m_ClipAgainstFarAndNearPlane;	//!< \internal 
 	bool		m_ClipAgainstFrustumSidePlanes;	//!< \internal 
+	bool		m_GuardBandClipping;			//!< \internal 
+	bool		m_Wireframe;					//!< \internal 
+
+	void*		m_BinBuffer;					//!< \internal 
+	u32			m_BinBufferSize;				//!< \internal 
+	u32			m_BinClearPaletteIndex;			//!< \internal 
+	const SoRenderer* m_Renderer;				//!< \internal 
 
 	s32			m_NearPlaneDistance;			//!< \internal 
 	s32			m_FarPlaneDistance;				//!< \internal 
-	s32			m_ProjectionPlaneDistance;		//!< \internal 
+	s32			m_ProjectionPlaneDistanceX;		//!< \internal Horizontal, in screen pixels.
+	s32			m_ProjectionPlaneDistanceY;		//!< \internal Vertical, in screen pixels.
+
+	sofixedpoint m_GuardBandSlopeX;				//!< \internal Largest X over Z of a vertex in the guard band.
+	sofixedpoint m_GuardBandSlopeY;				//!< \internal Largest Y over Z of a vertex in the guard band.
 
 } SoCamera;
 // ----------------------------------------------------------------------------
@@ -90,10 +153,24 @@ void SoCameraSetRoll(	 SoCamera* a_This, s32 a_Angle );
 
 void SoCameraSetTranslation( SoCamera* a_This, sofixedpoint a_X, sofixedpoint a_Y, sofixedpoint a_Z );
 
+void SoCameraSetFieldOfView( SoCamera* a_This, u32 a_Angle, sofixedpoint a_AspectRatio );
+
 void SoCameraDrawMesh(	 SoCamera* a_This, SoMesh* a_Mesh );
+void SoCameraDrawSceneNode( SoCamera* a_This, SoSceneNode* a_Node );
+
+void SoCameraBeginFrame(  SoCamera* a_This );
+void SoCameraSubmitMesh(  SoCamera* a_This, SoMesh* a_Mesh );
+void SoCameraSubmitSceneNode( SoCamera* a_This, SoSceneNode* a_Node );
+void SoCameraEndFrame(	  SoCamera* a_This );
 
 void SoCameraSetFarAndNearPlaneClippingEnable( SoCamera* a_This, bool a_Enable );
 void SoCameraSetFrustumSidePlanesClippingEnable( SoCamera* a_This, bool a_Enable );
+void SoCameraSetGuardBandClippingEnable( SoCamera* a_This, bool a_Enable );
+
+void SoCameraSetWireframeEnable( SoCamera* a_This, bool a_Enable );
+
+void SoCameraSetBinning( SoCamera* a_This, void* a_Buffer, u32 a_Size, u32 a_ClearPaletteIndex );
+void SoCameraSetRenderer( SoCamera* a_This, const SoRenderer* a_Renderer );
 
 // ----------------------------------------------------------------------------
 // EOF
@@ -25,8 +25,14 @@
 	\defgroup SoFont SoFont
 	\brief	  Font functionality
 	
-	This module is for all font handling, it's rather primitive at the moment,
-	but in the future this will change.
+	This module is for all font handling. There are two kinds of fonts.
+
+	Fixed width fonts are just an image with all the characters next to each 
+	other, see \a SoFontGetDefaultFontImage and \a SoMode4RendererDrawString.
+
+	Proportional fonts are \a SoFont instances. Every glyph has its own width, 
+	pairs of characters can be moved closer together (kerning) and glyphs 
+	can be drawn at any X. See \a SoFontInitialize and \a SoMode4RendererDrawText.
 
 	A default font is also implemented in this file, but this does not mean
 	that you should define other fonts here too. You can define them anywhere,
@@ -63,12 +69,73 @@
 //!			 compatible with mode 4.
 #define SO_FONT_HORIZONTAL_SPACING 4
 
+//! Number of glyphs in a proportional font, one for every character from the first to the last one.
+#define SO_FONT_NUM_GLYPHS	(SO_FONT_LAST_CHAR - SO_FONT_FIRST_CHAR + 1)
+
+// ----------------------------------------------------------------------------
+// Typedefs;
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Moves two characters closer together, or further apart.
+
+	See \a SoFontSetKerningPairs.
+*/
+typedef struct
+{
+	char	m_First;	//!< Character on the left.
+	char	m_Second;	//!< Character on the right.
+	s8		m_Adjust;	//!< Pixels to add to the spacing in between, usually negative.
+
+} SoFontKerningPair;
+
+/*!
+	\brief Proportional font.
+
+	All its members are private, use the \a SoFont methods to access them.
+*/
+typedef struct
+{
+	const SoImage*			 m_Image;							//!< \internal Image with the glyphs.
+	u16						 m_GlyphX[ SO_FONT_NUM_GLYPHS ];		//!< \internal Leftmost column of each glyph in the image.
+	u8						 m_GlyphWidths[ SO_FONT_NUM_GLYPHS ];	//!< \internal Width of each glyph.
+	u8						 m_Spacing;							//!< \internal Pixels in between two glyphs.
+	u8						 m_SpaceWidth;						//!< \internal Pixels in between two words.
+	const SoFontKerningPair* m_KerningPairs;					//!< \internal Sorted kerning pairs, or \a NULL.
+	u32						 m_NumKerningPairs;					//!< \internal Number of kerning pairs.
+	u16*					 m_Cache;							//!< \internal Glyphs as pixel pairs, see \a SoFontCache.
+
+} SoFont;
+
 // ----------------------------------------------------------------------------
 // Functions;
 // ----------------------------------------------------------------------------
 
 const SoImage* SoFontGetDefaultFontImage();
 
+void SoFontInitialize(	 SoFont* a_This, const SoImage* a_Image, const u16* a_GlyphX, 
+						 const u8* a_GlyphWidths, u32 a_Spacing, u32 a_SpaceWidth );
+void SoFontInitializeFromFixedWidthImage( SoFont* a_This, const SoImage* a_Image, u32 a_Spacing );
+
+void SoFontSetKerningPairs( SoFont* a_This, const SoFontKerningPair* a_Pairs, u32 a_NumPairs );
+
+u32	 SoFontGetGlyphWidth(	const SoFont* a_This, char a_Character );
+s32	 SoFontGetKerning(		const SoFont* a_This, char a_First, char a_Second );
+u32	 SoFontGetAdvance(		const SoFont* a_This, char a_Character, char a_Next );
+u32	 SoFontGetStringWidth(	const SoFont* a_This, const char* a_String );
+
+u32	 SoFontGetCacheSize(	const SoFont* a_This );
+void SoFontCache(			SoFont* a_This, void* a_Buffer );
+
+//! Returns the height of the glyphs of a proportional font.
+#define SoFontGetHeight( a_This )			((u32) SoImageGetHeight( (a_This)->m_Image ))
+
+//! Returns the space in between two words of a proportional font.
+#define SoFontGetSpaceWidth( a_This )		((u32) (a_This)->m_SpaceWidth)
+
+//! Returns true if a character has a glyph.
+#define SoFontIsDrawable( a_Character )		((a_Character) >= SO_FONT_FIRST_CHAR && (a_Character) <= SO_FONT_LAST_CHAR)
+
 // ----------------------------------------------------------------------------
 // EOF
 // ----------------------------------------------------------------------------
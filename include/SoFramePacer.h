@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoFramePacer.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoFramePacer
+
+	See the \a SoFramePacer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_FRAME_PACER_H
+#define SO_FRAME_PACER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoFramePacer SoFramePacer
+	\brief	  Interrupt driven frame pacing with frame skipping
+
+	Singleton
+
+	Waiting for VBlank and flipping by hand means that a frame that takes a
+	little too long is shown a whole VBlank late, and you never know by how much
+	you're behind. The frame pacer takes the VBlank interrupt of the
+	\a SoIntManager instead. It counts VBlanks, and flips the renderer in the
+	first VBlank after the frame is finished and the target frame time has passed.
+
+	The game runs its simulation in fixed steps of one target frame time, and
+	renders once per loop:
+
+	\code
+	SoFramePacerEnable( &g_SoMode4Renderer, SO_FRAME_PACER_30_HZ );
+
+	for ( ;; )
+	{
+		steps = SoFramePacerGetNumSteps();
+
+		while ( steps-- ) Simulate();
+
+		Render();
+
+		SoFramePacerEndFrame();
+	}
+	\endcode
+
+	When rendering is fast enough, there's one step per loop. When a frame
+	takes longer, the next loop does more steps, so the game keeps the same
+	speed and only the rendering skips frames. \a SoFramePacerGetFrameVBlanks
+	tells how long the last frame took.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoIntManager.h"
+#include "SoRenderer.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Target frame rates, in VBlanks per frame.
+
+	See \a SoFramePacerEnable.
+*/
+//@{
+#define SO_FRAME_PACER_60_HZ			1
+#define SO_FRAME_PACER_30_HZ			2
+#define SO_FRAME_PACER_20_HZ			3
+//@}
+
+/*!
+	\brief Maximum number of steps \a SoFramePacerGetNumSteps returns.
+
+	When the game falls further behind than this (when loading, for example),
+	the time in between is dropped, instead of simulating it all at once.
+*/
+#define SO_FRAME_PACER_MAX_NUM_STEPS	4
+
+// ----------------------------------------------------------------------------
+// Public methods;
+// ----------------------------------------------------------------------------
+
+void SoFramePacerEnable(	 const SoRenderer* a_Renderer, u32 a_VBlanksPerFrame );
+void SoFramePacerDisable(	 void );
+
+void SoFramePacerSetVBlanksPerFrame( u32 a_VBlanksPerFrame );
+u32  SoFramePacerGetVBlanksPerFrame( void );
+
+void SoFramePacerSetVBlankHandler( SoInterruptHandler a_Handler );
+
+void SoFramePacerEndFrame(	 void );
+
+u32  SoFramePacerGetNumSteps(	  void );
+u32  SoFramePacerGetFrameVBlanks( void );
+u32  SoFramePacerGetVBlankCount(  void );
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -27,6 +27,13 @@
 	
 	This module represents 8bit palettized and 16bit images
 
+	Palettized images can carry a chain of mipmaps, to be used as textures. 
+	Every level is half the width and half the height of the previous one, but
+	never smaller than one pixel. The levels are stored right after each other 
+	in the image data, starting with the full size image. So an 8 by 4 image with
+	three levels has 32 + 8 + 2 bytes of data. Build the chain offline and use
+	\a SoImageSetNumMipLevels to tell the image about it.
+
 	You can use the \a SoConverter.exe tool to convert image data to 
 	Socrates compatible header files, ready to be included in the project.
 
@@ -57,6 +64,8 @@ typedef struct
 	bool    m_Palettized;   //!< \internal True if the image is palettized, false otherwise;
 	
 	u16*	m_Data;			//!< \internal Array of image data;
+
+	u8		m_NumMipLevels;	//!< \internal Number of mipmap levels in the data, 0 or 1 if there are no mipmaps;
 	
 } SoImage;
 
@@ -72,6 +81,8 @@ typedef struct
 
 void SoImageBkgLoad( const SoImage* a_This, u32 a_CharBase, u32 a_BaseIdx );
 
+u16* SoImageGetMipLevelData( const SoImage* a_This, u32 a_Level );
+
 //! Returns the width of the image (texture)
 #define SoImageGetWidth(a_This)  ((const u16)((a_This)->m_Width))
 
@@ -84,6 +95,20 @@ void SoImageBkgLoad( const SoImage* a_This, u32 a_CharBase, u32 a_BaseIdx );
 //! Tests whether an image is palettized or not (returns true if palettized)
 #define SoImageIsPalettized(a_This)  ((const bool)((a_This)->m_Palettized))
 
+//! Returns the number of mipmap levels of the image, which is 1 if there are no mipmaps
+#define SoImageGetNumMipLevels(a_This)  ((u32)((a_This)->m_NumMipLevels > 1 ? (a_This)->m_NumMipLevels : 1))
+
+//! Tells the image how many mipmap levels its data contains, see the \a SoImage module
+#define SoImageSetNumMipLevels(a_This, a_NumLevels)  ((a_This)->m_NumMipLevels = (a_NumLevels))
+
+//! Returns the width of the given mipmap level of the image
+#define SoImageGetMipLevelWidth(a_This, a_Level)	\
+		((SoImageGetWidth(a_This) >> (a_Level)) ? (SoImageGetWidth(a_This) >> (a_Level)) : 1)
+
+//! Returns the height of the given mipmap level of the image
+#define SoImageGetMipLevelHeight(a_This, a_Level)	\
+		((SoImageGetHeight(a_This) >> (a_Level)) ? (SoImageGetHeight(a_This) >> (a_Level)) : 1)
+
 //! Creates an image from given attributes
 #define SoImageInitialize(a_This, a_Width, a_Height, a_Palettized, a_Data)	\
 		{																	\
@@ -91,6 +116,7 @@ void SoImageBkgLoad( const SoImage* a_This, u32 a_CharBase, u32 a_BaseIdx );
 			(a_This)->m_Height = a_Height;									\
 			(a_This)->m_Palettized = a_Palettized;							\
 			(a_This)->m_Data = a_Data;										\
+			(a_This)->m_NumMipLevels = 1;									\
 		}
 
 
@@ -134,6 +134,30 @@ s32 SoMathModulus( s32 a_Numerator, s32 a_Denominator );
 // ----------------------------------------------------------------------------
 s32 SoMathDivide( s32 a_Numerator, s32 a_Denominator );
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Divide macro for ARM compiled IWRAM code.
+
+    \param	n	Whole numerator.
+	\param  d	Whole denominator.
+
+	Does the same as \a SoMathDivide, but does the SWI call inline. Code in IWRAM
+	can't do a normal call to \a SoMathDivide in ROM, and the divide operator
+	would pull in the slow libgcc divide. Only use this in code compiled as ARM.
+*/
+// ----------------------------------------------------------------------------
+#ifdef __arm__
+	#define SO_MATH_DIVIDE_ARM( n, d )	({													\
+		register s32 numerator_   asm( "r0" ) = (n);											\
+		register s32 denominator_ asm( "r1" ) = (d);											\
+		asm volatile ( "swi 0x60000" : "+r" ( numerator_ ), "+r" ( denominator_ ) : : "r3" );	\
+		numerator_;																				\
+	})
+#else
+	// The host tests (see tools/SoRasterizerTest) have no BIOS to call;
+	#define SO_MATH_DIVIDE_ARM( n, d )	SoMathDivide( (n), (d) )
+#endif
+
 // ----------------------------------------------------------------------------
 // Macros;
 // ----------------------------------------------------------------------------
@@ -191,6 +215,11 @@ s32 SoMathDivide( s32 a_Numerator, s32 a_Denominator );
 //! Multiply macro to multiply two fixed point numbers
 #define	SO_FIXED_MULTIPLY( n, m )				  ( (((n)>>4)   * ((m)>>4))     >> 8 )
 
+//! Multiply macro that keeps the full 64 bit intermediate result, so it never overflows
+//! as long as the result fits. Only use this in ARM compiled code, where it is a single
+//! smull instruction. In thumb code it results in a slow library call.
+#define	SO_FIXED_MULTIPLY_LONG( n, m )			  ( (s32)( ((s64)(n) * (s64)(m)) >> SO_FIXED_Q ) )
+
 //! Divide macro to divide a small fixed number by a big fixed point number
 #define SO_FIXED_DIVIDE_SMALL_BIG( n, m )	( (((n)<<8) / (m)) << 8 )
 
@@ -207,6 +236,11 @@ s32 SoMathDivide( s32 a_Numerator, s32 a_Denominator );
 //! Well, slow. Uses a bios SWI call for faster divides.
 #define SO_FIXED_ONE_OVER_SLOW_ACCURATE( n )	( SoMathDivide( (SO_FIXED_FROM_WHOLE( 1 ) << (30 - SO_FIXED_Q)), ((n)>>(SO_FIXED_Q - (30 - SO_FIXED_Q)))))
 
+//! Accurate one-over macro for ARM compiled IWRAM code, using \a SO_MATH_DIVIDE_ARM. Only for
+//! positive numbers. Numbers too small to divide by give the largest one-over instead of a
+//! division by zero.
+#define SO_FIXED_ONE_OVER_ARM( n )	( SO_MATH_DIVIDE_ARM( (SO_FIXED_FROM_WHOLE( 1 ) << (30 - SO_FIXED_Q)), SO_MAX( (n)>>(SO_FIXED_Q - (30 - SO_FIXED_Q)), 1 ) ) )
+
 /*! 
 	\brief Returns the fixed point sine of an angle. A full circle is 256 degrees.
 
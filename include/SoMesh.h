@@ -55,6 +55,15 @@
 */
 #define SO_MESH_MAX_NUM_VERTICES 512
 
+/*! 
+	\brief Defines the maximum number of polygons of a mesh that is culled in object space.
+
+	The camera keeps one bit per polygon for those meshes, see 
+	\a SoMeshCalculatePolygonPlanes. Meshes with more polygons are only culled 
+	on the screen, even if they have polygon planes.
+*/
+#define SO_MESH_MAX_NUM_POLYGONS 1024
+
 // ----------------------------------------------------------------------------
 // Typedefs
 // ----------------------------------------------------------------------------
@@ -91,6 +100,30 @@ typedef struct
 	*/
 	SoVector3*		m_Vertices;			
 
+	/*!
+		\internal
+
+		\brief Number of pixels between two perspective divides.
+
+		Zero means the texture is mapped affinely. Kept at the end of the struct so
+		existing static mesh initializers leave it zero.
+	*/
+	u32				m_PerspectiveSpanLength;
+
+	/*!
+		\internal
+
+		\brief Center of a sphere around all the vertices, in object space.
+
+		See \a SoMeshCalculateBoundingSphere.
+	*/
+	SoVector3		m_BoundingSphereCenter;
+
+	//! \internal Radius of the bounding sphere. Zero if there is none, so the mesh is never culled.
+	sofixedpoint	m_BoundingSphereRadius;
+
+	//! \internal True if every polygon has its plane calculated, see \a SoMeshCalculatePolygonPlanes.
+	bool			m_HasPolygonPlanes;
 
 } SoMesh;
 
@@ -99,8 +132,10 @@ typedef struct
 // ----------------------------------------------------------------------------
 
 void		 SoMeshSetTexture(		SoMesh* a_This, SoImage* a_Texture );
+void		 SoMeshSetPerspectiveSpanLength( SoMesh* a_This, u32 a_SpanLength );
 
 SoImage*	 SoMeshGetTexture(		SoMesh* a_This );
+u32			 SoMeshGetPerspectiveSpanLength( SoMesh* a_This );
 u32			 SoMeshGetNumVertices(  SoMesh* a_This );
 u32			 SoMeshGetNumPolygons(  SoMesh* a_This );
 SoVector3*	 SoMeshGetVertex(		SoMesh* a_This, u32 a_Index );
@@ -108,6 +143,13 @@ SoPolygon*	 SoMeshGetPolygon(		SoMesh* a_This, u32 a_Index );
 
 SoTransform* SoMeshGetTransform(	SoMesh* a_This );
 
+void		 SoMeshCalculateBoundingSphere(	 SoMesh* a_This );
+SoVector3*	 SoMeshGetBoundingSphereCenter(	 SoMesh* a_This );
+sofixedpoint SoMeshGetBoundingSphereRadius(	 SoMesh* a_This );
+
+void		 SoMeshCalculatePolygonPlanes(	 SoMesh* a_This );
+bool		 SoMeshHasPolygonPlanes(		 SoMesh* a_This );
+
 void		 SoMeshMakeDefaultCube(	SoMesh* a_This );
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode3Renderer.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode3Renderer
+
+	See the \a SoMode3Renderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_MODE_3_RENDERER_H
+#define SO_MODE_3_RENDERER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoMode3Renderer SoMode3Renderer
+	\brief	  Handles all basic mode 3 rendering.
+
+	Singleton
+
+	A single 240 by 160 buffer of 16 bit colors. Everything you draw shows
+	up right away, so draw during VBlank or live with the tearing. Palettized
+	images are drawn through the palette of \a SoRendererSetPalette.
+
+	Also available as \a g_SoMode3Renderer, see \a SoRenderer.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+
+#include "SoSystem.h"
+#include "SoImage.h"
+#include "SoMode4Renderer.h"
+
+// --------------------------------------------------------------------------
+// Functions implemented in C (documentation in .C file).
+// --------------------------------------------------------------------------
+
+void  SoMode3RendererEnable(	  void );
+void  SoMode3RendererClear(	  void );
+void* SoMode3RendererGetBuffer( void );
+
+void  SoMode3RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y,
+						   const SoMode4RendererRectangle* a_Source, u32 a_Flags );
+
+void  SoMode3RendererDrawPixel( u32 a_X, u32 a_Y, u16 a_Color );
+
+// --------------------------------------------------------------------------
+// EOF;
+// --------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -42,6 +42,46 @@ extern "C" {
 #include "SoVector.h"
 #include "SoImage.h"
 
+// --------------------------------------------------------------------------
+// Defines;
+// --------------------------------------------------------------------------
+
+/*!
+	\brief Maximum number of covered spans the span buffer remembers per scanline.
+
+	Every scanline costs twice this number of bytes of IWRAM. 
+*/
+#define SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS	16
+
+/*!
+	\brief Texture modes, see \a SoMode4PolygonRasterizerSetTextureMode.
+
+	The transparent and translucent flags can be combined.
+*/
+//@{
+#define SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE			0			//!< Every texel is written.
+#define SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSPARENT		SO_BIT_0	//!< Texels with palette index 0 are skipped.
+#define SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSLUCENT		SO_BIT_1	//!< Texels are blended with the background through \a g_Fade.
+//@}
+
+// --------------------------------------------------------------------------
+// Typedefs;
+// --------------------------------------------------------------------------
+
+/*!
+	\brief Describes the 8 bit buffer the rasterizer renders to.
+
+	See \a SoMode4PolygonRasterizerSetRenderTarget.
+*/
+typedef struct
+{
+	void*	m_Buffer;	//!< Top left pixel of the target, on a 16 bit boundary.
+	u32		m_Width;	//!< Width in pixels, at most \a SO_SCREEN_WIDTH.
+	u32		m_Height;	//!< Height in pixels, at most \a SO_SCREEN_HEIGHT.
+	u32		m_Pitch;	//!< Number of bytes from one row to the next, even.
+
+} SoMode4PolygonRasterizerRenderTarget;
+
 // --------------------------------------------------------------------------
 // Public functions;
 // --------------------------------------------------------------------------
@@ -50,7 +90,21 @@ void  SoMode4PolygonRasterizerInitialize(			void );
 
 void  SoMode4PolygonRasterizerSetBuffer(			void* a_Buffer );
 
+void  SoMode4PolygonRasterizerSetRenderTarget(		const SoMode4PolygonRasterizerRenderTarget* a_Target );
+void  SoMode4PolygonRasterizerGetRenderTarget(		SoMode4PolygonRasterizerRenderTarget* a_Target );
+
 void  SoMode4PolygonRasterizerSetTexture(			SoImage* a_Texture );
+void  SoMode4PolygonRasterizerSetTextureLevel(		u32 a_Level );
+u32	  SoMode4PolygonRasterizerCalculateTextureLevel(	const SoImage* a_Texture, 
+													u32			   a_NumVertices, 
+													SoVector2*	   a_ScreenCoordinates,
+													SoVector2*	   a_TextureCoordinates );
+
+void  SoMode4PolygonRasterizerSetTextureMode(		u32 a_Mode, u32 a_Fade );
+u32	  SoMode4PolygonRasterizerGetTextureMode(		void );
+
+void  SoMode4PolygonRasterizerSetSpanBufferEnable(	bool a_Enable );
+bool  SoMode4PolygonRasterizerGetSpanBufferEnable(	void );
 
 void SoMode4PolygonRasterizerDrawTexturedPolygon(	u32		   a_NumVertices, 
 													SoVector2* a_ScreenCoordinates, 
@@ -60,6 +114,34 @@ void SoMode4PolygonRasterizerDrawSolidPolygon(		u32 a_NumVertices, SoVector2* a_
 													u32 a_PaletteIndex );
 void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32 a_PaletteIndex );
 
+// --------------------------------------------------------------------------
+// Public functions compiled as ARM code and living in IWRAM;
+// --------------------------------------------------------------------------
+
+void SoMode4PolygonRasterizerDrawTexturedTriangle( SoVector2 a_Triangle[ 3 ], 
+												   SoVector2 a_TextureCoordinates[ 3 ] ) SO_IWRAM_CODE;
+
+void SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle( SoVector2	 a_Triangle[ 3 ], 
+															  SoVector2	 a_TextureCoordinates[ 3 ],
+															  sofixedpoint a_Depths[ 3 ],
+															  u32		 a_SpanLength ) SO_IWRAM_CODE;
+
+void SoMode4PolygonRasterizerDrawTexturedTriangles( SoVector2* a_Vertices, 
+													u16*	   a_Indices,
+													u32		   a_NumTriangles,
+													SoVector2* a_TextureCoordinates ) SO_IWRAM_CODE;
+
+void SoMode4PolygonRasterizerDrawLine( s32 a_X0, s32 a_Y0, s32 a_X1, s32 a_Y1, u32 a_PaletteIndex ) SO_IWRAM_CODE;
+
+void SoMode4PolygonRasterizerDrawPolyline( u32		  a_NumVertices, 
+										   SoVector2* a_Vertices,
+										   bool		  a_Closed,
+										   u32		  a_PaletteIndex ) SO_IWRAM_CODE;
+
+void SoMode4PolygonRasterizerClearSpanBuffer( void ) SO_IWRAM_CODE;
+
+u32  SoMode4PolygonRasterizerSpanBufferInsert( s32 a_Y, s32 a_Left, s32 a_Right, u8* a_Gaps ) SO_IWRAM_CODE;
+
 // --------------------------------------------------------------------------
 // Public functions implemented in assembly. These are only documented here
 // only because doxygen can't handle documentation in .s files.
@@ -77,11 +159,37 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 	This routine draws a filled (flat or solid or whatever you want to call it)
 	triangle in the current \a SoMode4PolygonRasterizer backbuffer. This
 	backbuffer is set by using the \a SoMode4PolygonRasterizerSetBuffer
-	function.
+	function, and can be made smaller with \a SoMode4PolygonRasterizerSetRenderTarget.
+
+	A pixel is drawn when its top left corner lies inside the triangle, or on 
+	its top or left edge. The edges are stepped with subpixel precision and 
+	accurate tangents, so triangles that share an edge never draw a pixel twice 
+	and never leave a gap in between them. All the other triangle and polygon 
+	routines of this module use the same convention.
 */
 void SoMode4PolygonRasterizerDrawSolidTriangle(		SoVector2 a_Triangle[ 3 ], 
 													u32		  a_PaletteIndex );
 
+/*!
+	\brief Draws a list of solid filled 2D triangles.
+	
+	\param a_Vertices			Array of \a SoVector2 screen coordinates, shared by
+							all the triangles. Same constraints as with 
+							\a SoMode4PolygonRasterizerDrawSolidTriangle.
+	\param a_Indices			Three indices into \a a_Vertices per triangle.
+	\param a_NumTriangles		Number of triangles to draw.
+	\param a_PaletteIndices	One color per triangle.
+
+	Draws exactly the same pixels as calling 
+	\a SoMode4PolygonRasterizerDrawSolidTriangle for every triangle, but 
+	saves a function call and the register setup per triangle. Use this 
+	when you have a lot of small triangles that need no clipping.
+*/
+void SoMode4PolygonRasterizerDrawSolidTriangles(	SoVector2* a_Vertices, 
+													u16*	   a_Indices,
+													u32		   a_NumTriangles,
+													u8*		   a_PaletteIndices );
+
 // --------------------------------------------------------------------------
 // Private attributes;
 // Sadly these need to be global cause we need them in the .c and in the .s
@@ -104,6 +212,60 @@ void SoMode4PolygonRasterizerDrawSolidTriangle(		SoVector2 a_Triangle[ 3 ],
 */
 extern u16* g_SoMode4PolygonRasterizerBuffer;
 
+/*!
+	\brief Size of the buffer the polygon routines render to.
+
+	\internal
+
+	Set by \a SoMode4PolygonRasterizerSetRenderTarget. The pitch is in 
+	halfwords (two pixels), so it can be added to a scanline pointer right away.
+*/
+//@{
+extern s32	g_SoMode4PolygonRasterizerBufferWidth;
+extern s32	g_SoMode4PolygonRasterizerBufferHeight;
+extern s32	g_SoMode4PolygonRasterizerBufferPitch;
+//@}
+
+/*!
+	\brief Current texture state of the polygon routines.
+
+	\internal
+
+	Set by \a SoMode4PolygonRasterizerSetTexture and 
+	\a SoMode4PolygonRasterizerSetTextureLevel. 
+
+	\warning These variables are only global because the ARM compiled IWRAM
+			 routines live in a different .C file. 
+*/
+//@{
+extern u8*	g_SoMode4PolygonRasterizerTextureData;
+extern s32	g_SoMode4PolygonRasterizerTextureUShift;
+extern s32	g_SoMode4PolygonRasterizerTextureVShift;
+extern s32	g_SoMode4PolygonRasterizerTextureUMask;
+extern s32	g_SoMode4PolygonRasterizerTextureVMask;
+//@}
+
+/*!
+	\brief Current texture mode and fade level of the textured triangle routines.
+
+	\internal
+
+	Set by \a SoMode4PolygonRasterizerSetTextureMode. 
+*/
+//@{
+extern u32	g_SoMode4PolygonRasterizerTextureMode;
+extern u32	g_SoMode4PolygonRasterizerTextureFade;
+//@}
+
+/*!
+	\brief True if the span buffer is enabled.
+
+	\internal
+
+	Set by \a SoMode4PolygonRasterizerSetSpanBufferEnable.
+*/
+extern bool g_SoMode4PolygonRasterizerSpanBufferEnabled;
+
 
 // --------------------------------------------------------------------------
 // EOF
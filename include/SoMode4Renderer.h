@@ -12,8 +12,8 @@
 */
 // ----------------------------------------------------------------------------
 
-#ifndef SO_RENDERER_H
-#define SO_RENDERER_H
+#ifndef SO_MODE_4_RENDERER_H
+#define SO_MODE_4_RENDERER_H
 
 #ifdef __cplusplus
 	extern "C" {
@@ -39,6 +39,48 @@
 #include "SoSystem.h"
 #include "SoMode4PolygonRasterizer.h"
 #include "SoFont.h"
+#include "SoRLEImage.h"
+
+// --------------------------------------------------------------------------
+// Defines;
+// --------------------------------------------------------------------------
+
+/*!
+	\brief Maximum number of dirty rectangles remembered per buffer.
+
+	When more are added, the ones that grow the least are merged, see 
+	\a SoMode4RendererAddDirtyRectangle.
+*/
+#define SO_MODE4_RENDERER_MAX_NUM_DIRTY_RECTANGLES	8
+
+/*!
+	\brief Flags for \a SoMode4RendererBlit.
+
+	Can be combined.
+*/
+//@{
+#define SO_MODE4_RENDERER_BLIT_TRANSPARENT		SO_BIT_0	//!< Pixels with palette index 0 are skipped.
+#define SO_MODE4_RENDERER_BLIT_FLIP_X			SO_BIT_1	//!< The image is mirrored horizontally.
+//@}
+
+// --------------------------------------------------------------------------
+// Typedefs;
+// --------------------------------------------------------------------------
+
+/*!
+	\brief A rectangle of pixels on the screen.
+
+	The right and bottom edges are exclusive, so a rectangle is 
+	\a m_Right - \a m_Left pixels wide.
+*/
+typedef struct
+{
+	s16 m_Left;		//!< Leftmost pixel column.
+	s16 m_Top;		//!< Topmost pixel row.
+	s16 m_Right;	//!< Pixel column just right of the rectangle.
+	s16 m_Bottom;	//!< Pixel row just below the rectangle.
+
+} SoMode4RendererRectangle;
 
 // --------------------------------------------------------------------------
 // Functions implemented in C (documentation in .C file).
@@ -50,16 +92,31 @@ void SoMode4RendererFlip( void );
 
 void SoMode4RendererClearFrontAndBackBuffer( void );
 
+void SoMode4RendererSetDirtyRectanglesEnable( bool a_Enable );
+void SoMode4RendererAddDirtyRectangle(		  s32 a_Left, s32 a_Top, s32 a_Right, s32 a_Bottom );
+void SoMode4RendererClearDirtyRectangles(	  void );
+bool SoMode4RendererGetClearedRectangle(	  SoMode4RendererRectangle* a_Rectangle );
+
 void* SoMode4RendererGetBuffer( void );
 
 void SoMode4RendererDrawImage(			  const SoImage* a_Image );
 void SoMode4RendererDrawTransparentImage( const SoImage* a_Image );
 void SoMode4RendererDrawCrossFadeImage(	  const SoImage* a_Image0, const SoImage* a_Image1, u32 a_Fade );
 
+void SoMode4RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y, 
+						  const SoMode4RendererRectangle* a_Source, u32 a_Flags );
+
+void SoMode4RendererDrawAffineImage(  const SoImage* a_Image, const SoMode4RendererRectangle* a_Destination, 
+									  const sofixedpoint a_Matrix[ 4 ], u32 a_Flags );
+void SoMode4RendererMakeAffineMatrix( sofixedpoint a_Matrix[ 4 ], u32 a_Angle, sofixedpoint a_Scale );
+
+void SoMode4RendererDrawRLEImage( const SoRLEImage* a_Image, s32 a_X, s32 a_Y );
+
 void SoMode4RendererDrawPixel( u32 a_X, u32 a_Y, u32 a_PalIndex );
 
 void SoMode4RendererDrawNumber( u32 a_LeftX, u32 a_RightX, u32 a_TopY, s32   a_Number, const SoImage* a_Font );
 void SoMode4RendererDrawString( u32 a_LeftX, u32 a_RightX, u32 a_TopY, char* a_String, const SoImage* a_Font );
+void SoMode4RendererDrawText(	u32 a_LeftX, u32 a_RightX, u32 a_TopY, const char* a_String, const SoFont* a_Font );
 
 
 // --------------------------------------------------------------------------
@@ -72,7 +129,8 @@ void SoMode4RendererDrawString( u32 a_LeftX, u32 a_RightX, u32 a_TopY, char* a_S
 	\brief Clears the current mode4 backbuffer to palette index zero.
 
 	Remember, it's always better to just draw on the entire backbuffer, so you
-	won't have to clear it.
+	won't have to clear it. And if only small parts of the screen change every 
+	frame, have a look at \a SoMode4RendererClearDirtyRectangles.
 */
 // --------------------------------------------------------------------------
 void SoMode4RendererClear( void );
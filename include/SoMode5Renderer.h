@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode5Renderer.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode5Renderer
+
+	See the \a SoMode5Renderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_MODE_5_RENDERER_H
+#define SO_MODE_5_RENDERER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoMode5Renderer SoMode5Renderer
+	\brief	  Handles all basic mode 5 rendering.
+
+	Singleton
+
+	Two 160 by 128 buffers of 16 bit colors. The display shows them in the
+	top left corner of the screen, use the background 2 affine registers to 
+	scale them up. Drawing is like with \a SoMode4Renderer, but there are about
+	half the pixels to draw and no pixel pairs to put together. Palettized 
+	images are drawn through the palette of \a SoRendererSetPalette.
+
+	Also available as \a g_SoMode5Renderer, see \a SoRenderer.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+
+#include "SoSystem.h"
+#include "SoImage.h"
+#include "SoMode4Renderer.h"
+
+// --------------------------------------------------------------------------
+// Defines;
+// --------------------------------------------------------------------------
+
+#define SO_MODE5_RENDERER_WIDTH		160		//!< Width of a mode 5 buffer.
+#define SO_MODE5_RENDERER_HEIGHT	128		//!< Height of a mode 5 buffer.
+
+// --------------------------------------------------------------------------
+// Functions implemented in C (documentation in .C file).
+// --------------------------------------------------------------------------
+
+void  SoMode5RendererEnable(	  void );
+void  SoMode5RendererFlip(	  void );
+void  SoMode5RendererClear(	  void );
+void* SoMode5RendererGetBuffer( void );
+
+void  SoMode5RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y,
+						   const SoMode4RendererRectangle* a_Source, u32 a_Flags );
+
+void  SoMode5RendererDrawPixel( u32 a_X, u32 a_Y, u16 a_Color );
+
+// --------------------------------------------------------------------------
+// EOF;
+// --------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -70,6 +70,9 @@ typedef struct
 	u8          m_PaletteIndex;			//!< \internal Palette index of the polygon.
 	SoVector2*  m_TextureCoordinates;	//!< \internal Array of texture coordinates of the polygon.
 
+	SoVector3	 m_Normal;				//!< \internal Unit normal in object space, zero if there is none. See \a SoPolygonCalculatePlane.
+	sofixedpoint m_PlaneDistance;		//!< \internal Dot product of the normal with any vertex of the polygon.
+
 } SoPolygon;
 
 // ----------------------------------------------------------------------------
@@ -83,6 +86,11 @@ u32		   SoPolygonGetPaletteIndex(	   SoPolygon* a_This );
 
 void	   SoPolygonSetPaletteIndex(	   SoPolygon* a_This, u32 a_PaletteIndex );
 
+void	   SoPolygonCalculatePlane(		   SoPolygon* a_This, SoVector3* a_Vertices );
+bool	   SoPolygonHasPlane(			   SoPolygon* a_This );
+SoVector3* SoPolygonGetNormal(			   SoPolygon* a_This );
+bool	   SoPolygonFacesPoint(			   SoPolygon* a_This, SoVector3* a_Point );
+
 // ----------------------------------------------------------------------------
 // EOF
 // ----------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoRLEImage.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoRLEImage
+
+	See the \a SoRLEImage module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_RLE_IMAGE_H
+#define SO_RLE_IMAGE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoRLEImage SoRLEImage
+	\brief	  Run length encoded transparent images
+
+	A palettized image where palette index 0 is transparent, stored as the
+	opaque runs of every scanline. Drawing one with 
+	\a SoMode4RendererDrawRLEImage jumps over the transparent parts without
+	looking at them, so big overlays like cockpit frames only cost their 
+	opaque pixels.
+
+	Use \a SoRLEImageEncode to turn an \a SoImage into one. That's plain C, so you 
+	can do it once at startup into EWRAM, or on the PC and include the resulting
+	bytes as a const array in ROM.
+
+	The encoded data starts with one 32 bit offset per scanline, from the start of
+	the data to the scanline. A scanline is a byte with its number of runs, followed
+	by the runs. Every run is a byte with the number of transparent pixels before it,
+	a byte with its number of pixels, and the pixels themselves. Before the pixels 
+	come 0 to 3 padding bytes, so that the address of a pixel modulo 4 equals its 
+	X coordinate modulo 4. So when the image is drawn at an X that is a multiple 
+	of 4, the runs are copied a word at a time.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoImage.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+//! Maximum width of an image that can be encoded, so skips and run lengths fit in a byte.
+#define SO_RLE_IMAGE_MAX_WIDTH	255
+
+// ----------------------------------------------------------------------------
+// Typedefs
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief	Run length encoded image.
+
+	All its members are private, use the \a SoRLEImage methods to access them.
+*/
+typedef struct
+{
+	u16		m_Width;	//!< \internal Width of the image.
+	u16		m_Height;	//!< \internal Height of the image.
+	u32		m_Size;		//!< \internal Number of bytes of the encoded data.
+	u8*		m_Data;		//!< \internal Encoded data, on a 32 bit boundary.
+
+} SoRLEImage;
+
+// ----------------------------------------------------------------------------
+// Public methods;
+// ----------------------------------------------------------------------------
+
+u32  SoRLEImageGetEncodedSize( const SoImage* a_Image );
+void SoRLEImageEncode(		   SoRLEImage* a_This, const SoImage* a_Image, void* a_Buffer );
+
+//! Returns the width of the image
+#define SoRLEImageGetWidth(a_This)  ((const u16)((a_This)->m_Width))
+
+//! Returns the height of the image
+#define SoRLEImageGetHeight(a_This)  ((const u16)((a_This)->m_Height))
+
+//! Returns the number of bytes of the encoded data
+#define SoRLEImageGetSize(a_This)  ((a_This)->m_Size)
+
+//! Returns the encoded data
+#define SoRLEImageGetData(a_This)  ((a_This)->m_Data)
+
+//! Creates an image from encoded data, for example data encoded on the PC
+#define SoRLEImageInitialize(a_This, a_Width, a_Height, a_Size, a_Data)	\
+		{																\
+			(a_This)->m_Width  = a_Width;								\
+			(a_This)->m_Height = a_Height;								\
+			(a_This)->m_Size   = a_Size;								\
+			(a_This)->m_Data   = (u8*) (a_Data);						\
+		}
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoRenderer.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoRenderer
+
+	See the \a SoRenderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_RENDERER_H
+#define SO_RENDERER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoRenderer SoRenderer
+	\brief	  Common interface of the bitmap mode renderers
+
+	There are three bitmap mode renderers:
+
+	- \a SoMode4Renderer, 240 by 160 pixels, 8 bit palettized, double buffered.
+	- \a SoMode3Renderer, 240 by 160 pixels, 16 bit direct color, single buffered.
+	- \a SoMode5Renderer, 160 by 128 pixels, 16 bit direct color, double buffered.
+
+	Each of them is described by an \a SoRenderer, which holds its size and
+	its enable, flip, clear, buffer and blit functions. Code that doesn't
+	care which mode it draws in, like \a SoCamera (see \a SoCameraSetRenderer),
+	takes one of \a g_SoMode4Renderer, \a g_SoMode3Renderer and
+	\a g_SoMode5Renderer.
+
+	Images, and everything \a SoCamera draws, are palettized. The 16 bit
+	renderers turn palette indices into colors with the palette set by
+	\a SoRendererSetPalette, which is the screen palette unless you set
+	another one. The screen palette isn't used by the display in mode 3 and 5,
+	so you can load the palette of your images in it like in mode 4.
+
+	The 16 bit renderers share the functions at the end of this file.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoImage.h"
+#include "SoMode4Renderer.h"
+
+// ----------------------------------------------------------------------------
+// Typedefs
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief	Describes a bitmap mode renderer.
+
+	Don't make these yourself, use \a g_SoMode4Renderer, \a g_SoMode3Renderer
+	or \a g_SoMode5Renderer.
+*/
+typedef struct
+{
+	void  (*m_Enable)(	  void );	//!< Switches the display to the mode of the renderer.
+	void  (*m_Flip)(	  void );	//!< Shows the backbuffer, does nothing if single buffered.
+	void  (*m_Clear)(	  void );	//!< Clears the backbuffer to palette index zero.
+	void* (*m_GetBuffer)( void );	//!< Returns the buffer to draw in.
+
+	//! Draws (part of) a palettized image, takes the same flags as \a SoMode4RendererBlit.
+	void  (*m_Blit)( const SoImage* a_Image, s32 a_X, s32 a_Y,
+					 const SoMode4RendererRectangle* a_Source, u32 a_Flags );
+
+	u16	  m_Width;			//!< Width of the buffer in pixels.
+	u16	  m_Height;			//!< Height of the buffer in pixels.
+	u16	  m_BitsPerPixel;	//!< 8 or 16.
+
+} SoRenderer;
+
+// ----------------------------------------------------------------------------
+// Renderers
+// ----------------------------------------------------------------------------
+
+extern const SoRenderer g_SoMode3Renderer;	//!< The mode 3 renderer.
+extern const SoRenderer g_SoMode4Renderer;	//!< The mode 4 renderer.
+extern const SoRenderer g_SoMode5Renderer;	//!< The mode 5 renderer.
+
+// ----------------------------------------------------------------------------
+// Public methods;
+// ----------------------------------------------------------------------------
+
+void		SoRendererSetPalette( const u16* a_Palette );
+const u16*	SoRendererGetPalette( void );
+
+// ----------------------------------------------------------------------------
+// Functions shared by the 16 bit renderers;
+// ----------------------------------------------------------------------------
+
+void SoRendererClear16(			 u16* a_Buffer, u32 a_NumPixels );
+void SoRendererBlit16(			 u16* a_Buffer, s32 a_Width, s32 a_Height,
+								 const SoImage* a_Image, s32 a_X, s32 a_Y,
+								 const SoMode4RendererRectangle* a_Source, u32 a_Flags );
+void SoRendererExpandScanline16( u16* a_Destination, const u8* a_Source, u32 a_NumPixels );
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoSceneNode.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoSceneNode
+
+	See the \a SoSceneNode module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_SCENE_NODE_H
+#define SO_SCENE_NODE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoSceneNode SoSceneNode
+	\brief	  Hierarchy of transforms with cached world matrices
+
+	Every node has an \a SoTransform that places it relative to its parent,
+	and optionally a mesh. The world matrix of a node is the world matrix of
+	its parent times the matrix of its own transform, so moving a node moves
+	everything below it. Think of a turret on a tank, or a wheel on a car.
+
+	World matrices are cached. Changing a transform (through
+	\a SoSceneNodeGetTransform) or moving a node to another parent marks the
+	node and everything below it dirty, and a dirty world matrix is only
+	recalculated when it is asked for. So a hierarchy that doesn't move costs
+	no matrix multiplies at all, and a node that moves costs one per node
+	below it, once.
+
+	Nodes own no memory. Declare them wherever you like and link them with
+	\a SoSceneNodeAddChild. Draw a hierarchy with \a SoCameraDrawSceneNode or
+	\a SoCameraSubmitSceneNode. The transform of the meshes themselves isn't
+	used then, the world matrix of the node is.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoMath.h"
+#include "SoMatrix.h"
+#include "SoTransform.h"
+#include "SoMesh.h"
+
+// ----------------------------------------------------------------------------
+// Typedefs
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Node in a hierarchy of transforms.
+
+	Don't touch the attributes, use the \a SoSceneNode methods. A node that is
+	dirty has dirty children too, that's what lets \a SoSceneNodeSetDirty stop
+	early.
+
+	See the \a SoSceneNode module for more information.
+*/
+typedef struct SoSceneNode
+{
+	// Private Attributes;
+	SoTransform			m_Transform;		//!< \internal Transform relative to the parent.
+	SoMatrix			m_WorldMatrix;		//!< \internal Cached object to world matrix.
+	sofixedpoint		m_StretchBound;		//!< \internal Cached stretch bound of the world matrix.
+	bool				m_Dirty;			//!< \internal True if the cached values are out of date.
+
+	SoMesh*				m_Mesh;				//!< \internal Mesh drawn at this node, or \a NULL.
+
+	struct SoSceneNode* m_Parent;			//!< \internal Parent, or \a NULL for a root.
+	struct SoSceneNode* m_FirstChild;		//!< \internal First child, or \a NULL.
+	struct SoSceneNode* m_NextSibling;		//!< \internal Next child of the parent, or \a NULL.
+
+} SoSceneNode;
+
+// ----------------------------------------------------------------------------
+// Public methods
+// ----------------------------------------------------------------------------
+
+void		 SoSceneNodeInitialize(		SoSceneNode* a_This, SoMesh* a_Mesh );
+
+void		 SoSceneNodeAddChild(		SoSceneNode* a_This, SoSceneNode* a_Child );
+void		 SoSceneNodeRemove(			SoSceneNode* a_This );
+
+SoSceneNode* SoSceneNodeGetParent(		SoSceneNode* a_This );
+SoSceneNode* SoSceneNodeGetFirstChild(	SoSceneNode* a_This );
+SoSceneNode* SoSceneNodeGetNextSibling( SoSceneNode* a_This );
+
+void		 SoSceneNodeSetMesh(		SoSceneNode* a_This, SoMesh* a_Mesh );
+SoMesh*		 SoSceneNodeGetMesh(		SoSceneNode* a_This );
+
+SoTransform* SoSceneNodeGetTransform(	SoSceneNode* a_This );
+void		 SoSceneNodeSetDirty(		SoSceneNode* a_This );
+
+SoMatrix*	 SoSceneNodeGetWorldMatrix(	SoSceneNode* a_This );
+sofixedpoint SoSceneNodeGetStretchBound( SoSceneNode* a_This );
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -39,13 +39,21 @@
 
 typedef unsigned char	u8;			//!< Unsigned  8 bit data type.
 typedef unsigned short	u16;		//!< Unsigned 16 bit data type.
-typedef unsigned long	u32;		//!< Unsigned 32 bit data type.
 
 typedef signed char		s8;			//!< Signed  8 bit data type.
 typedef signed short	s16;		//!< Signed 16 bit data type.
-typedef signed long		s32;		//!< Signed 32 bit data type.
-
-typedef signed long     sofixedpoint; //!< 32 bit signed fixed point data type.
+typedef signed long long	s64;		//!< Signed 64 bit data type. Only use it in ARM compiled code.
+
+// Longs are 64 bits on a 64 bit PC, which is where the host tests run (see tools/SoRasterizerTest);
+#ifndef __LP64__
+	typedef unsigned long	u32;			//!< Unsigned 32 bit data type.
+	typedef signed long		s32;			//!< Signed 32 bit data type.
+	typedef signed long     sofixedpoint;	//!< 32 bit signed fixed point data type.
+#else
+	typedef unsigned int	u32;
+	typedef signed int		s32;
+	typedef signed int		sofixedpoint;
+#endif
 
 // Only define this if we are not using C++
 #ifndef __cplusplus
@@ -79,6 +87,36 @@ typedef signed long     sofixedpoint; //!< 32 bit signed fixed point data type.
 // Define some hardware specifics;
 #define SO_GBA_CLOCKCYCLES_PER_SECOND	(16*1024*1024)	//!< The GBA's clockspeed; 16 Mhz 
 
+/*!
+	\brief Puts a function in the fast 32 bit IWRAM.
+
+	Use this on both the declaration and the definition of a function. Since
+	IWRAM is too far away from ROM for a normal branch, the function is called
+	with a long call. Functions in IWRAM should be compiled as ARM code, so put
+	them in a file that is compiled with the GCC_ARM_FLAGS of the makefile. Do
+	not call ROM functions (or use divisions, which call libgcc) from within them.
+*/
+#define SO_IWRAM_CODE					__attribute__ (( section( ".iwram" ), long_call ))
+
+/*!
+	\brief Puts a variable in the big but slower 16 bit EWRAM.
+
+	Global and static variables normally end up in the small IWRAM. Use this for
+	big buffers that don't need the speed. Note that these are initialized from
+	ROM at startup, so they take up space in the ROM image as well. Use 
+	\a SO_EWRAM_BSS for buffers that don't need an initial value.
+*/
+#define SO_EWRAM_DATA					__attribute__ (( section( ".ewram" ) ))
+
+/*!
+	\brief Puts an uninitialized variable in EWRAM.
+
+	Like \a SO_EWRAM_DATA, but the variable goes in the EWRAM bss section, 
+	which the startup code clears instead of copying it from ROM. So it takes 
+	no space in the ROM image. Use this for big buffers that start out zero.
+*/
+#define SO_EWRAM_BSS					__attribute__ (( section( ".sbss" ) ))
+
 
 // ---------------------------------------
 /*!
@@ -0,0 +1,85 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoTextureCache.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoTextureCache
+
+	See the \a SoTextureCache module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_TEXTURE_CACHE_H
+#define SO_TEXTURE_CACHE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+/*!
+	\defgroup SoTextureCache SoTextureCache
+	\brief	  Keeps the textures in use in fast RAM
+
+	Singleton
+
+	Textures normally live in cartridge ROM, which has waitstates on every
+	texel the rasterizer reads. This module copies the textures that are in use
+	into a block of memory you give it, preferably in IWRAM, or else in EWRAM.
+	When the block is full, the texture that was used least recently is thrown
+	out.
+
+	\a SoMode4PolygonRasterizerSetTexture asks the cache for the texture data,
+	so once you've called \a SoTextureCacheInitialize you don't have to do
+	anything else, except calling \a SoTextureCacheNextFrame once per frame.
+	\a SoCameraBeginFrame does that for you, so that's only needed when you 
+	draw right away, with \a SoCameraDrawMesh for example.
+
+	Textures used in the current frame are never thrown out. If a texture doesn't
+	fit without doing that, it is read from ROM instead. This way a frame that
+	uses more textures than fit doesn't copy textures back and forth all the time.
+*/ //! @{
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoImage.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+//! Maximum number of textures that can be in the cache at the same time.
+#define SO_TEXTURE_CACHE_MAX_NUM_ENTRIES	16
+
+// ----------------------------------------------------------------------------
+// Public methods;
+// ----------------------------------------------------------------------------
+
+void SoTextureCacheInitialize( void* a_Memory, u32 a_Size );
+void SoTextureCacheFlush(	   void );
+void SoTextureCacheNextFrame(  void );
+
+u8*  SoTextureCacheGetData(	   const SoImage* a_Texture, u32 a_Level );
+
+u32  SoTextureCacheGetNumHits(		void );
+u32  SoTextureCacheGetNumMisses(	void );
+u32  SoTextureCacheGetNumEvictions( void );
+void SoTextureCacheResetStatistics( void );
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
+
+//! @}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
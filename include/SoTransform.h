@@ -33,7 +33,8 @@
 	rotation and they do not interact with each other.  When constructing a
 	matrix from a transform, we always composite them in the order X rotation,
 	Y rotation, Z rotation, translation, scale.  For this reason, transforms
-	are not ideal for use in hierarchical scene graphs.
+	are not ideal for use in hierarchical scene graphs. Use \a SoSceneNode for
+	those, which keeps a transform per node and combines the matrices.
 
 */ //! @{
 // ----------------------------------------------------------------------------
@@ -94,6 +95,8 @@ void SoTransformToInverseMatrix( SoTransform* a_This, SoMatrix* a_Matrix );
 
 void SoTransformSetScale(		 SoTransform* a_This, sofixedpoint a_ScaleX, sofixedpoint a_ScaleY, sofixedpoint a_ScaleZ );
 
+sofixedpoint SoTransformGetStretchBound( SoTransform* a_This );
+
 // --------------------------------------------------------------------------
 // EOF
 // --------------------------------------------------------------------------
@@ -384,17 +384,23 @@
 #include "SoEffects.h"
 #include "SoFlashMem.h"
 #include "SoFont.h"
+#include "SoFramePacer.h"
 #include "SoIntManager.h"
 #include "SoKeys.h"
 #include "SoMath.h"
 #include "SoMatrix.h"
 #include "SoMemManager.h"
 #include "SoMesh.h"
+#include "SoMode3Renderer.h"
 #include "SoMode4PolygonRasterizer.h"
 #include "SoMode4Renderer.h"
+#include "SoMode5Renderer.h"
 #include "SoMultiPlayer.h"
 #include "SoPalette.h"
 #include "SoPolygon.h"
+#include "SoRenderer.h"
+#include "SoRLEImage.h"
+#include "SoSceneNode.h"
 #include "SoSound.h"
 #include "SoSprite.h"
 #include "SoSpriteManager.h"
@@ -402,6 +408,7 @@
 #include "SoSpriteAnimation.h"
 #include "SoSystem.h"
 #include "SoTables.h"
+#include "SoTextureCache.h"
 #include "SoImage.h"
 #include "SoTileMap.h"
 #include "SoTileSet.h"
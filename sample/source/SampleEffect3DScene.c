@@ -31,6 +31,7 @@ void SoSampleEffect3DScene( void )
 
 	// Variables;
 	u32 i, j;
+	u32 steps;
 	SoMesh cube[ SO_NUM_CUBES ];
 	SoCamera camera;
 
@@ -74,41 +75,55 @@ void SoSampleEffect3DScene( void )
 
 	}
 
+	// Let the frame pacer flip the screen at 30 frames per second;
+	SoFramePacerEnable( &g_SoMode4Renderer, SO_FRAME_PACER_30_HZ );
+
 	// Loop until we press the start key;
 	do 
 	{
 		// Update the keys;
 		SoKeysUpdate();
 
+		// Move everything as many steps as the last frame took;
+		for ( steps = SoFramePacerGetNumSteps(); steps > 0; steps-- )
+		{
+			// Rotate the cubes;
+			for ( i = 0; i < SO_NUM_CUBES; i++ )
+			{
+				SoTransformRotateX( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
+				SoTransformRotateY( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
+				SoTransformRotateZ( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
+			}
+
+			// Control the camera;
+			if ( SoKeysDown( SO_KEY_RIGHT ) ) SoCameraRight( &camera, SO_FIXED_FROM_WHOLE( 8 ) );
+			if ( SoKeysDown( SO_KEY_LEFT  ) ) SoCameraRight( &camera, -SO_FIXED_FROM_WHOLE( 8 ) );
+			if ( SoKeysDown( SO_KEY_UP    ) ) SoCameraUp( &camera, SO_FIXED_FROM_WHOLE( 8 ) );
+			if ( SoKeysDown( SO_KEY_DOWN  ) ) SoCameraUp( &camera, -SO_FIXED_FROM_WHOLE( 8 ) );
+			if ( SoKeysDown( SO_KEY_A     ) ) SoCameraForward( &camera,  SO_FIXED_FROM_WHOLE( 10 ) );
+			if ( SoKeysDown( SO_KEY_B     ) ) SoCameraForward( &camera, -SO_FIXED_FROM_WHOLE( 10 ) );
+		}
+
 		// Clear the screen;
 		SoMode4RendererClear();	
 
-		// Rotate and draw the cubes
+		// The cubes are drawn right away instead of between SoCameraBeginFrame 
+		// and SoCameraEndFrame, so tell the texture cache a new frame starts;
+		SoTextureCacheNextFrame();
+
+		// Draw the cubes
 		for ( i = 0; i < SO_NUM_CUBES; i++ )
 		{
-			SoTransformRotateX( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
-			SoTransformRotateY( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
-			SoTransformRotateZ( SoMeshGetTransform( cube + i), SoMathRand() >> 29 );
-
-			// Draw the cube;
 			SoCameraDrawMesh( &camera, cube + i );
 		}
 		
-		// Control the camera;
-		if ( SoKeysDown( SO_KEY_RIGHT ) ) SoCameraRight( &camera, SO_FIXED_FROM_WHOLE( 8 ) );
-		if ( SoKeysDown( SO_KEY_LEFT  ) ) SoCameraRight( &camera, -SO_FIXED_FROM_WHOLE( 8 ) );
-		if ( SoKeysDown( SO_KEY_UP    ) ) SoCameraUp( &camera, SO_FIXED_FROM_WHOLE( 8 ) );
-		if ( SoKeysDown( SO_KEY_DOWN  ) ) SoCameraUp( &camera, -SO_FIXED_FROM_WHOLE( 8 ) );
-		if ( SoKeysDown( SO_KEY_A     ) ) SoCameraForward( &camera,  SO_FIXED_FROM_WHOLE( 10 ) );
-		if ( SoKeysDown( SO_KEY_B     ) ) SoCameraForward( &camera, -SO_FIXED_FROM_WHOLE( 10 ) );
-		
-		// Wait for a vblank;
-		SoDisplayWaitForVBlankStart();
-
-		// Flip the screen;
-		SoMode4RendererFlip();
+		// Show the frame on the next VBlank;
+		SoFramePacerEndFrame();
 
 	} while ( ! SoKeysPressed( SO_KEY_START ) );
+
+	// Flip by hand again;
+	SoFramePacerDisable();
 }
 // ----------------------------------------------------------------------------
 
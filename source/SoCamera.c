@@ -19,6 +19,9 @@
 #include "SoMode4PolygonRasterizer.h"
 #include "SoMode4Renderer.h"
 #include "SoDebug.h"
+#include "SoTables.h"
+#include "SoDMA.h"
+#include "SoTextureCache.h"
 
 // ----------------------------------------------------------------------------
 // Defines
@@ -33,6 +36,42 @@
 #define SO_CAMERA_FRUSTUM_TOP_PLANE		-5	//!< \internal Constant to uniquely identify the frustum top plane.
 #define SO_CAMERA_FRUSTUM_BOTTOM_PLANE	-6	//!< \internal Constant to uniquely identify the frustum bottom plane.
 
+#define SO_CAMERA_MESH_OUTSIDE			0	//!< \internal The bounding sphere of a mesh is entirely outside the frustum.
+#define SO_CAMERA_MESH_INTERSECTING		1	//!< \internal A mesh might cross the frustum, so its vertices are tested.
+#define SO_CAMERA_MESH_INSIDE			2	//!< \internal The bounding sphere of a mesh is entirely inside the frustum.
+
+#define SO_CAMERA_VERTEX_ON_SCREEN		0	//!< \internal A vertex is projected on the screen.
+#define SO_CAMERA_VERTEX_IN_GUARD_BAND	1	//!< \internal A vertex is projected off the screen, but in the guard band.
+#define SO_CAMERA_VERTEX_OUTSIDE		2	//!< \internal A vertex isn't projected, because it is outside the frustum.
+
+#define SO_CAMERA_ORDERING_TABLE_END	0xFFFF	//!< \internal Marks the end of a bucket in the ordering table.
+
+#define SO_CAMERA_BATCH_MAX_NUM_TRIANGLES	64	//!< \internal Number of triangles handed to the rasterizer at once.
+
+#define SO_CAMERA_BINNING_MAX_NUM_BANDS		32	//!< \internal Number of bits in \a SoCameraOrderedTriangle::m_Bands.
+
+// ----------------------------------------------------------------------------
+// Typedefs
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief	A triangle waiting in the frame ordering table.
+
+	\internal
+*/
+typedef struct
+{
+	SoVector2		m_ScreenSpaceVertices[ 3 ];	//!< \internal Screenspace coordinates of the triangle.
+	SoVector2		m_TextureCoordinates[ 3 ];	//!< \internal Texture coordinates, if the mesh is textured.
+	sofixedpoint	m_Depths[ 3 ];				//!< \internal Camera space Z, if the mesh is textured.
+	SoMesh*			m_Mesh;						//!< \internal Mesh the triangle belongs to.
+	u16				m_Next;						//!< \internal Index of the next triangle in the same bucket.
+	u8				m_PaletteIndex;				//!< \internal Color of the triangle, if it isn't textured.
+	u8				m_TextureLevel;				//!< \internal Mipmap level of the texture, if the mesh is textured.
+	u32				m_Bands;					//!< \internal One bit for every band the triangle covers, see \a SoCameraSetBinning.
+
+} SoCameraOrderedTriangle;
+
 // ----------------------------------------------------------------------------
 // Static variables
 // ----------------------------------------------------------------------------
@@ -53,6 +92,28 @@ static SoVector3	s_CameraSpaceVertexBuffer[ SO_MESH_MAX_NUM_VERTICES ];
 //! transformed from camera space to screen space.
 static SoVector2	s_ScreenSpaceVertexBuffer[ SO_MESH_MAX_NUM_VERTICES ];
 
+//! \internal Nonzero for the vertices of a mesh that are used by a polygon facing 
+//! the camera. Only those are transformed.
+static u8			s_VertexUsed[ SO_MESH_MAX_NUM_VERTICES ];
+
+//! \internal One of the SO_CAMERA_VERTEX_ * constants for every used vertex of a mesh,
+//! see \a SoCameraSafeProject.
+static u8			s_VertexClipCodes[ SO_MESH_MAX_NUM_VERTICES ];
+
+//! \internal True if polygons of the current mesh that stick out of the screen
+//! are clipped in 2D, see \a SoCameraSetGuardBandClippingEnable.
+static bool			s_GuardBandClipping = false;
+
+//! \internal True if the polygons of the current mesh are culled in object space.
+static bool			s_ObjectSpaceCulling = false;
+
+//! \internal One bit for every polygon of the current mesh, set if it faces the camera.
+//! Only valid if \a s_ObjectSpaceCulling is true, see \a SoCameraFacesPolygon.
+static u32			s_PolygonFacing[ SO_MESH_MAX_NUM_POLYGONS / 32 ];
+
+//! \internal Position of the camera in the object space of the current mesh.
+static SoVector3	s_ObjectSpaceEye;
+
 /*!
 
   \brief		Describes the current polygon that is about to be drawn.
@@ -94,13 +155,56 @@ static struct
 	
 } s_CurrentPolygon;
 
+//! \internal Head of the triangle list of every bucket of the frame ordering table.
+//! Bucket 0 is nearest to the camera. Word aligned, because \a SoCameraBeginFrame 
+//! empties it with a 32 bit DMA fill.
+static u16 s_OrderingTable[ SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS ] __attribute__ (( aligned( 4 ) ));
+
+//! \internal All the triangles submitted this frame. This is too big for IWRAM.
+static SoCameraOrderedTriangle s_OrderedTriangles[ SO_CAMERA_ORDERING_TABLE_MAX_NUM_TRIANGLES ] SO_EWRAM_BSS;
+
+static u32			s_NumOrderedTriangles = 0;		//!< \internal Number of triangles submitted this frame.
+static sofixedpoint	s_OrderingTableScale;			//!< \internal Number of buckets per whole depth unit.
+static bool			s_OrderingTableInUse = false;	//!< \internal True in between begin and end frame.
+
+//! \internal Triangle list of an unclipped mesh, indexing the screen space vertex buffer.
+static u16			s_BatchIndices[ SO_CAMERA_BATCH_MAX_NUM_TRIANGLES * 3 ];
+static u8			s_BatchPaletteIndices[ SO_CAMERA_BATCH_MAX_NUM_TRIANGLES ];				//!< \internal Colors of the triangle list.
+static SoVector2	s_BatchTextureCoordinates[ SO_CAMERA_BATCH_MAX_NUM_TRIANGLES * 3 ];		//!< \internal Texture coordinates of the triangle list.
+
+static s32			s_ScreenWidth		 = SO_SCREEN_WIDTH;		//!< \internal Width of the render target we project into.
+static s32			s_ScreenHeight		 = SO_SCREEN_HEIGHT;	//!< \internal Height of the render target we project into.
+static s32			s_ProjectionScaleX	 = 1 << 8;				//!< \internal Render target width over screen width, 8 bits fraction.
+static s32			s_ProjectionScaleY	 = 1 << 8;				//!< \internal Render target height over screen height, 8 bits fraction.
+
 
 // ----------------------------------------------------------------------------
 // Forward declarations of private functions
 // ----------------------------------------------------------------------------
-void SoCameraTransformMesh( SoCamera* a_This, SoMesh* a_Mesh );
+void SoCameraRenderMesh( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToWorldMatrix, 
+						 sofixedpoint a_StretchBound, bool a_Submit );
+void SoCameraRenderSceneNode( SoCamera* a_This, SoSceneNode* a_Node, bool a_Submit );
+bool SoCameraDrawUnclippedMesh( SoCamera* a_This, SoMesh* a_Mesh, bool a_Inside );
+void SoCameraFlushBatch( SoCamera* a_This, SoMesh* a_Mesh, u32 a_NumTriangles );
+
+void SoCameraGetRenderTarget( SoCamera* a_This, SoMode4PolygonRasterizerRenderTarget* a_Target );
+
+void SoCameraBinOrderingTable(  SoCamera* a_This, u32 a_BandHeight, s32 a_Height );
+void SoCameraDrawOrderingTable( SoCamera* a_This, u32 a_Band, s32 a_Top );
 
-void SoCameraSafeProject( SoCamera*  a_This, 
+void SoCameraDrawCurrentPolygon(   SoCamera* a_This, SoMesh* a_Mesh, u32 a_PaletteIndex );
+void SoCameraSubmitCurrentPolygon( SoCamera* a_This, SoMesh* a_Mesh, u32 a_PaletteIndex );
+
+SoMatrix* SoCameraGetWorldToCameraMatrix( SoCamera* a_This );
+
+u32  SoCameraTransformMesh( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToWorldMatrix, sofixedpoint a_StretchBound );
+u32  SoCameraClassifyBoundingSphere( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToCameraMatrix, 
+									 sofixedpoint a_StretchBound );
+void SoCameraMarkUsedVertices( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToCameraMatrix, 
+							   sofixedpoint a_StretchBound );
+bool SoCameraFacesPolygon( u32 a_Index );
+
+u32	 SoCameraSafeProject( SoCamera*  a_This, 
 						  SoVector3* a_CameraSpaceCoordinate, 
 						  SoVector2* a_ScreenSpaceCoordinate );
 
@@ -108,15 +212,26 @@ void SoCameraProject( SoCamera*  a_This,
 					  SoVector3* a_CameraSpaceCoordinate, 
 					  SoVector2* a_ScreenSpaceCoordinate );
 
+void SoCameraGuardBandProject( SoCamera*  a_This, 
+							   SoVector3* a_CameraSpaceCoordinate, 
+							   SoVector2* a_ScreenSpaceCoordinate );
+
 void SoCameraClipPolygon( SoCamera*	a_This, SoPolygon* a_Polygon );
 
 void SoCameraClipTexturedPolygonAgainstFrustumPlane( SoCamera* a_This, s32 a_WhichFrustumPlane );
 void SoCameraClipSolidPolygonAgainstFrustumPlane(	 SoCamera* a_This, s32 a_WhichFrustumPlane );
+void SoCameraClipPolygonAgainstScreenEdge(			 s32 a_WhichScreenEdge );
+void SoCameraAddScreenEdgeIntersection(				 u32 a_Inside, sofixedpoint a_InsideDistance,
+													 u32 a_Outside, sofixedpoint a_OutsideDistance, 
+													 s32 a_WhichScreenEdge );
 
 void SoCameraProjectUnProjectedVertices( SoCamera* a_This );
 
 sofixedpoint SoCameraDistanceToFrustumPlane( SoCamera* a_This, SoVector3* a_CameraSpaceVertex, 
 									 s32 a_WhichFrustumPlane );
+sofixedpoint SoCameraDistanceToScreenEdge( SoVector2* a_ScreenSpaceVertex, s32 a_WhichScreenEdge );
+
+void SoCameraCalculateFrustum( SoCamera* a_This );
 
 bool SoCameraClockwise( SoVector2* a_AtLeastThreeVertices );
 
@@ -130,40 +245,40 @@ bool SoCameraClockwise( SoVector2* a_AtLeastThreeVertices );
 	
  	\param	a_This This Pointer
 
-	\todo	Fix hardcoded projection plane distance. Make this adjustable.
-
 	Initializes the given camera. It resets its transform. It enables near- and 
-	far-plane clipping. Enables frustum side-plane clipping. Initializes some internal 
-	structures.
+	far-plane clipping. Enables frustum side-plane clipping. Disables guard band 
+	clipping. Sets the field of view to \a SO_CAMERA_DEFAULT_FIELD_OF_VIEW. Initializes 
+	some internal structures.
 */
 // ----------------------------------------------------------------------------
 void SoCameraInitialize( SoCamera* a_This )
 {
 	// Set the members;
 	a_This->m_NearPlaneDistance		  = 10;
-	a_This->m_ProjectionPlaneDistance = 200;
 	a_This->m_FarPlaneDistance		  = 1400;
 
 	// Reset the transform;
 	SoTransformMakeIdentity( &(a_This->m_Transform) );
+	a_This->m_WorldToCameraMatrixDirty = true;
 
 	// Set the clip flags;
 	a_This->m_ClipAgainstFarAndNearPlane = true;
 	a_This->m_ClipAgainstFrustumSidePlanes = true;
+	a_This->m_GuardBandClipping = false;
 
-	// Calculate the frustumplane normals, leaving a 2-pixel
-	// boundary around the screen to avoid accuracy problems;
+	// Draw filled polygons;
+	a_This->m_Wireframe = false;
 
-	//! \todo Fix hardcoded values for a projection plane distance of 200;
-	// For now, we assert that the value still is at 200.
-	SO_ASSERT( a_This->m_ProjectionPlaneDistance == 200, "Hardcoded constant no longer at correct value" );
-	a_This->m_LeftFrustumPlaneNormal.m_X = SO_FIXED_FROM_FLOAT( 0.861269258); // = 56444;
-	a_This->m_LeftFrustumPlaneNormal.m_Y = SO_FIXED_FROM_FLOAT( 0.000000000); // = 0;
-	a_This->m_LeftFrustumPlaneNormal.m_Z = SO_FIXED_FROM_FLOAT( 0.508148862); // = 33302;
-	a_This->m_TopFrustumPlaneNormal.m_X  = SO_FIXED_FROM_FLOAT( 0.000000000); // = 0;
-	a_This->m_TopFrustumPlaneNormal.m_Y  = SO_FIXED_FROM_FLOAT(-0.931654555); // = -61057;
-	a_This->m_TopFrustumPlaneNormal.m_Z  = SO_FIXED_FROM_FLOAT( 0.363345276); // = 23812;
+	// Draw the frame ordering table straight into the render target;
+	a_This->m_BinBuffer			   = NULL;
+	a_This->m_BinBufferSize		   = 0;
+	a_This->m_BinClearPaletteIndex = 0;
 
+	// Draw into the render target of the rasterizer;
+	a_This->m_Renderer = NULL;
+
+	// Set the projection plane distances and the frustum plane normals;
+	SoCameraSetFieldOfView( a_This, SO_CAMERA_DEFAULT_FIELD_OF_VIEW, SO_CAMERA_DEFAULT_ASPECT_RATIO );
 		
 	// Set the polygon array pointers;
 	s_CurrentPolygon.m_ScreenSpaceVertices			= s_CurrentPolygon.m_ScreenSpaceArray0;
@@ -186,6 +301,7 @@ void SoCameraInitialize( SoCamera* a_This )
 void SoCameraSetPitch( SoCamera* a_This, s32 a_Angle ) 
 { 
 	SoTransformSetRotateY( &a_This->m_Transform, a_Angle ); 
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // ----------------------------------------------------------------------------
 
@@ -200,6 +316,7 @@ void SoCameraSetPitch( SoCamera* a_This, s32 a_Angle )
 void SoCameraSetYaw( SoCamera* a_This, s32 a_Angle ) 
 { 
 	SoTransformSetRotateX( &a_This->m_Transform, a_Angle ); 
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // ----------------------------------------------------------------------------
 
@@ -214,6 +331,7 @@ void SoCameraSetYaw( SoCamera* a_This, s32 a_Angle )
 void SoCameraSetRoll( SoCamera* a_This, s32 a_Angle ) 
 { 
 	SoTransformSetRotateZ( &a_This->m_Transform, a_Angle ); 
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // ----------------------------------------------------------------------------
 
@@ -230,9 +348,94 @@ void SoCameraSetRoll( SoCamera* a_This, s32 a_Angle )
 void SoCameraSetTranslation( SoCamera* a_This, sofixedpoint a_X, sofixedpoint a_Y, sofixedpoint a_Z ) 
 { 
 	SoTransformSetTranslation( &a_This->m_Transform, a_X, a_Y, a_Z ); 
+	a_This->m_WorldToCameraMatrixDirty = true;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Sets the field of view of the camera.
+
+	\param	a_This			This pointer
+	\param	a_Angle			Horizontal field of view. A full circle is 256 degrees, so
+							this is in between 0 and 128 (180 real degrees).
+	\param	a_AspectRatio	Fixed point width over height of the image. Use 
+							\a SO_CAMERA_DEFAULT_ASPECT_RATIO for the shape of the screen,
+							other values stretch the image vertically.
+
+	Calculates the distance of the projection plane, and the normals of the frustum
+	side planes from that. Leaves a 2 pixel boundary around the screen, to avoid 
+	accuracy problems.
+
+	The projection plane has to stay in between 16 and 1024 pixels from the eye
+	horizontally and vertically, so very wide or narrow angles are asserted. The
+	default is \a SO_CAMERA_DEFAULT_FIELD_OF_VIEW, which puts it at 200 pixels.
+*/
+// ----------------------------------------------------------------------------
+void SoCameraSetFieldOfView( SoCamera* a_This, u32 a_Angle, sofixedpoint a_AspectRatio )
+{
+	// The tangent of half the angle is the sine over one plus the cosine, 
+	// so there's no need to halve the angle;
+	sofixedpoint sine		 = SO_SINE( a_Angle );
+	sofixedpoint onePlusCos  = SO_FIXED_FROM_WHOLE( 1 ) + SO_COSINE( a_Angle );
+
+	SO_ASSERT( a_Angle > 0 && a_Angle < 128, "Field of view must lie in between 0 and 180 degrees." );
+	SO_ASSERT( a_AspectRatio > 0, "Aspect ratio must be positive." );
+
+	// Half the screen over the tangent, rounded to whole pixels;
+	a_This->m_ProjectionPlaneDistanceX = SoMathDivide( SO_SCREEN_HALF_WIDTH * onePlusCos + (sine >> 1), sine );
+	a_This->m_ProjectionPlaneDistanceY = SoMathDivide( SO_SCREEN_HALF_HEIGHT * SoMathFixedMultiply( onePlusCos, a_AspectRatio ) + 
+													   (sine >> 1), sine );
+
+	// Further away would overflow the projection, closer would overflow the guard band tests;
+	SO_ASSERT( a_This->m_ProjectionPlaneDistanceX >= 16 && a_This->m_ProjectionPlaneDistanceX <= 1024 &&
+			   a_This->m_ProjectionPlaneDistanceY >= 16 && a_This->m_ProjectionPlaneDistanceY <= 1024,
+			   "Field of view or aspect ratio out of range." );
+
+	SoCameraCalculateFrustum( a_This );
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Calculates the frustum side plane normals and the guard band.
+
+	\internal Only called from within \a SoCameraSetFieldOfView
+
+	\param	a_This	This pointer
+
+	The left plane goes through the eye and the screen edge 2 pixels in from the left,
+	on the projection plane. So its normal is (distance, 0, edge), normalized. The
+	right plane is the mirror image, the top and bottom planes are done the same way.
+*/
+// ----------------------------------------------------------------------------
+void SoCameraCalculateFrustum( SoCamera* a_This )
+{
+	s32 distanceX = a_This->m_ProjectionPlaneDistanceX;
+	s32 distanceY = a_This->m_ProjectionPlaneDistanceY;
+	s32 edgeX	  = SO_SCREEN_HALF_WIDTH  - 2;
+	s32 edgeY	  = SO_SCREEN_HALF_HEIGHT - 2;
+
+	// Length of the unnormalized normal, with 4 bits fraction;
+	s32 length;
+
+	length = SoMathFixedSqrt( (distanceX * distanceX + edgeX * edgeX) << 8 ) >> 8;
+
+	a_This->m_LeftFrustumPlaneNormal.m_X = SoMathDivide( distanceX << 20, length );
+	a_This->m_LeftFrustumPlaneNormal.m_Y = 0;
+	a_This->m_LeftFrustumPlaneNormal.m_Z = SoMathDivide( edgeX	   << 20, length );
+
+	length = SoMathFixedSqrt( (distanceY * distanceY + edgeY * edgeY) << 8 ) >> 8;
+
+	a_This->m_TopFrustumPlaneNormal.m_X = 0;
+	a_This->m_TopFrustumPlaneNormal.m_Y = -SoMathDivide( distanceY << 20, length );
+	a_This->m_TopFrustumPlaneNormal.m_Z =  SoMathDivide( edgeY	   << 20, length );
+
+	// The edges of the guard band, as X or Y over Z in camera space;
+	a_This->m_GuardBandSlopeX = SoMathDivide( SO_FIXED_FROM_WHOLE( SO_SCREEN_HALF_WIDTH  + SO_CAMERA_GUARD_BAND_SIZE ), distanceX );
+	a_This->m_GuardBandSlopeY = SoMathDivide( SO_FIXED_FROM_WHOLE( SO_SCREEN_HALF_HEIGHT + SO_CAMERA_GUARD_BAND_SIZE ), distanceY );
+}
+// ----------------------------------------------------------------------------
 
 // ----------------------------------------------------------------------------
 /*!
@@ -270,6 +473,135 @@ void SoCameraSetFrustumSidePlanesClippingEnable(  SoCamera* a_This,	bool a_Enabl
 }
 // --------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Enables or disables clipping against the screen edges in 2D.
+
+  	\param	a_This		This pointer
+	\param	a_Enable	\a true to enable, \a false to disable
+
+	Most polygons that need clipping only stick out of the side of the screen. 
+	Clipping them against the frustum side planes in 3D takes two multiplies per 
+	vertex per plane, and a projection for every new vertex. With guard band clipping
+	enabled, vertices up to \a SO_CAMERA_GUARD_BAND_SIZE pixels off the screen are 
+	projected like any other. Polygons that only have vertices on the screen and in 
+	this band are clipped against the edges of the render target in screen space, 
+	which only takes subtractions, and one divide per new vertex. Polygons that cross
+	the near or far plane, or stick out of the guard band, are still clipped in 3D. 
+
+	Meshes with perspective correct textures (see \a SoMeshSetPerspectiveSpanLength) 
+	are always clipped in 3D, because their new vertices need a real depth.
+
+	Only has an effect if frustum side plane clipping is enabled. By default guard 
+	band clipping is disabled.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSetGuardBandClippingEnable( SoCamera* a_This, bool a_Enable )
+{
+	a_This->m_GuardBandClipping = a_Enable;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Enables or disables drawing only the outlines of polygons.
+
+  	\param	a_This		This pointer
+	\param	a_Enable	\a true to enable, \a false to disable
+
+	In wireframe mode every visible polygon is drawn as a closed 
+	\a SoMode4PolygonRasterizerDrawPolyline in its own palette index, also when the
+	mesh has a texture. Backfacing polygons are still culled, so you only see the 
+	front of a mesh. Lines don't need sorting, so \a SoCameraSubmitMesh draws 
+	wireframe meshes right away instead of at \a SoCameraEndFrame.
+
+	By default wireframe mode is disabled.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSetWireframeEnable( SoCamera* a_This, bool a_Enable )
+{
+	a_This->m_Wireframe = a_Enable;
+}
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Makes \a SoCameraEndFrame render in horizontal bands through a scratch buffer.
+
+  	\param	a_This				This pointer
+	\param	a_Buffer			Scratch buffer on a 32 bit boundary, preferably in IWRAM.
+								Pass \a NULL to draw straight into the render target again.
+	\param	a_Size				Size of the scratch buffer in bytes.
+	\param	a_ClearPaletteIndex	Color of the pixels no triangle covers.
+
+	Every pixel the rasterizer writes to VRAM costs a waitstate, and the odd pixels
+	at the ends of the scanlines are read back first. IWRAM has no waitstates at all.
+	With binning enabled, \a SoCameraEndFrame cuts the render target into bands as
+	high as fit in the scratch buffer, and sorts the triangles into the bands they
+	cover. Then, band after band, it clears the scratch buffer, draws the triangles 
+	of the band into it, and copies the finished band to the render target with a 32 
+	bit DMA transfer. This way the drawing only touches fast memory, and VRAM is
+	written exactly once per pixel, a word at a time.
+
+	The bands span the whole width of the render target, so triangles only need to 
+	be clipped against their top and bottom. The solid and textured triangle routines 
+	written in C do that, so they are used instead of the assembly versions.
+
+	There can be at most 32 bands, so the buffer needs to be at least 
+	1/32 of the render target, with its width rounded up to a multiple of 4. Using 
+	240 by 16 pixels (3840 bytes) gives 10 bands on a full mode 4 screen.
+
+	Because every pixel of the render target is written, you don't need to clear the 
+	backbuffer when binning is enabled. Anything drawn before \a SoCameraEndFrame is 
+	overwritten though, so draw things like a HUD afterwards. \a SoCameraDrawMesh 
+	doesn't use the scratch buffer.
+
+	By default binning is disabled.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSetBinning( SoCamera* a_This, void* a_Buffer, u32 a_Size, u32 a_ClearPaletteIndex )
+{
+	SO_ASSERT( ((u32) a_Buffer & 3) == 0, "Binning buffer should be on a 32 bit boundary." );
+	SO_ASSERT( a_ClearPaletteIndex < 256, "Invalid palette index." );
+
+	a_This->m_BinBuffer			   = a_Buffer;
+	a_This->m_BinBufferSize		   = a_Size;
+	a_This->m_BinClearPaletteIndex = a_ClearPaletteIndex;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Makes the camera draw into one of the bitmap mode renderers.
+
+  	\param	a_This		This pointer
+	\param	a_Renderer	\a g_SoMode3Renderer, \a g_SoMode4Renderer or \a g_SoMode5Renderer.
+						Pass \a NULL to draw into the render target of the
+						\a SoMode4PolygonRasterizer again.
+
+	The rasterizer only draws 8 bit pixels, so 16 bit renderers are drawn to
+	through binning (see \a SoCameraSetBinning), which has to be enabled for them. 
+	Every band is drawn into the scratch buffer like always, and its palette 
+	indices are turned into colors (see \a SoRendererSetPalette) when it is 
+	copied into the backbuffer of the renderer. So only \a SoCameraBeginFrame, 
+	\a SoCameraSubmitMesh and \a SoCameraEndFrame can be used with them, not 
+	\a SoCameraDrawMesh.
+
+	Screenspace is the whole buffer of the renderer. The mode 5 buffer is smaller, 
+	so it takes less time to rasterize and copy a frame in mode 5, at a lower 
+	resolution.
+
+	The mode 4 renderer draws into the rasterizer render target, which it sets 
+	itself, so it's the same as passing \a NULL.
+
+	By default the render target of the rasterizer is used.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSetRenderer( SoCamera* a_This, const SoRenderer* a_Renderer )
+{
+	a_This->m_Renderer = a_Renderer;
+}
+// --------------------------------------------------------------------------------------
+
 
 // --------------------------------------------------------------------------------------
 /*! 
@@ -285,6 +617,7 @@ void SoCameraSetFrustumSidePlanesClippingEnable(  SoCamera* a_This,	bool a_Enabl
 void SoCameraPitch( SoCamera* a_This, s32 a_Angle )
 {
 	SoTransformRotateY( &a_This->m_Transform, a_Angle );
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // --------------------------------------------------------------------------------------
 
@@ -302,6 +635,7 @@ void SoCameraPitch( SoCamera* a_This, s32 a_Angle )
 void SoCameraYaw( SoCamera* a_This,	s32 a_Angle	)
 {
 	SoTransformRotateX( &a_This->m_Transform, a_Angle );
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // --------------------------------------------------------------------------------------
 
@@ -319,6 +653,7 @@ void SoCameraYaw( SoCamera* a_This,	s32 a_Angle	)
 void SoCameraRoll( SoCamera* a_This, s32 a_Angle )
 {
 	SoTransformRotateZ( &a_This->m_Transform, a_Angle );
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // --------------------------------------------------------------------------------------
 
@@ -335,6 +670,7 @@ void SoCameraRoll( SoCamera* a_This, s32 a_Angle )
 void SoCameraForward( SoCamera* a_This,  sofixedpoint a_Amount )
 {
 	SoTransformTranslate( &a_This->m_Transform, 0, 0, a_Amount );
+	a_This->m_WorldToCameraMatrixDirty = true;
 }
 // --------------------------------------------------------------------------------------
 
@@ -345,106 +681,1214 @@ void SoCameraForward( SoCamera* a_This,  sofixedpoint a_Amount )
 	\param	a_This		This pointer
 	\param	a_Amount	Fixed point amount to move right with
 
-	If you need movement to the left just give a negative amount.
-*/
-// --------------------------------------------------------------------------------------
-void SoCameraRight( SoCamera* a_This,  sofixedpoint a_Amount )
-{
-	SoTransformTranslate( &a_This->m_Transform, a_Amount, 0, 0 );
+	If you need movement to the left just give a negative amount.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraRight( SoCamera* a_This,  sofixedpoint a_Amount )
+{
+	SoTransformTranslate( &a_This->m_Transform, a_Amount, 0, 0 );
+	a_This->m_WorldToCameraMatrixDirty = true;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Moves the camera up by the given fixed point amount.
+
+	\param	a_This		This pointer
+    \param	a_Amount	Fixed point amount to move up with
+
+	If you need downwards movement just give a negative amount.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraUp( SoCamera* a_This,  sofixedpoint a_Amount )
+{
+	SoTransformTranslate( &a_This->m_Transform, 0, a_Amount, 0 );
+	a_This->m_WorldToCameraMatrixDirty = true;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws the given mesh into the current buffer
+
+	\param	a_This		This pointer
+	\param	a_Mesh		Mesh that should be drawn
+
+	\todo	Make this method independent from the SoMode4Rasterizer
+
+	This function transforms the given mesh from object space to camera space, performs
+	clipping if neccesary and requested, then transforms it to screenspace, and then
+	draws it using the correct functions (texture, non-textured, etc.). Textured 
+	polygons are split into triangles and drawn with 
+	\a SoMode4PolygonRasterizerDrawTexturedTriangle, or with
+	\a SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle if perspective correction
+	is turned on for the mesh (see \a SoMeshSetPerspectiveSpanLength). Meshes that
+	are entirely inside the frustum skip the clipper and are drawn as indexed
+	triangle lists. If the mesh has a bounding sphere (see 
+	\a SoMeshCalculateBoundingSphere), that is tested first: meshes outside the
+	frustum aren't transformed at all, and the vertices of meshes inside it are
+	projected without frustum checks.
+
+	Polygons are drawn right away, so overlapping meshes should be drawn back to front.
+	Use \a SoCameraBeginFrame, \a SoCameraSubmitMesh and \a SoCameraEndFrame to have 
+	this done for you.
+
+	If the span buffer of the \a SoMode4PolygonRasterizer is enabled (see 
+	\a SoMode4PolygonRasterizerSetSpanBufferEnable), pixels that are already drawn
+	are skipped, so meshes should be drawn front to back instead. 
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraDrawMesh( SoCamera* a_This, SoMesh* a_Mesh )
+{
+	SoMatrix objectToWorldMatrix;
+
+	SO_ASSERT( a_This->m_Renderer == NULL || a_This->m_Renderer->m_BitsPerPixel == 8,
+			   "16 bit renderers can only be drawn to with SoCameraEndFrame." );
+
+	SoTransformToMatrix( SoMeshGetTransform( a_Mesh ), &objectToWorldMatrix );
+
+	SoCameraRenderMesh( a_This, a_Mesh, &objectToWorldMatrix, 
+						SoTransformGetStretchBound( SoMeshGetTransform( a_Mesh ) ), false );
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws the meshes of a scene node and everything below it.
+
+	\param	a_This		This pointer
+	\param	a_Node		Node that should be drawn, usually the root of a hierarchy
+
+	Every mesh is drawn like \a SoCameraDrawMesh does, but placed with the world 
+	matrix of its node (see \a SoSceneNodeGetWorldMatrix) instead of its own transform.
+	World matrices that didn't change since the last frame aren't recalculated.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraDrawSceneNode( SoCamera* a_This, SoSceneNode* a_Node )
+{
+	SO_ASSERT( a_This->m_Renderer == NULL || a_This->m_Renderer->m_BitsPerPixel == 8,
+			   "16 bit renderers can only be drawn to with SoCameraEndFrame." );
+
+	SoCameraRenderSceneNode( a_This, a_Node, false );
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Starts a frame in which meshes are drawn in back to front order.
+
+	\param	a_This		This pointer
+
+	Meshes given to \a SoCameraSubmitMesh after this call are transformed and clipped
+	right away, but their polygons are only drawn when \a SoCameraEndFrame is called.
+	This way polygons of different meshes are drawn back to front, no matter in what
+	order the meshes were submitted.
+
+	Only one frame can be in progress at the same time, even if you use multiple cameras.
+
+	Also tells the texture cache a new frame starts, see \a SoTextureCacheNextFrame.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraBeginFrame( SoCamera* a_This )
+{
+	SO_ASSERT( ! s_OrderingTableInUse, "SoCameraEndFrame was not called for the previous frame." );
+
+	// Empty every bucket;
+	SO_DMA_MEMSET( s_OrderingTable, SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS >> 1, 
+				   (SO_CAMERA_ORDERING_TABLE_END << 16) | SO_CAMERA_ORDERING_TABLE_END );
+
+	s_NumOrderedTriangles = 0;
+	s_OrderingTableInUse  = true;
+
+	// Textures of the previous frame may be thrown out again;
+	SoTextureCacheNextFrame();
+
+	// Calculate the factor to go from a whole depth in the near to far range
+	// to a bucket. This way we need only one divide per frame;
+	s_OrderingTableScale = SoMathDivide( SO_FIXED_FROM_WHOLE( SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS ),
+										 a_This->m_FarPlaneDistance - a_This->m_NearPlaneDistance );
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Submits a mesh to be drawn at the end of the frame.
+
+	\param	a_This		This pointer
+	\param	a_Mesh		Mesh that should be drawn
+
+	Transforms and clips the mesh just like \a SoCameraDrawMesh, but puts the resulting
+	triangles in the frame ordering table instead of drawing them. They are drawn by
+	\a SoCameraEndFrame. 
+	
+	Sorting is done with buckets, so it takes the same time for every polygon, no 
+	matter how many polygons there are. Polygons are sorted on their average camera
+	space Z, so like every painter's algorithm this goes wrong for intersecting or 
+	cyclically overlapping polygons.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSubmitMesh( SoCamera* a_This, SoMesh* a_Mesh )
+{
+	SoMatrix objectToWorldMatrix;
+
+	SO_ASSERT( s_OrderingTableInUse, "Call SoCameraBeginFrame before submitting meshes." );
+
+	SoTransformToMatrix( SoMeshGetTransform( a_Mesh ), &objectToWorldMatrix );
+
+	SoCameraRenderMesh( a_This, a_Mesh, &objectToWorldMatrix, 
+						SoTransformGetStretchBound( SoMeshGetTransform( a_Mesh ) ), true );
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Submits the meshes of a scene node and everything below it.
+
+	\param	a_This		This pointer
+	\param	a_Node		Node that should be drawn, usually the root of a hierarchy
+
+	Like \a SoCameraSubmitMesh, but every mesh is placed with the world matrix of its
+	node, see \a SoCameraDrawSceneNode.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSubmitSceneNode( SoCamera* a_This, SoSceneNode* a_Node )
+{
+	SO_ASSERT( s_OrderingTableInUse, "Call SoCameraBeginFrame before submitting meshes." );
+
+	SoCameraRenderSceneNode( a_This, a_Node, true );
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws all the polygons submitted since \a SoCameraBeginFrame.
+
+	\param	a_This		This pointer
+
+	Walks the ordering table from the far plane to the near plane and draws every 
+	triangle in it. If the span buffer of the \a SoMode4PolygonRasterizer is enabled
+	the table is walked from the near plane to the far plane instead, so that every
+	pixel is drawn only once.
+
+	If binning is enabled, this is done once for every band of the render target,
+	see \a SoCameraSetBinning.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraEndFrame( SoCamera* a_This )
+{
+	// Render target, and the part of the scratch buffer we draw a band in;
+	SoMode4PolygonRasterizerRenderTarget target;
+	SoMode4PolygonRasterizerRenderTarget scratch;
+	SoMode4PolygonRasterizerRenderTarget previousTarget;
+
+	// Current band;
+	u32 band;
+	u32 bandHeight;
+	s32 top;
+	u8* destination;
+
+	SO_ASSERT( s_OrderingTableInUse, "SoCameraBeginFrame was not called." );
+
+	// Draw straight into the render target;
+	if ( a_This->m_BinBuffer == NULL )
+	{
+		SO_ASSERT( a_This->m_Renderer == NULL || a_This->m_Renderer->m_BitsPerPixel == 8,
+				   "16 bit renderers need binning." );
+
+		SoCameraDrawOrderingTable( a_This, SO_CAMERA_BINNING_MAX_NUM_BANDS, 0 );
+
+		s_OrderingTableInUse = false;
+		return;
+	}
+
+	SoCameraGetRenderTarget( a_This, &target );
+	SoMode4PolygonRasterizerGetRenderTarget( &previousTarget );
+
+	// Rows of the scratch buffer are word aligned, so they can be cleared and copied 
+	// with 32 bit transfers;
+	scratch.m_Buffer = a_This->m_BinBuffer;
+	scratch.m_Width	 = target.m_Width;
+	scratch.m_Pitch	 = (target.m_Width + 3) & ~3;
+
+	// Make the bands as high as fit in the scratch buffer;
+	bandHeight = SoMathDivide( a_This->m_BinBufferSize, scratch.m_Pitch );
+	if ( bandHeight > target.m_Height ) bandHeight = target.m_Height;
+
+	SO_ASSERT( bandHeight * SO_CAMERA_BINNING_MAX_NUM_BANDS >= target.m_Height, 
+			   "Binning buffer is too small for the render target." );
+	SO_ASSERT( (target.m_Width & 1) == 0, "Binning needs a render target with an even width." );
+
+	// Sort the triangles into the bands;
+	SoCameraBinOrderingTable( a_This, bandHeight, target.m_Height );
+
+	for ( band = 0, top = 0; top < (s32) target.m_Height; band++, top += bandHeight )
+	{
+		// The last band can be lower;
+		scratch.m_Height = SO_MIN( bandHeight, target.m_Height - top );
+
+		// Render into the scratch buffer. This clears the span buffer too;
+		SoMode4PolygonRasterizerSetRenderTarget( &scratch );
+
+		SO_DMA_MEMSET( scratch.m_Buffer, (scratch.m_Pitch * scratch.m_Height) >> 2, 
+					   a_This->m_BinClearPaletteIndex * 0x01010101 );
+
+		SoCameraDrawOrderingTable( a_This, band, top );
+
+		// Copy the band to the render target, at once if the rows line up;
+		destination = (u8*) target.m_Buffer + target.m_Pitch * top;
+
+		if ( a_This->m_Renderer != NULL && a_This->m_Renderer->m_BitsPerPixel == 16 )
+		{
+			u32 row;
+
+			for ( row = 0; row < scratch.m_Height; row++ )
+			{
+				SoRendererExpandScanline16( (u16*) (destination + target.m_Pitch * row), 
+											(u8*) scratch.m_Buffer + scratch.m_Pitch * row, 
+											target.m_Width );
+			}
+		}
+		else if ( target.m_Pitch == scratch.m_Pitch && ((u32) destination & 3) == 0 )
+		{
+			SO_DMA_MEMCPY( scratch.m_Buffer, destination, (scratch.m_Pitch * scratch.m_Height) >> 2 );
+		}
+		else
+		{
+			u32 row;
+
+			for ( row = 0; row < scratch.m_Height; row++ )
+			{
+				SoDMATransfer( 3, (u8*) scratch.m_Buffer + scratch.m_Pitch * row, 
+							   destination + target.m_Pitch * row, target.m_Width >> 1, 
+							   SO_DMA_SOURCE_INC | SO_DMA_DEST_INC | SO_DMA_16 );
+			}
+		}
+	}
+
+	SoMode4PolygonRasterizerSetRenderTarget( &previousTarget );
+
+	s_OrderingTableInUse = false;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Returns the buffer the camera draws into.
+
+	\internal Used by \a SoCameraEndFrame and \a SoCameraTransformMesh.
+
+	\param	a_This		This pointer
+	\param	a_Target	Gets the backbuffer of the 16 bit renderer set with 
+						\a SoCameraSetRenderer, or else the render target of 
+						the \a SoMode4PolygonRasterizer. 
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraGetRenderTarget( SoCamera* a_This, SoMode4PolygonRasterizerRenderTarget* a_Target )
+{
+	const SoRenderer* renderer = a_This->m_Renderer;
+
+	if ( renderer == NULL || renderer->m_BitsPerPixel == 8 )
+	{
+		SoMode4PolygonRasterizerGetRenderTarget( a_Target );
+		return;
+	}
+
+	a_Target->m_Buffer = renderer->m_GetBuffer();
+	a_Target->m_Width  = renderer->m_Width;
+	a_Target->m_Height = renderer->m_Height;
+	a_Target->m_Pitch  = renderer->m_Width << 1;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Finds the bands every triangle in the frame ordering table covers.
+
+	\internal Used by \a SoCameraEndFrame.
+
+	\param	a_This			This pointer
+	\param	a_BandHeight	Height of every band, in pixels.
+	\param	a_Height		Height of the render target, in pixels.
+
+	Sets \a SoCameraOrderedTriangle::m_Bands, so every band only needs to test one
+	bit to know which triangles to draw.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraBinOrderingTable( SoCamera* a_This, u32 a_BandHeight, s32 a_Height )
+{
+	u32 i;
+	s32 top, bottom;
+	SoVector2* v;
+	SoCameraOrderedTriangle* triangle;
+
+	// One divide per frame, instead of two per triangle. Rounding the reciprocal up 
+	// makes it exact for all rows of a render target;
+	u32 bandScale = SoMathDivide( 1 << 16, a_BandHeight ) + 1;
+
+	for ( i = 0; i < s_NumOrderedTriangles; i++ )
+	{
+		triangle = &s_OrderedTriangles[ i ];
+		v		 = triangle->m_ScreenSpaceVertices;
+
+		// Rows the triangle covers, with the top left filling convention;
+		top	   = SO_FIXED_CEIL_WHOLE( SO_MIN( v[ 0 ].m_Y, SO_MIN( v[ 1 ].m_Y, v[ 2 ].m_Y ) ) );
+		bottom = SO_FIXED_CEIL_WHOLE( SO_MAX( v[ 0 ].m_Y, SO_MAX( v[ 1 ].m_Y, v[ 2 ].m_Y ) ) );
+
+		if ( top	< 0		 ) top	  = 0;
+		if ( bottom > a_Height ) bottom = a_Height;
+
+		if ( bottom <= top )
+		{
+			triangle->m_Bands = 0;
+			continue;
+		}
+
+		// Set the bits of the first to the last band. Shifting by 32 is undefined, 
+		// so shift 2 by the last band instead;
+		top	   = (top		   * bandScale) >> 16;
+		bottom = ((bottom - 1) * bandScale) >> 16;
+
+		triangle->m_Bands = (2u << bottom) - (1u << top);
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws the triangles in the frame ordering table.
+
+	\internal Used by \a SoCameraEndFrame.
+
+	\param	a_This		This pointer
+	\param	a_Band		Only triangles that cover this band are drawn. Pass
+						\a SO_CAMERA_BINNING_MAX_NUM_BANDS to draw every triangle.
+	\param	a_Top		Row of the render target at the top of the band. The triangles 
+						are moved up by this many rows.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraDrawOrderingTable( SoCamera* a_This, u32 a_Band, s32 a_Top )
+{
+	// Current bucket and triangle;
+	s32 bucket, lastBucket, bucketStep;
+	u32 index;
+	SoCameraOrderedTriangle* triangle;
+
+	// Screen space vertices of the triangle, moved into the band;
+	SoVector2  bandVertices[ 3 ];
+	SoVector2* vertices;
+	bool	   binned = a_Band < SO_CAMERA_BINNING_MAX_NUM_BANDS;
+
+	// Texture the rasterizer is set to;
+	SoImage* texture = NULL;
+
+	// With a span buffer, nearer triangles hide the ones drawn after them;
+	bool frontToBack = SoMode4PolygonRasterizerGetSpanBufferEnable();
+
+	// Draw back to front, or front to back when the span buffer is enabled;
+	if ( frontToBack )
+	{
+		bucket	   = 0;
+		lastBucket = SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS;
+		bucketStep = 1;
+	}
+	else
+	{
+		bucket	   = SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS - 1;
+		lastBucket = -1;
+		bucketStep = -1;
+	}
+
+	for ( ; bucket != lastBucket; bucket += bucketStep )
+	{
+		for ( index = s_OrderingTable[ bucket ]; index != SO_CAMERA_ORDERING_TABLE_END; index = triangle->m_Next )
+		{
+			triangle = &s_OrderedTriangles[ index ];
+			vertices = triangle->m_ScreenSpaceVertices;
+
+			if ( binned )
+			{
+				// Skip triangles outside of this band;
+				if ( ! (triangle->m_Bands & (1u << a_Band)) ) continue;
+
+				// Move it into the band, keeping the subpixel position;
+				bandVertices[ 0 ].m_X = vertices[ 0 ].m_X;
+				bandVertices[ 0 ].m_Y = vertices[ 0 ].m_Y - SO_FIXED_FROM_WHOLE( a_Top );
+				bandVertices[ 1 ].m_X = vertices[ 1 ].m_X;
+				bandVertices[ 1 ].m_Y = vertices[ 1 ].m_Y - SO_FIXED_FROM_WHOLE( a_Top );
+				bandVertices[ 2 ].m_X = vertices[ 2 ].m_X;
+				bandVertices[ 2 ].m_Y = vertices[ 2 ].m_Y - SO_FIXED_FROM_WHOLE( a_Top );
+
+				vertices = bandVertices;
+			}
+
+			// Solid triangle. Only the C version clips against the top and bottom of a band;
+			if ( SoMeshGetTexture( triangle->m_Mesh ) == NULL )
+			{
+				if ( frontToBack || binned )
+				{
+					SoMode4PolygonRasterizerDrawSolidTriangleC( vertices, triangle->m_PaletteIndex );
+				}
+				else
+				{
+					SoMode4PolygonRasterizerDrawSolidTriangle( vertices, triangle->m_PaletteIndex );
+				}
+				continue;
+			}
+
+			// Only change the texture when we need to;
+			if ( SoMeshGetTexture( triangle->m_Mesh ) != texture )
+			{
+				texture = SoMeshGetTexture( triangle->m_Mesh );
+				SoMode4PolygonRasterizerSetTexture( texture );
+			}
+
+			SoMode4PolygonRasterizerSetTextureLevel( triangle->m_TextureLevel );
+
+			// Textured triangle;
+			if ( SoMeshGetPerspectiveSpanLength( triangle->m_Mesh ) != 0 )
+			{
+				SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle( vertices, 
+																		 triangle->m_TextureCoordinates,
+																		 triangle->m_Depths,
+																		 SoMeshGetPerspectiveSpanLength( triangle->m_Mesh ) );
+			}
+			else
+			{
+				SoMode4PolygonRasterizerDrawTexturedTriangle( vertices, triangle->m_TextureCoordinates );
+			}
+		}
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws or submits the given mesh.
+
+	\internal Used by \a SoCameraDrawMesh and \a SoCameraSubmitMesh.
+
+	\param	a_This					This pointer
+	\param	a_Mesh					Mesh that should be drawn
+	\param	a_ObjectToWorldMatrix	Matrix that places the mesh in the world
+	\param	a_StretchBound			How much longer that matrix can make a vector, 
+									see \a SoTransformGetStretchBound
+	\param	a_Submit				If \a true, the polygons are put in the frame 
+									ordering table instead of drawn.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraRenderMesh( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToWorldMatrix, 
+						 sofixedpoint a_StretchBound, bool a_Submit )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Where the mesh is with respect to the frustum;
+	u32 visibility;
+
+	// Lines don't need to be sorted;
+	if ( a_This->m_Wireframe )
+	{
+		a_Submit = false;
+	}
+
+	// Does the mesh have a texture;
+	if (  SoMeshGetTexture( a_Mesh ) != NULL )
+	{
+		// Set the texture the rasterizer should use, submitted polygons
+		// get their texture when they are drawn;
+		if ( ! a_Submit )
+		{
+			SoMode4PolygonRasterizerSetTexture( SoMeshGetTexture( a_Mesh ) );
+		}
+
+		// The polygon we are about to draw does has a texture.
+		s_CurrentPolygon.m_HasTexture = true;
+	}
+	else
+	{
+		// The polygon we are about to draw does not have a texture.
+		s_CurrentPolygon.m_HasTexture = false;
+	}
+
+	// Transform the mesh, this fills the screen- and 
+	// cameraspace vertex buffers. Nothing is transformed 
+	// if the mesh can't be seen;
+	visibility = SoCameraTransformMesh( a_This, a_Mesh, a_ObjectToWorldMatrix, a_StretchBound );
+
+	if ( visibility == SO_CAMERA_MESH_OUTSIDE )
+	{
+		return;
+	}
+
+	// Meshes that are entirely inside the frustum can be drawn as one triangle list;
+	if ( ! a_Submit && SoCameraDrawUnclippedMesh( a_This, a_Mesh, visibility == SO_CAMERA_MESH_INSIDE ) )
+	{
+		return;
+	}
+
+	// Draw each polygon of the mesh;
+	for ( i = 0; i < SoMeshGetNumPolygons( a_Mesh ); i++ )
+	{
+		// Skip it if it faces away, before doing anything with it;
+		if ( ! SoCameraFacesPolygon( i ) ) continue;
+
+		// Clip the polygon;
+		SoCameraClipPolygon( a_This, SoMeshGetPolygon( a_Mesh, i ) );
+
+		// Is there a polygon left after clipping;
+		if ( s_CurrentPolygon.m_NumVertices != 0 )
+		{
+			// Is the polygon clockwise ordered (not backface culled);
+			if (SoCameraClockwise( s_CurrentPolygon.m_ScreenSpaceVertices ) )
+			{
+				// Draw or submit the polygon;
+				if ( a_Submit )
+				{
+					SoCameraSubmitCurrentPolygon( a_This, a_Mesh, SoPolygonGetPaletteIndex( SoMeshGetPolygon( a_Mesh, i ) ) );
+				}
+				else
+				{
+					SoCameraDrawCurrentPolygon( a_This, a_Mesh, SoPolygonGetPaletteIndex( SoMeshGetPolygon( a_Mesh, i ) ) );
+				}
+			}
+		}
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws or submits the meshes of a scene node and everything below it.
+
+	\internal Used by \a SoCameraDrawSceneNode and \a SoCameraSubmitSceneNode.
+
+	\param	a_This		This pointer
+	\param	a_Node		Node that should be drawn
+	\param	a_Submit	If \a true, the polygons are put in the frame ordering table 
+						instead of drawn.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraRenderSceneNode( SoCamera* a_This, SoSceneNode* a_Node, bool a_Submit )
+{
+	SoSceneNode* child;
+
+	if ( SoSceneNodeGetMesh( a_Node ) != NULL )
+	{
+		SoCameraRenderMesh( a_This, SoSceneNodeGetMesh( a_Node ), 
+							SoSceneNodeGetWorldMatrix( a_Node ),
+							SoSceneNodeGetStretchBound( a_Node ), a_Submit );
+	}
+
+	for ( child = SoSceneNodeGetFirstChild( a_Node ); child != NULL; child = SoSceneNodeGetNextSibling( child ) )
+	{
+		SoCameraRenderSceneNode( a_This, child, a_Submit );
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws a mesh that needs no clipping as indexed triangle lists.
+
+	\internal Used by \a SoCameraRenderMesh only.
+
+	\param	a_This		This pointer
+	\param	a_Mesh		Mesh that should be drawn, already transformed
+	\param	a_Inside	\a true if the bounding sphere of the mesh is inside the frustum,
+						so its vertices don't have to be checked.
+
+	\retval	true	if the mesh is drawn.
+	\retval	false	if the mesh needs clipping, or can't be drawn as a triangle list.
+					Nothing is drawn in that case.
+
+	Skips copying every polygon into \a s_CurrentPolygon. The visible polygons are 
+	split into fans of triangles that index the screen space vertex buffer, and these 
+	are handed to \a SoMode4PolygonRasterizerDrawSolidTriangles or 
+	\a SoMode4PolygonRasterizerDrawTexturedTriangles in batches. Perspective correct
+	meshes and solid meshes drawn with the span buffer are left to the polygon path.
+*/
+// --------------------------------------------------------------------------------------
+bool SoCameraDrawUnclippedMesh( SoCamera* a_This, SoMesh* a_Mesh, bool a_Inside )
+{
+	// Dummy counters;
+	u32 i, j;
+
+	// Current polygon and its screen space vertices;
+	SoPolygon*	polygon;
+	SoVector2	screenSpaceVertices[ SO_POLYGON_MAX_NUM_VERTICES ];
+	SoVector2*	textureCoordinates;
+
+	// Number of triangles in the batch, and the mipmap level they use;
+	u32 numTriangles = 0;
+	u32 textureLevel = 0;
+	u32 polygonTextureLevel;
+
+	// Can the rasterizer draw this mesh as a triangle list. Outlines can always be drawn;
+	if ( ! a_This->m_Wireframe )
+	{
+		if ( SoMeshGetTexture( a_Mesh ) != NULL )
+		{
+			if ( SoMeshGetPerspectiveSpanLength( a_Mesh ) != 0 ) return false;
+		}
+		else
+		{
+			if ( SoMode4PolygonRasterizerGetSpanBufferEnable() ) return false;
+		}
+	}
+
+	// Are all the vertices inside the frustum (see SoCameraSafeProject);
+	for ( i = 0; ! a_Inside && i < SoMeshGetNumVertices( a_Mesh ); i++ )
+	{
+		if ( s_VertexUsed[ i ] && s_VertexClipCodes[ i ] != SO_CAMERA_VERTEX_ON_SCREEN ) return false;
+	}
+
+	// Build the triangle list;
+	for ( i = 0; i < SoMeshGetNumPolygons( a_Mesh ); i++ )
+	{
+		polygon = SoMeshGetPolygon( a_Mesh, i );
+
+		if ( ! SoCameraFacesPolygon( i ) ) continue;
+
+		// Is the polygon clockwise ordered (not backface culled);
+		for ( j = 0; j < SoPolygonGetNumVertices( polygon ); j++ )
+		{
+			screenSpaceVertices[ j ] = s_ScreenSpaceVertexBuffer[ SoPolygonGetVertexIndex( polygon, j ) ];
+		}
+
+		if ( ! SoCameraClockwise( screenSpaceVertices ) ) continue;
+
+		// Outlines are drawn right away;
+		if ( a_This->m_Wireframe )
+		{
+			SoMode4PolygonRasterizerDrawPolyline( SoPolygonGetNumVertices( polygon ), screenSpaceVertices,
+												  true, SoPolygonGetPaletteIndex( polygon ) );
+			continue;
+		}
+
+		textureCoordinates = SoPolygonGetTextureCoordinates( polygon );
+
+		// Textured polygons of a different mipmap level go in a new batch;
+		if ( SoMeshGetTexture( a_Mesh ) != NULL )
+		{
+			polygonTextureLevel = SoMode4PolygonRasterizerCalculateTextureLevel( SoMeshGetTexture( a_Mesh ),
+																				 SoPolygonGetNumVertices( polygon ),
+																				 screenSpaceVertices, 
+																				 textureCoordinates );
+			if ( polygonTextureLevel != textureLevel )
+			{
+				SoCameraFlushBatch( a_This, a_Mesh, numTriangles );
+				numTriangles = 0;
+				textureLevel = polygonTextureLevel;
+
+				SoMode4PolygonRasterizerSetTextureLevel( textureLevel );
+			}
+		}
+
+		// Add it as a fan of triangles;
+		for ( j = 1; j < SoPolygonGetNumVertices( polygon ) - 1; j++ )
+		{
+			s_BatchIndices[ numTriangles * 3 + 0 ] = SoPolygonGetVertexIndex( polygon, 0 );
+			s_BatchIndices[ numTriangles * 3 + 1 ] = SoPolygonGetVertexIndex( polygon, j );
+			s_BatchIndices[ numTriangles * 3 + 2 ] = SoPolygonGetVertexIndex( polygon, j + 1 );
+
+			if ( textureCoordinates != NULL )
+			{
+				s_BatchTextureCoordinates[ numTriangles * 3 + 0 ] = textureCoordinates[ 0 ];
+				s_BatchTextureCoordinates[ numTriangles * 3 + 1 ] = textureCoordinates[ j ];
+				s_BatchTextureCoordinates[ numTriangles * 3 + 2 ] = textureCoordinates[ j + 1 ];
+			}
+
+			s_BatchPaletteIndices[ numTriangles ] = SoPolygonGetPaletteIndex( polygon );
+
+			// Draw the batch if it is full;
+			if ( ++numTriangles == SO_CAMERA_BATCH_MAX_NUM_TRIANGLES )
+			{
+				SoCameraFlushBatch( a_This, a_Mesh, numTriangles );
+				numTriangles = 0;
+			}
+		}
+	}
+
+	// Draw the remaining triangles;
+	SoCameraFlushBatch( a_This, a_Mesh, numTriangles );
+
+	return true;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws the triangle list built by \a SoCameraDrawUnclippedMesh.
+
+	\internal Used by \a SoCameraDrawUnclippedMesh only.
+
+	\param	a_This			This pointer
+	\param	a_Mesh			Mesh the triangles belong to
+	\param	a_NumTriangles	Number of triangles in the batch
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraFlushBatch( SoCamera* a_This, SoMesh* a_Mesh, u32 a_NumTriangles )
+{
+	if ( a_NumTriangles == 0 ) return;
+
+	if ( SoMeshGetTexture( a_Mesh ) != NULL )
+	{
+		SoMode4PolygonRasterizerDrawTexturedTriangles( s_ScreenSpaceVertexBuffer, s_BatchIndices,
+													   a_NumTriangles, s_BatchTextureCoordinates );
+	}
+	else
+	{
+		SoMode4PolygonRasterizerDrawSolidTriangles( s_ScreenSpaceVertexBuffer, s_BatchIndices,
+													a_NumTriangles, s_BatchPaletteIndices );
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Draws the clipped \a s_CurrentPolygon.
+
+	\internal Used by \a SoCameraRenderMesh only.
+
+	\param	a_This			This pointer
+	\param	a_Mesh			Mesh the polygon belongs to
+	\param	a_PaletteIndex	Color of the polygon, if it isn't textured
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraDrawCurrentPolygon( SoCamera* a_This, SoMesh* a_Mesh, u32 a_PaletteIndex )
+{
+	// Dummy counter;
+	u32 j;
+
+	// Single triangle of a textured polygon;
+	SoVector2 triangle[ 3 ];
+	SoVector2 triangleTextureCoordinates[ 3 ];
+	sofixedpoint triangleDepths[ 3 ];
+
+	// Only draw the outline in wireframe mode;
+	if ( a_This->m_Wireframe )
+	{
+		SoMode4PolygonRasterizerDrawPolyline( s_CurrentPolygon.m_NumVertices, s_CurrentPolygon.m_ScreenSpaceVertices,
+											  true, a_PaletteIndex );
+		return;
+	}
+
+	// Draw the polygon;
+	if ( s_CurrentPolygon.m_HasTexture )
+	{
+		// Use the mipmap level that fits the size of the polygon;
+		SoMode4PolygonRasterizerSetTextureLevel( 
+			SoMode4PolygonRasterizerCalculateTextureLevel( SoMeshGetTexture( a_Mesh ),
+														   s_CurrentPolygon.m_NumVertices,
+														   s_CurrentPolygon.m_ScreenSpaceVertices,
+														   s_CurrentPolygon.m_TextureCoordinates ) );
+
+		// Draw it as a fan of triangles;
+		for ( j = 1; j < s_CurrentPolygon.m_NumVertices - 1; j++ )
+		{
+			triangle[ 0 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ 0 ];
+			triangle[ 1 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j ];
+			triangle[ 2 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j + 1 ];
+
+			triangleTextureCoordinates[ 0 ] = s_CurrentPolygon.m_TextureCoordinates[ 0 ];
+			triangleTextureCoordinates[ 1 ] = s_CurrentPolygon.m_TextureCoordinates[ j ];
+			triangleTextureCoordinates[ 2 ] = s_CurrentPolygon.m_TextureCoordinates[ j + 1 ];
+
+			// Does the mesh want perspective correct texturing;
+			if ( SoMeshGetPerspectiveSpanLength( a_Mesh ) != 0 )
+			{
+				triangleDepths[ 0 ] = s_CurrentPolygon.m_CameraSpaceVertices[ 0 ].m_Z;
+				triangleDepths[ 1 ] = s_CurrentPolygon.m_CameraSpaceVertices[ j ].m_Z;
+				triangleDepths[ 2 ] = s_CurrentPolygon.m_CameraSpaceVertices[ j + 1 ].m_Z;
+
+				SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle( triangle, 
+																		 triangleTextureCoordinates,
+																		 triangleDepths,
+																		 SoMeshGetPerspectiveSpanLength( a_Mesh ) );
+			}
+			else
+			{
+				SoMode4PolygonRasterizerDrawTexturedTriangle( triangle, triangleTextureCoordinates );
+			}
+		}
+	}
+	else if ( SoMode4PolygonRasterizerGetSpanBufferEnable() )
+	{
+		// Only the C triangle routine knows about the span buffer, 
+		// so draw it as a fan of triangles;
+		for ( j = 1; j < s_CurrentPolygon.m_NumVertices - 1; j++ )
+		{
+			triangle[ 0 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ 0 ];
+			triangle[ 1 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j ];
+			triangle[ 2 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j + 1 ];
+
+			SoMode4PolygonRasterizerDrawSolidTriangleC( triangle, a_PaletteIndex );
+		}
+	}
+	else
+	{
+		// Maybe it's a triangle;
+		if ( s_CurrentPolygon.m_NumVertices == 3 )
+		{
+			SoMode4PolygonRasterizerDrawSolidTriangle( s_CurrentPolygon.m_ScreenSpaceVertices, a_PaletteIndex );
+		}
+		else
+		{
+			SoMode4PolygonRasterizerDrawSolidPolygon( s_CurrentPolygon.m_NumVertices,
+													  s_CurrentPolygon.m_ScreenSpaceVertices, 
+													  a_PaletteIndex );
+		}
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Puts the clipped \a s_CurrentPolygon in the frame ordering table.
+
+	\internal Used by \a SoCameraRenderMesh only.
+
+	\param	a_This			This pointer
+	\param	a_Mesh			Mesh the polygon belongs to
+	\param	a_PaletteIndex	Color of the polygon, if it isn't textured
+
+	The polygon is split into a fan of triangles, which all go into the bucket of the
+	average camera space Z of the polygon. 
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraSubmitCurrentPolygon( SoCamera* a_This, SoMesh* a_Mesh, u32 a_PaletteIndex )
+{
+	// Dummy counter;
+	u32 j;
+
+	// Depth values;
+	s32 depth = 0;
+	s32 bucket;
+
+	// Triangle in the ordering table;
+	SoCameraOrderedTriangle* triangle;
+
+	// Mipmap level of the texture;
+	u32 textureLevel = 0;
+
+	if ( s_CurrentPolygon.m_HasTexture )
+	{
+		textureLevel = SoMode4PolygonRasterizerCalculateTextureLevel( SoMeshGetTexture( a_Mesh ),
+																	  s_CurrentPolygon.m_NumVertices,
+																	  s_CurrentPolygon.m_ScreenSpaceVertices,
+																	  s_CurrentPolygon.m_TextureCoordinates );
+	}
+
+	// Calculate the average whole depth of the polygon;
+	for ( j = 0; j < s_CurrentPolygon.m_NumVertices; j++ )
+	{
+		depth += SO_FIXED_TO_WHOLE( s_CurrentPolygon.m_CameraSpaceVertices[ j ].m_Z );
+	}
+	depth = SO_FIXED_TO_WHOLE( depth * SO_FIXED_ONE_OVER_FAST_INACCURATE( SO_FIXED_FROM_WHOLE( s_CurrentPolygon.m_NumVertices ) ) );
+
+	// Find the bucket it goes in;
+	bucket = SO_FIXED_TO_WHOLE( (depth - a_This->m_NearPlaneDistance) * s_OrderingTableScale );
+	if ( bucket < 0 ) bucket = 0;
+	if ( bucket > SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS - 1 ) bucket = SO_CAMERA_ORDERING_TABLE_NUM_BUCKETS - 1;
+
+	// Add it as a fan of triangles;
+	for ( j = 1; j < s_CurrentPolygon.m_NumVertices - 1; j++ )
+	{
+		// Is the table full;
+		if ( s_NumOrderedTriangles == SO_CAMERA_ORDERING_TABLE_MAX_NUM_TRIANGLES )
+		{
+			SO_ASSERT( false, "Too many triangles in one frame, increase SO_CAMERA_ORDERING_TABLE_MAX_NUM_TRIANGLES." );
+			return;
+		}
+
+		triangle = &s_OrderedTriangles[ s_NumOrderedTriangles ];
+
+		triangle->m_ScreenSpaceVertices[ 0 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ 0 ];
+		triangle->m_ScreenSpaceVertices[ 1 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j ];
+		triangle->m_ScreenSpaceVertices[ 2 ] = s_CurrentPolygon.m_ScreenSpaceVertices[ j + 1 ];
+
+		if ( s_CurrentPolygon.m_HasTexture )
+		{
+			triangle->m_TextureCoordinates[ 0 ] = s_CurrentPolygon.m_TextureCoordinates[ 0 ];
+			triangle->m_TextureCoordinates[ 1 ] = s_CurrentPolygon.m_TextureCoordinates[ j ];
+			triangle->m_TextureCoordinates[ 2 ] = s_CurrentPolygon.m_TextureCoordinates[ j + 1 ];
+
+			triangle->m_Depths[ 0 ] = s_CurrentPolygon.m_CameraSpaceVertices[ 0 ].m_Z;
+			triangle->m_Depths[ 1 ] = s_CurrentPolygon.m_CameraSpaceVertices[ j ].m_Z;
+			triangle->m_Depths[ 2 ] = s_CurrentPolygon.m_CameraSpaceVertices[ j + 1 ].m_Z;
+		}
+
+		triangle->m_Mesh		 = a_Mesh;
+		triangle->m_PaletteIndex = a_PaletteIndex;
+		triangle->m_TextureLevel = textureLevel;
+
+		// Link it in at the head of its bucket;
+		triangle->m_Next		   = s_OrderingTable[ bucket ];
+		s_OrderingTable[ bucket ] = s_NumOrderedTriangles;
+
+		s_NumOrderedTriangles++;
+	}
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Returns the world to camera space matrix.
+
+	\internal Used by \a SoCameraTransformMesh only.
+
+	\param	a_This	This pointer
+
+	The inverse of the camera transform is only recalculated after the camera 
+	moved, not for every mesh that is drawn.
+*/
+// --------------------------------------------------------------------------------------
+SoMatrix* SoCameraGetWorldToCameraMatrix( SoCamera* a_This )
+{
+	if ( a_This->m_WorldToCameraMatrixDirty )
+	{
+		SoTransformToInverseMatrix( &a_This->m_Transform, &a_This->m_WorldToCameraMatrix );
+
+		a_This->m_WorldToCameraMatrixDirty = false;
+	}
+
+	return &a_This->m_WorldToCameraMatrix;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Transforms the given mesh filling the camera- and screenspace vertex buffers.
+
+	\internal Used by \a SoCameraDrawMesh only.
+
+	\param	a_This					This pointer
+	\param	a_Mesh					Mesh to be transformed
+	\param	a_ObjectToWorldMatrix	Matrix that places the mesh in the world
+	\param	a_StretchBound			How much longer that matrix can make a vector
+
+	\return	One of the SO_CAMERA_MESH_ * constants. Nothing is transformed if the 
+			mesh is outside the frustum.
+
+	This method calculates the objectspace to cameraspace (via worldspace) matrix and 
+	transforms the mesh by that matrix, filling the cameraspace vertex buffer. It then uses
+	a safe project method to project the vertices to screenspace. This safeproject marks any
+	vertex that couldn't be projected because it was outside of the frustum, or in
+	the guard band (see \a SoCameraSetGuardBandClippingEnable).
+
+	The bounding sphere of the mesh is tested first (see 
+	\a SoMeshCalculateBoundingSphere). If it is entirely inside the frustum, the 
+	vertices are projected without any checks. Vertices that are only used by 
+	polygons facing away from the camera aren't transformed at all (see
+	\a SoCameraMarkUsedVertices).
+
+	Screenspace is the render target of the \a SoMode4PolygonRasterizer (see
+	\a SoMode4PolygonRasterizerSetRenderTarget), or the buffer of a 16 bit renderer
+	(see \a SoCameraSetRenderer). The frustum stays the same for smaller targets, 
+	the image is just scaled down to fit.
+*/
+// --------------------------------------------------------------------------------------
+u32 SoCameraTransformMesh( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToWorldMatrix, sofixedpoint a_StretchBound )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Where the mesh is with respect to the frustum;
+	u32 visibility;
+	
+	// Matrix;
+	SoMatrix objectToCameraMatrix;
+
+	// Render target we project into;
+	SoMode4PolygonRasterizerRenderTarget target;
+
+	// Calculate the projection scale if the render target changed size;
+	SoCameraGetRenderTarget( a_This, &target );
+
+	if ( (s32) target.m_Width != s_ScreenWidth || (s32) target.m_Height != s_ScreenHeight )
+	{
+		s_ScreenWidth		= target.m_Width;
+		s_ScreenHeight		= target.m_Height;
+		s_ProjectionScaleX	= SoMathDivide( s_ScreenWidth  << 8, SO_SCREEN_WIDTH  );
+		s_ProjectionScaleY	= SoMathDivide( s_ScreenHeight << 8, SO_SCREEN_HEIGHT );
+	}
+
+	// Multiply the world- to cameraspace matrix with the object- to worldspace 
+	// matrix to create the object- to cameraspace matrix;
+	SoMatrixMultiply( &objectToCameraMatrix, SoCameraGetWorldToCameraMatrix( a_This ), a_ObjectToWorldMatrix );
+
+	// Don't bother with meshes that can't be seen;
+	visibility = SoCameraClassifyBoundingSphere( a_This, a_Mesh, &objectToCameraMatrix, a_StretchBound );
+
+	if ( visibility == SO_CAMERA_MESH_OUTSIDE ) return visibility;
+
+	// Find the vertices of the polygons that face the camera;
+	SoCameraMarkUsedVertices( a_This, a_Mesh, &objectToCameraMatrix, a_StretchBound );
+
+	// Clip in 2D if we can. The new vertices of perspective correct textured
+	// polygons need a real depth, so those are clipped in 3D;
+	s_GuardBandClipping = a_This->m_GuardBandClipping && a_This->m_ClipAgainstFrustumSidePlanes &&
+						  ( SoMeshGetTexture( a_Mesh ) == NULL || SoMeshGetPerspectiveSpanLength( a_Mesh ) == 0 );
+
+	// Transform all the vertices in the mesh to camera space;
+	// And then project them to screen space;
+	for ( i = 0; i < SoMeshGetNumVertices( a_Mesh ); i++ )
+	{
+		if ( ! s_VertexUsed[ i ] ) continue;
+
+		SoVector3TransformInto( SoMeshGetVertex( a_Mesh, i ), 
+								&s_CameraSpaceVertexBuffer[ i ], 
+								&objectToCameraMatrix );
+
+		if ( visibility == SO_CAMERA_MESH_INSIDE )
+		{
+			SoCameraProject( a_This, &s_CameraSpaceVertexBuffer[ i ],
+							 &s_ScreenSpaceVertexBuffer[ i ] );
+
+			s_VertexClipCodes[ i ] = SO_CAMERA_VERTEX_ON_SCREEN;
+		}
+		else
+		{
+			s_VertexClipCodes[ i ] = SoCameraSafeProject( a_This, &s_CameraSpaceVertexBuffer[ i ],
+														  &s_ScreenSpaceVertexBuffer[ i ] );
+		}
+	}
+
+	return visibility;
 }
 // --------------------------------------------------------------------------------------
 
 // --------------------------------------------------------------------------------------
 /*!
-	\brief Moves the camera up by the given fixed point amount.
+	\brief	Tests the bounding sphere of a mesh against the frustum.
 
-	\param	a_This		This pointer
-    \param	a_Amount	Fixed point amount to move up with
+	\internal Used by \a SoCameraTransformMesh only.
 
-	If you need downwards movement just give a negative amount.
+	\param	a_This						This pointer
+	\param	a_Mesh						Mesh to test
+	\param	a_ObjectToCameraMatrix		Matrix the mesh is transformed with
+	\param	a_StretchBound				How much longer that matrix can make a vector
+
+	\return	One of the SO_CAMERA_MESH_ * constants. Meshes without a bounding 
+			sphere are always intersecting.
+
+	Transforms the center of the sphere to camera space, and compares its distance 
+	to each of the six frustum planes with the radius. The radius is grown with the
+	stretch bound, so the sphere stays around the mesh.
+	
+	The planes lie a little inside the frustum (see \a SoCameraDistanceToFrustumPlane),
+	so vertices of a mesh that is inside project on the screen for sure.
 */
 // --------------------------------------------------------------------------------------
-void SoCameraUp( SoCamera* a_This,  sofixedpoint a_Amount )
+u32 SoCameraClassifyBoundingSphere( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToCameraMatrix, 
+									sofixedpoint a_StretchBound )
 {
-	SoTransformTranslate( &a_This->m_Transform, 0, a_Amount, 0 );
+	// Current frustum plane;
+	s32 plane;
+
+	// Sphere in camera space;
+	SoVector3	 center;
+	sofixedpoint radius = SoMeshGetBoundingSphereRadius( a_Mesh );
+	sofixedpoint distance;
+
+	// Is the mesh inside so far;
+	bool inside = true;
+
+	if ( radius == 0 ) return SO_CAMERA_MESH_INTERSECTING;
+
+	// Grow the radius with the scale of the mesh;
+	if ( a_StretchBound != SO_FIXED_FROM_WHOLE( 1 ) )
+	{
+		radius = SoMathFixedMultiply( radius, a_StretchBound );
+	}
+
+	SoVector3TransformInto( SoMeshGetBoundingSphereCenter( a_Mesh ), &center, a_ObjectToCameraMatrix );
+
+	// The plane constants run from near (-1) to bottom (-6);
+	for ( plane = SO_CAMERA_FRUSTUM_NEAR_PLANE; plane >= SO_CAMERA_FRUSTUM_BOTTOM_PLANE; plane-- )
+	{
+		distance = SoCameraDistanceToFrustumPlane( a_This, &center, plane );
+
+		// The side plane distances can come out up to a whole unit low, so 
+		// leave some room before throwing a mesh away;
+		if ( distance < -radius - SO_FIXED_FROM_WHOLE( 1 ) ) return SO_CAMERA_MESH_OUTSIDE;
+		if ( distance <	 radius ) inside = false;
+	}
+
+	return inside ? SO_CAMERA_MESH_INSIDE : SO_CAMERA_MESH_INTERSECTING;
 }
 // --------------------------------------------------------------------------------------
 
 // --------------------------------------------------------------------------------------
 /*!
-	\brief	Draws the given mesh into the current buffer
+	\brief	Culls the polygons of a mesh in object space, and marks the vertices they use.
 
-	\param	a_This		This pointer
-	\param	a_Mesh		Mesh that should be drawn
-
-	\todo	Make this method independent from the SoMode4Rasterizer
+	\internal Used by \a SoCameraTransformMesh only.
 
-	This function transforms the given mesh from object space to camera space, performs
-	clipping if neccesary and requested, then transforms it to screenspace, and then
-	draws it using the correct functions (texture, non-textured, etc.).
+	\param	a_This						This pointer
+	\param	a_Mesh						Mesh to cull
+	\param	a_ObjectToCameraMatrix		Matrix the mesh is transformed with
+	\param	a_StretchBound				How much longer that matrix can make a vector
+
+	If the mesh has polygon planes (see \a SoMeshCalculatePolygonPlanes), the camera 
+	is put in object space, and only the vertices of the polygons in front of it 
+	are marked in \a s_VertexUsed. Otherwise every vertex is. Which polygons are
+	in front is kept in \a s_PolygonFacing, so the draw loops don't test them again.
+	
+	The camera sits at the origin of camera space, so in object space it's at the 
+	inverse rotation times the negated translation of the matrix. The transpose of 
+	the rotation is only its inverse if the mesh isn't scaled, so scaled meshes are
+	left to the screen space test, and so are meshes with more than 
+	\a SO_MESH_MAX_NUM_POLYGONS polygons.
 */
 // --------------------------------------------------------------------------------------
-void SoCameraDrawMesh( SoCamera* a_This, SoMesh* a_Mesh )
+void SoCameraMarkUsedVertices( SoCamera* a_This, SoMesh* a_Mesh, SoMatrix* a_ObjectToCameraMatrix, 
+							   sofixedpoint a_StretchBound )
 {
-	// Dummy counter;
-	u32 i;
+	// Dummy counters;
+	u32 i, j;
 
-	// Does the mesh have a texture;
-	if (  SoMeshGetTexture( a_Mesh ) != NULL )
-	{
-		// Set the texture the rasterizer should use;
-		SoMode4PolygonRasterizerSetTexture( SoMeshGetTexture( a_Mesh ) );
+	// Matrix cells, see SoMatrix;
+	sofixedpoint* cel = a_ObjectToCameraMatrix->m_C;
 
-		// The polygon we are about to draw does has a texture.
-		s_CurrentPolygon.m_HasTexture = true;
-	}
-	else
+	SoPolygon*	  polygon;
+
+	s_ObjectSpaceCulling = SoMeshHasPolygonPlanes( a_Mesh ) && a_StretchBound == SO_FIXED_FROM_WHOLE( 1 ) &&
+						   SoMeshGetNumPolygons( a_Mesh ) <= SO_MESH_MAX_NUM_POLYGONS;
+
+	if ( ! s_ObjectSpaceCulling )
 	{
-		// The polygon we are about to draw does not have a texture.
-		s_CurrentPolygon.m_HasTexture = false;
+		for ( i = 0; i < SoMeshGetNumVertices( a_Mesh ); i++ ) s_VertexUsed[ i ] = 1;
+		return;
 	}
 
-	// Transform the mesh, this fills the screen- and 
-	// cameraspace vertex buffers;
-	SoCameraTransformMesh( a_This, a_Mesh );
+	// Put the camera in object space;
+	s_ObjectSpaceEye.m_X = -( SoMathFixedMultiply( cel[ 0 ], cel[ 3 ] ) + 
+							  SoMathFixedMultiply( cel[ 4 ], cel[ 7 ] ) + 
+							  SoMathFixedMultiply( cel[ 8 ], cel[ 11 ] ) );
+	s_ObjectSpaceEye.m_Y = -( SoMathFixedMultiply( cel[ 1 ], cel[ 3 ] ) + 
+							  SoMathFixedMultiply( cel[ 5 ], cel[ 7 ] ) + 
+							  SoMathFixedMultiply( cel[ 9 ], cel[ 11 ] ) );
+	s_ObjectSpaceEye.m_Z = -( SoMathFixedMultiply( cel[ 2 ], cel[ 3 ] ) + 
+							  SoMathFixedMultiply( cel[ 6 ], cel[ 7 ] ) + 
+							  SoMathFixedMultiply( cel[ 10 ], cel[ 11 ] ) );
+
+	// Mark the polygons facing it, and their vertices;
+	for ( i = 0; i < SoMeshGetNumVertices( a_Mesh ); i++ ) s_VertexUsed[ i ] = 0;
+	for ( i = 0; i < (SoMeshGetNumPolygons( a_Mesh ) + 31) >> 5; i++ ) s_PolygonFacing[ i ] = 0;
 
-	// Draw each polygon of the mesh;
 	for ( i = 0; i < SoMeshGetNumPolygons( a_Mesh ); i++ )
 	{
-		// Clip the polygon;
-		SoCameraClipPolygon( a_This, SoMeshGetPolygon( a_Mesh, i ) );
+		polygon = SoMeshGetPolygon( a_Mesh, i );
 
-		// Is there a polygon left after clipping;
-		if ( s_CurrentPolygon.m_NumVertices != 0 )
+		if ( ! SoPolygonFacesPoint( polygon, &s_ObjectSpaceEye ) ) continue;
+
+		s_PolygonFacing[ i >> 5 ] |= 1u << (i & 31);
+
+		for ( j = 0; j < SoPolygonGetNumVertices( polygon ); j++ )
 		{
-			// Is the polygon clockwise ordered (not backface culled);
-			if (SoCameraClockwise( s_CurrentPolygon.m_ScreenSpaceVertices ) )
-			{
-				// Draw the polygon;
-				if ( s_CurrentPolygon.m_HasTexture )
-				{
-					SoMode4PolygonRasterizerDrawTexturedPolygon( s_CurrentPolygon.m_NumVertices,
-																 s_CurrentPolygon.m_ScreenSpaceVertices, 
-																 s_CurrentPolygon.m_TextureCoordinates
-																);		
-				}
-				else
-				{
-					// Maybe it's a triangle;
-					if ( s_CurrentPolygon.m_NumVertices == 3 )
-					{
-						SoMode4PolygonRasterizerDrawSolidTriangle( s_CurrentPolygon.m_ScreenSpaceVertices, 
-																   SoPolygonGetPaletteIndex( SoMeshGetPolygon( a_Mesh, i ) ) );
-					}
-					else
-					{
-						SoMode4PolygonRasterizerDrawSolidPolygon( s_CurrentPolygon.m_NumVertices,
-															 s_CurrentPolygon.m_ScreenSpaceVertices, 
-															 SoPolygonGetPaletteIndex( SoMeshGetPolygon( a_Mesh, i ) )
-														   );		
-					}
-				}
-			}
+			s_VertexUsed[ SoPolygonGetVertexIndex( polygon, j ) ] = 1;
 		}
 	}
 }
@@ -452,50 +1896,21 @@ void SoCameraDrawMesh( SoCamera* a_This, SoMesh* a_Mesh )
 
 // --------------------------------------------------------------------------------------
 /*!
-	\brief Transforms the given mesh filling the camera- and screenspace vertex buffers.
+	\brief	Returns whether a polygon of the current mesh faces the camera.
 
-	\internal Used by \a SoCameraDrawMesh only.
+	\internal
 
-	\param	a_This	This pointer
-	\param	a_Mesh	Mesh to be transformed
+	\param	a_Index		Index of a polygon of the mesh \a SoCameraMarkUsedVertices was 
+						last called for.
 
-	This method calculates the objectspace to cameraspace (via worldspace) matrix and 
-	transforms the mesh by that matrix, filling the cameraspace vertex buffer. It then uses
-	a safe project method to project the vertices to screenspace. This safeproject marks any
-	vertex that couldn't be projected because it was outside of the frustum.	
+	Always \a true if that mesh isn't culled in object space. Otherwise it reads the
+	bit \a SoCameraMarkUsedVertices set for the polygon. Polygons that pass still 
+	go through \a SoCameraClockwise on the screen.
 */
 // --------------------------------------------------------------------------------------
-void SoCameraTransformMesh( SoCamera* a_This, SoMesh* a_Mesh )
+bool SoCameraFacesPolygon( u32 a_Index )
 {
-	// Dummy counter;
-	u32 i;
-	
-	// Matrices;
-	SoMatrix worldToCameraMatrix;
-	SoMatrix objectToWorldMatrix;
-	SoMatrix objectToCameraMatrix;
-
-	// Create the object- to worldspace matrix;
-	SoTransformToMatrix( SoMeshGetTransform( a_Mesh ), &objectToWorldMatrix );
-
-	// Create the world- to cameraspace matrix;
-	SoTransformToInverseMatrix( &a_This->m_Transform, &worldToCameraMatrix );
-
-	// Multiply the two to create the object- to cameraspace matrix;
-	SoMatrixMultiply( &objectToCameraMatrix, &worldToCameraMatrix, &objectToWorldMatrix );
-
-	// Transform all the vertices in the mesh to camera space;
-	// And then project them to screen space;
-	for ( i = 0; i < SoMeshGetNumVertices( a_Mesh ); i++ )
-	{
-		SoVector3TransformInto( SoMeshGetVertex( a_Mesh, i ), 
-								&s_CameraSpaceVertexBuffer[ i ], 
-								&objectToCameraMatrix );
-
-		SoCameraSafeProject( a_This, &s_CameraSpaceVertexBuffer[ i ],
-							 &s_ScreenSpaceVertexBuffer[ i ] );
-
-	}
+	return ! s_ObjectSpaceCulling || ( s_PolygonFacing[ a_Index >> 5 ] & (1u << (a_Index & 31)) );
 }
 // --------------------------------------------------------------------------------------
 
@@ -518,6 +1933,9 @@ void SoCameraTransformMesh( SoCamera* a_This, SoMesh* a_Mesh )
 	frustum sideplane clipping are enabled. If these are both disabled all this function does
 	is copy the polygon from the given \a SoPolygon object into the \a s_CurrentPolygon
 	object.
+
+	Polygons that only have vertices on the screen and in the guard band are clipped 
+	against the screen edges in 2D instead, see \a SoCameraSetGuardBandClippingEnable.
 */
 // --------------------------------------------------------------------------------------
 void SoCameraClipPolygon( SoCamera* a_This, SoPolygon* a_Polygon )
@@ -527,6 +1945,7 @@ void SoCameraClipPolygon( SoCamera* a_This, SoPolygon* a_Polygon )
 
 	// Booleans for different polygon situations;
 	bool polygonNeedsClipping = false;
+	bool polygonNeedsGuardBandClipping = false;
 	
 	// Texture coordinate array;
 	SoVector2* textureCoordinates = SoPolygonGetTextureCoordinates( a_Polygon );
@@ -563,13 +1982,18 @@ void SoCameraClipPolygon( SoCamera* a_This, SoPolygon* a_Polygon )
 		s_CurrentPolygon.m_ScreenSpaceVertices[ i ].m_Y = screenSpaceVertex->m_Y;
 
 		// Is this vertex outside of the frustum;
-		if ( screenSpaceVertex->m_X < 0 )
+		if ( s_VertexClipCodes[ SoPolygonGetVertexIndex( a_Polygon, i ) ] == SO_CAMERA_VERTEX_OUTSIDE )
 		{
 			// There is at least one vertex of this polygon
 			// that is not in the frustum. We need to clip
 			// the entire polygon;
 			polygonNeedsClipping = true;
 		}
+		else if ( s_VertexClipCodes[ SoPolygonGetVertexIndex( a_Polygon, i ) ] == SO_CAMERA_VERTEX_IN_GUARD_BAND )
+		{
+			// It is projected, but off the screen;
+			polygonNeedsGuardBandClipping = true;
+		}
 	}
 	
 	// Do we need to clip the polygon;
@@ -626,6 +2050,17 @@ void SoCameraClipPolygon( SoCamera* a_This, SoPolygon* a_Polygon )
 		// Project the unprojected vertices;
 		SoCameraProjectUnProjectedVertices( a_This );
 	}
+	// Do we only need to clip the polygon against the screen edges;
+	else if ( polygonNeedsGuardBandClipping )
+	{
+		SoCameraClipPolygonAgainstScreenEdge( SO_CAMERA_FRUSTUM_LEFT_PLANE );
+		if ( s_CurrentPolygon.m_NumVertices == 0 ) return;
+		SoCameraClipPolygonAgainstScreenEdge( SO_CAMERA_FRUSTUM_RIGHT_PLANE );
+		if ( s_CurrentPolygon.m_NumVertices == 0 ) return;
+		SoCameraClipPolygonAgainstScreenEdge( SO_CAMERA_FRUSTUM_TOP_PLANE );
+		if ( s_CurrentPolygon.m_NumVertices == 0 ) return;
+		SoCameraClipPolygonAgainstScreenEdge( SO_CAMERA_FRUSTUM_BOTTOM_PLANE );
+	}
 }
 // --------------------------------------------------------------------------------------
 
@@ -710,6 +2145,39 @@ sofixedpoint  SoCameraDistanceToFrustumPlane( SoCamera* a_This, SoVector3* a_Cam
 }
 // --------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Returns the fixed point distance from a screenspace vertex to a screen edge.
+
+	\internal 
+
+	\param	a_ScreenSpaceVertex		Vertex in screen space
+	\param	a_WhichScreenEdge		One of the SO_CAMERA_FRUSTUM_LEFT, _RIGHT, _TOP and 
+									_BOTTOM _PLANE constants.
+
+	Positive if the vertex is on the screen side of the edge.
+*/
+// --------------------------------------------------------------------------------------
+sofixedpoint SoCameraDistanceToScreenEdge( SoVector2* a_ScreenSpaceVertex, s32 a_WhichScreenEdge )
+{
+	switch( a_WhichScreenEdge )
+	{
+		case SO_CAMERA_FRUSTUM_LEFT_PLANE:		return a_ScreenSpaceVertex->m_X;
+		case SO_CAMERA_FRUSTUM_RIGHT_PLANE:		return SO_FIXED_FROM_WHOLE( s_ScreenWidth  ) - a_ScreenSpaceVertex->m_X;
+		case SO_CAMERA_FRUSTUM_TOP_PLANE:		return a_ScreenSpaceVertex->m_Y;
+		case SO_CAMERA_FRUSTUM_BOTTOM_PLANE:	return SO_FIXED_FROM_WHOLE( s_ScreenHeight ) - a_ScreenSpaceVertex->m_Y;
+		
+		default:
+
+			// This shouldn't be reachable.
+			SO_ASSERT( false, "Illegal default switch case reached." );
+			
+			// For release builds;
+			return SO_FIXED_FROM_WHOLE( 1 );
+	}
+}
+// --------------------------------------------------------------------------------------
+
 // --------------------------------------------------------------------------------------
 /*!
 	\brief	Clips a textured \a s_CurrentPolygon against a single specific frustum plane.
@@ -1019,6 +2487,177 @@ void SoCameraClipSolidPolygonAgainstFrustumPlane( SoCamera* a_This, s32 a_WhichF
 }
 // --------------------------------------------------------------------------------------
 
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Clips \a s_CurrentPolygon against a single edge of the render target, in 2D.
+
+	\internal Only called from within \a SoCameraClipPolygon
+
+	\pre	All vertices of \a s_CurrentPolygon are projected, none are beyond the guard band.
+	
+	\post	\a The s_CurrentPolygon but now clipped against the given edge.
+
+	\param	a_WhichScreenEdge		One of the SO_CAMERA_FRUSTUM_LEFT, _RIGHT, _TOP and 
+									_BOTTOM _PLANE constants.
+
+	Works like \a SoCameraClipSolidPolygonAgainstFrustumPlane, but on the screen space
+	vertices. The new vertices are interpolated linearly on the screen, which is what
+	the affine rasterizers do with the texture coordinates anyway. The camera space
+	Z is interpolated too, for sorting, but the camera space X and Y are not.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraClipPolygonAgainstScreenEdge( s32 a_WhichScreenEdge )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Index of the start of the edge;
+	u32 a;
+
+	// Variables to hold vertex-to-screen-edge distances;
+	sofixedpoint distanceVertexA;
+	sofixedpoint distanceVertexB;
+
+	// Variables to swap;
+	u32			swpU32;
+	SoVector2*	swpVector2Pointer;
+	SoVector3*	swpVector3Pointer;
+
+	// Most polygons only cross one or two edges, so check if this one does;
+	for ( i = 0; i < s_CurrentPolygon.m_NumVertices; i++ )
+	{
+		if ( SoCameraDistanceToScreenEdge( &s_CurrentPolygon.m_ScreenSpaceVertices[ i ], a_WhichScreenEdge ) < 0 ) break;
+	}
+	if ( i == s_CurrentPolygon.m_NumVertices ) return;
+
+	// Reset the number of vertices in clipped polygon
+	s_CurrentPolygon.m_ClippedNumVertices = 0;
+
+	// Start with the edge from the last vertex to the first;
+	a				= s_CurrentPolygon.m_NumVertices - 1;
+	distanceVertexA = SoCameraDistanceToScreenEdge( &s_CurrentPolygon.m_ScreenSpaceVertices[ a ], a_WhichScreenEdge );
+
+	// Iterate over every edge;
+	for ( i = 0; i < s_CurrentPolygon.m_NumVertices; i++ )
+	{
+		distanceVertexB = SoCameraDistanceToScreenEdge( &s_CurrentPolygon.m_ScreenSpaceVertices[ i ], a_WhichScreenEdge );
+
+		// Does the edge cross the screen edge, always interpolate from the inside 
+		// vertex so both sides of a shared edge get the same vertex;
+		if ( distanceVertexA >= 0 && distanceVertexB < 0 )
+		{
+			SoCameraAddScreenEdgeIntersection( a, distanceVertexA, i, distanceVertexB, a_WhichScreenEdge );
+		}
+		else if ( distanceVertexA < 0 && distanceVertexB >= 0 )
+		{
+			SoCameraAddScreenEdgeIntersection( i, distanceVertexB, a, distanceVertexA, a_WhichScreenEdge );
+		}
+
+		// Add vertex B to the new polygon if it's on the screen side;
+		if ( distanceVertexB >= 0 )
+		{
+			s_CurrentPolygon.m_ClippedCameraSpaceVertices[ s_CurrentPolygon.m_ClippedNumVertices ] = s_CurrentPolygon.m_CameraSpaceVertices[ i ];
+			s_CurrentPolygon.m_ClippedScreenSpaceVertices[ s_CurrentPolygon.m_ClippedNumVertices ] = s_CurrentPolygon.m_ScreenSpaceVertices[ i ];
+
+			if ( s_CurrentPolygon.m_HasTexture )
+			{
+				s_CurrentPolygon.m_ClippedTextureCoordinates[ s_CurrentPolygon.m_ClippedNumVertices ] = s_CurrentPolygon.m_TextureCoordinates[ i ];
+			}
+
+			s_CurrentPolygon.m_ClippedNumVertices++;
+		}
+
+		// Go to the next edge;
+		distanceVertexA = distanceVertexB;
+		a				= i;
+	}
+
+	// Swap the number of vertices around;
+	swpU32								  = s_CurrentPolygon.m_NumVertices; 
+	s_CurrentPolygon.m_NumVertices		  = s_CurrentPolygon.m_ClippedNumVertices; 
+	s_CurrentPolygon.m_ClippedNumVertices = swpU32;
+
+	// Swap the polygon arrays around;
+	swpVector3Pointer							  = s_CurrentPolygon.m_CameraSpaceVertices;
+	s_CurrentPolygon.m_CameraSpaceVertices		  = s_CurrentPolygon.m_ClippedCameraSpaceVertices;
+	s_CurrentPolygon.m_ClippedCameraSpaceVertices = swpVector3Pointer;
+
+	swpVector2Pointer							  = s_CurrentPolygon.m_ScreenSpaceVertices;
+	s_CurrentPolygon.m_ScreenSpaceVertices		  = s_CurrentPolygon.m_ClippedScreenSpaceVertices;
+	s_CurrentPolygon.m_ClippedScreenSpaceVertices = swpVector2Pointer;
+
+	swpVector2Pointer							  = s_CurrentPolygon.m_TextureCoordinates;
+	s_CurrentPolygon.m_TextureCoordinates		  = s_CurrentPolygon.m_ClippedTextureCoordinates;
+	s_CurrentPolygon.m_ClippedTextureCoordinates  = swpVector2Pointer;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief	Adds the point where an edge of \a s_CurrentPolygon crosses a screen edge.
+
+	\internal Only called from within \a SoCameraClipPolygonAgainstScreenEdge
+
+	\param	a_Inside			Index of the vertex on the screen side.
+	\param	a_InsideDistance	Its distance to the screen edge, zero or positive.
+	\param	a_Outside			Index of the vertex on the other side.
+	\param	a_OutsideDistance	Its distance to the screen edge, negative.
+	\param	a_WhichScreenEdge	The screen edge.
+
+	The new vertex is put exactly on the screen edge, so rounding never puts it 
+	off the screen.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraAddScreenEdgeIntersection( u32 a_Inside, sofixedpoint a_InsideDistance,
+										u32 a_Outside, sofixedpoint a_OutsideDistance,
+										s32 a_WhichScreenEdge )
+{
+	SoVector2* inside  = &s_CurrentPolygon.m_ScreenSpaceVertices[ a_Inside  ];
+	SoVector2* outside = &s_CurrentPolygon.m_ScreenSpaceVertices[ a_Outside ];
+	SoVector2* clipped = &s_CurrentPolygon.m_ClippedScreenSpaceVertices[ s_CurrentPolygon.m_ClippedNumVertices ];
+
+	SoVector3* insideCamera	 = &s_CurrentPolygon.m_CameraSpaceVertices[ a_Inside  ];
+	SoVector3* outsideCamera = &s_CurrentPolygon.m_CameraSpaceVertices[ a_Outside ];
+	SoVector3* clippedCamera = &s_CurrentPolygon.m_ClippedCameraSpaceVertices[ s_CurrentPolygon.m_ClippedNumVertices ];
+
+	// Parametric t value of the clipped point. The distances are less than
+	// 512 pixels, so 6 bits fraction is enough and doesn't overflow the shift;
+	sofixedpoint t = SoMathDivide( (a_InsideDistance >> 10) << 16, 
+								   SO_MAX( (a_InsideDistance - a_OutsideDistance) >> 10, 1 ) );
+	t = SO_MIN( t, SO_FIXED_FROM_WHOLE( 1 ) );
+
+	// V = A + t * (vec(AtoB))
+	clipped->m_X = inside->m_X + SoMathFixedMultiply( outside->m_X - inside->m_X, t );
+	clipped->m_Y = inside->m_Y + SoMathFixedMultiply( outside->m_Y - inside->m_Y, t );
+
+	// Snap it to the edge;
+	switch ( a_WhichScreenEdge )
+	{
+		case SO_CAMERA_FRUSTUM_LEFT_PLANE:		clipped->m_X = 0;									break;
+		case SO_CAMERA_FRUSTUM_RIGHT_PLANE:		clipped->m_X = SO_FIXED_FROM_WHOLE( s_ScreenWidth  );	break;
+		case SO_CAMERA_FRUSTUM_TOP_PLANE:		clipped->m_Y = 0;									break;
+		case SO_CAMERA_FRUSTUM_BOTTOM_PLANE:	clipped->m_Y = SO_FIXED_FROM_WHOLE( s_ScreenHeight );	break;
+	}
+
+	// Only the depth is used after this, for sorting;
+	clippedCamera->m_X = insideCamera->m_X;
+	clippedCamera->m_Y = insideCamera->m_Y;
+	clippedCamera->m_Z = insideCamera->m_Z + SoMathFixedMultiply( outsideCamera->m_Z - insideCamera->m_Z, t );
+
+	if ( s_CurrentPolygon.m_HasTexture )
+	{
+		SoVector2* insideTexture  = &s_CurrentPolygon.m_TextureCoordinates[ a_Inside  ];
+		SoVector2* outsideTexture = &s_CurrentPolygon.m_TextureCoordinates[ a_Outside ];
+		SoVector2* clippedTexture = &s_CurrentPolygon.m_ClippedTextureCoordinates[ s_CurrentPolygon.m_ClippedNumVertices ];
+
+		clippedTexture->m_X = insideTexture->m_X + SoMathFixedMultiply( outsideTexture->m_X - insideTexture->m_X, t );
+		clippedTexture->m_Y = insideTexture->m_Y + SoMathFixedMultiply( outsideTexture->m_Y - insideTexture->m_Y, t );
+	}
+
+	s_CurrentPolygon.m_ClippedNumVertices++;
+}
+// --------------------------------------------------------------------------------------
+
 // --------------------------------------------------------------------------------------
 /*!
 	\brief Cameraspace vertex projector that can handle vertices outside the frustum.
@@ -1030,36 +2669,76 @@ void SoCameraClipSolidPolygonAgainstFrustumPlane( SoCamera* a_This, s32 a_WhichF
 	
 	\retval	a_ScreenSpaceCoordinate		Transformed vertex
 
+	\return	One of the SO_CAMERA_VERTEX_ * constants.
+
 	If the vertex cannot be projected because it is outside of the frustum a negative
 	value is loaded in the X component. Since a negative X means it's offscreen we can use
 	this to tell that this vertex couldn't be projected on screen.
 	
 	We use the SO_CAMERA_FRUSTUM_ * _PLANE constants for this so we can identify 
 	which plane it was clipped by first. That's why these constants have to be negative.
+
+	If the current mesh is clipped with a guard band (see \a s_GuardBandClipping), 
+	vertices off the screen but in the guard band are projected too. Their X can be 
+	negative as well, so use the returned constant to tell them apart. Vertices beyond
+	the guard band are found in camera space, because projecting them could overflow.
 */
 // --------------------------------------------------------------------------------------
-void SoCameraSafeProject( SoCamera*	a_This, 
-						  SoVector3* a_CameraSpaceCoordinate, 
-						  SoVector2* a_ScreenSpaceCoordinate )
+u32 SoCameraSafeProject( SoCamera*	a_This, 
+						 SoVector3* a_CameraSpaceCoordinate, 
+						 SoVector2* a_ScreenSpaceCoordinate )
 {
+	// Whole Z, for comparing to the guard band;
+	s32 z = SO_FIXED_TO_WHOLE( a_CameraSpaceCoordinate->m_Z );
+
 	// Is Z too near;
-	if ( SO_FIXED_TO_WHOLE( a_CameraSpaceCoordinate->m_Z ) < a_This->m_NearPlaneDistance )
+	if ( z < a_This->m_NearPlaneDistance )
 	{
 		// Set negative X;
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_NEAR_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
 	}
 
 	// Is Z too far;
-	if ( SO_FIXED_TO_WHOLE( a_CameraSpaceCoordinate->m_Z ) > a_This->m_FarPlaneDistance )
+	if ( z > a_This->m_FarPlaneDistance )
 	{
 		// Set negative X;
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_FAR_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
+	}
+
+	if ( s_GuardBandClipping )
+	{
+		// Is it beyond the guard band. The whole Z is a little low, so this 
+		// errs on the safe side;
+		if ( SO_ABS( a_CameraSpaceCoordinate->m_X ) > z * a_This->m_GuardBandSlopeX )
+		{
+			a_ScreenSpaceCoordinate->m_X = a_CameraSpaceCoordinate->m_X < 0 ? SO_CAMERA_FRUSTUM_LEFT_PLANE : 
+																			  SO_CAMERA_FRUSTUM_RIGHT_PLANE;
+			return SO_CAMERA_VERTEX_OUTSIDE;
+		}
+		if ( SO_ABS( a_CameraSpaceCoordinate->m_Y ) > z * a_This->m_GuardBandSlopeY )
+		{
+			a_ScreenSpaceCoordinate->m_X = a_CameraSpaceCoordinate->m_Y > 0 ? SO_CAMERA_FRUSTUM_TOP_PLANE : 
+																			  SO_CAMERA_FRUSTUM_BOTTOM_PLANE;
+			return SO_CAMERA_VERTEX_OUTSIDE;
+		}
+
+		// Perform the project;
+		SoCameraGuardBandProject( a_This, a_CameraSpaceCoordinate, a_ScreenSpaceCoordinate );
+
+		// Is it on the screen;
+		if ( a_ScreenSpaceCoordinate->m_X < 0 || a_ScreenSpaceCoordinate->m_X > SO_FIXED_FROM_WHOLE( s_ScreenWidth  ) ||
+			 a_ScreenSpaceCoordinate->m_Y < 0 || a_ScreenSpaceCoordinate->m_Y > SO_FIXED_FROM_WHOLE( s_ScreenHeight ) )
+		{
+			return SO_CAMERA_VERTEX_IN_GUARD_BAND;
+		}
+
+		return SO_CAMERA_VERTEX_ON_SCREEN;
 	}
 
 	// Perform the project;
@@ -1072,7 +2751,7 @@ void SoCameraSafeProject( SoCamera*	a_This,
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_LEFT_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
 	}
 	if ( a_ScreenSpaceCoordinate->m_Y < 0 )
 	{
@@ -1080,24 +2759,26 @@ void SoCameraSafeProject( SoCamera*	a_This,
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_TOP_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
 	}
-	if ( a_ScreenSpaceCoordinate->m_X > SO_FIXED_FROM_WHOLE( SO_SCREEN_WIDTH  ) )
+	if ( a_ScreenSpaceCoordinate->m_X > SO_FIXED_FROM_WHOLE( s_ScreenWidth  ) )
 	{
 		// Set negative X;
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_RIGHT_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
 	}
-	if ( a_ScreenSpaceCoordinate->m_Y > SO_FIXED_FROM_WHOLE( SO_SCREEN_HEIGHT ) )
+	if ( a_ScreenSpaceCoordinate->m_Y > SO_FIXED_FROM_WHOLE( s_ScreenHeight ) )
 	{
 		// Set negative X;
 		a_ScreenSpaceCoordinate->m_X = SO_CAMERA_FRUSTUM_BOTTOM_PLANE;
 
 		// Done;
-		return;
+		return SO_CAMERA_VERTEX_OUTSIDE;
 	}
+
+	return SO_CAMERA_VERTEX_ON_SCREEN;
 }
 // --------------------------------------------------------------------------------------
 
@@ -1129,16 +2810,57 @@ void SoCameraProject( SoCamera*	a_This,
 
 	// Calculate the projectionPlaneDistance / Z;
 	ooZ = SO_FIXED_ONE_OVER_SLOW_ACCURATE( a_CameraSpaceCoordinate->m_Z );
-	ooZ *= a_This->m_ProjectionPlaneDistance;
 
-	// Project from cameraspace to screenspace;
+	// Project from cameraspace to screenspace, scaled to the render target;
+	// The Y value is negated because Y is upside down on the screen;
+	a_ScreenSpaceCoordinate->m_X =  SO_FIXED_MULTIPLY_BIG_SMALL( a_CameraSpaceCoordinate->m_X, 
+										(ooZ * a_This->m_ProjectionPlaneDistanceX * s_ProjectionScaleX) >> 8 );
+	a_ScreenSpaceCoordinate->m_Y = -SO_FIXED_MULTIPLY_BIG_SMALL( a_CameraSpaceCoordinate->m_Y, 
+										(ooZ * a_This->m_ProjectionPlaneDistanceY * s_ProjectionScaleY) >> 8 );
+
+	// Convert to center of screen;
+	a_ScreenSpaceCoordinate->m_X += SO_FIXED_FROM_WHOLE( s_ScreenWidth  ) >> 1;
+	a_ScreenSpaceCoordinate->m_Y += SO_FIXED_FROM_WHOLE( s_ScreenHeight ) >> 1;
+}
+// --------------------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------------------
+/*!
+	\brief Projects a vertex in the guard band from cameraspace to screenspace.
+
+	\internal
+
+	\param	a_This						This pointer
+	\param	a_CameraSpaceCoordinate		Vertex in camera space
+	
+	\retval	a_ScreenSpaceCoordinate		Transformed vertex
+
+	Same as \a SoCameraProject, but with two bits less precision in the multiply.
+	That one overflows at 128 pixels from the center of the screen, this one at 512.
+	So use it for vertices that can be up to \a SO_CAMERA_GUARD_BAND_SIZE pixels off 
+	the screen.
+*/
+// --------------------------------------------------------------------------------------
+void SoCameraGuardBandProject( SoCamera*  a_This, 
+							   SoVector3* a_CameraSpaceCoordinate, 
+							   SoVector2* a_ScreenSpaceCoordinate )
+{
+	// Value to hold the one-over-Z multiplier;
+	sofixedpoint ooZ;
+
+	// Calculate the projectionPlaneDistance / Z;
+	ooZ = SO_FIXED_ONE_OVER_SLOW_ACCURATE( a_CameraSpaceCoordinate->m_Z );
+
+	// Project from cameraspace to screenspace, scaled to the render target;
 	// The Y value is negated because Y is upside down on the screen;
-	a_ScreenSpaceCoordinate->m_X =  SO_FIXED_MULTIPLY_BIG_SMALL( a_CameraSpaceCoordinate->m_X, ooZ );
-	a_ScreenSpaceCoordinate->m_Y = -SO_FIXED_MULTIPLY_BIG_SMALL( a_CameraSpaceCoordinate->m_Y, ooZ );
+	a_ScreenSpaceCoordinate->m_X =  ( (a_CameraSpaceCoordinate->m_X >> 6) * 
+									  (((ooZ * a_This->m_ProjectionPlaneDistanceX * s_ProjectionScaleX) >> 8) >> 4) ) >> 6;
+	a_ScreenSpaceCoordinate->m_Y = -(( (a_CameraSpaceCoordinate->m_Y >> 6) * 
+									   (((ooZ * a_This->m_ProjectionPlaneDistanceY * s_ProjectionScaleY) >> 8) >> 4) ) >> 6);
 
 	// Convert to center of screen;
-	a_ScreenSpaceCoordinate->m_X += SO_FIXED_FROM_WHOLE( SO_SCREEN_HALF_WIDTH  );
-	a_ScreenSpaceCoordinate->m_Y += SO_FIXED_FROM_WHOLE( SO_SCREEN_HALF_HEIGHT );
+	a_ScreenSpaceCoordinate->m_X += SO_FIXED_FROM_WHOLE( s_ScreenWidth  ) >> 1;
+	a_ScreenSpaceCoordinate->m_Y += SO_FIXED_FROM_WHOLE( s_ScreenHeight ) >> 1;
 }
 // --------------------------------------------------------------------------------------
 
@@ -144,14 +144,14 @@ void SoDisplayWaitForVBlankEnd( void )
 //! \param	a_Mode	the mode to be set
 //!
 //! This routine changes the current display mode.  Currently only supports modes
-//! 0 (text BG mode) and 4 (bitmap mode)
+//! 0 (text BG mode) and 3, 4 and 5 (bitmap modes)
 //!
 void SoDisplaySetMode(u32 a_Mode)
 {
 	u16 dispcnt;
 
 	// validate argument
-	SO_ASSERT(a_Mode == 0 || a_Mode == 4, "Bad or unsupported graphics mode");
+	SO_ASSERT(a_Mode == 0 || a_Mode == 3 || a_Mode == 4 || a_Mode == 5, "Bad or unsupported graphics mode");
 
 	SoEffectsSetMode(SO_EFFECTS_MODE_NONE, SO_EFFECTS_TARGET2_ALL, SO_EFFECTS_TARGET2_ALL);
 
@@ -163,13 +163,15 @@ void SoDisplaySetMode(u32 a_Mode)
 		dispcnt |= DISPCNT_MODE(a_Mode);
 		SO_REG_DISP_CNT = dispcnt;
 		break;
+	case 3:
 	case 4:
+	case 5:
 		dispcnt = SO_REG_DISP_CNT;
 		// Clear any previous display mode, reset the backbuffer selection bit, and 
 		// enable the LCD screen.
 		dispcnt &= ~( DISPCNT_MODE_MASK | DISPCNT_BACKBUFFER | DISPCNT_FORCE_BLANK | DISPCNT_BG0_ENABLE | DISPCNT_BG1_ENABLE | DISPCNT_BG3_ENABLE);
-		// Enable background 2 and mode 4;
-		dispcnt |= DISPCNT_MODE(4) | DISPCNT_BG2_ENABLE;
+		// Enable background 2 and the bitmap mode;
+		dispcnt |= DISPCNT_MODE(a_Mode) | DISPCNT_BG2_ENABLE;
 		SO_REG_DISP_CNT = dispcnt;
 		SoBkgSetPriority(2, 3);
 	}
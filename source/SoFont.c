@@ -17,6 +17,8 @@
 // ----------------------------------------------------------------------------
 
 #include "SoFont.h"
+#include "SoMath.h"
+#include "SoDebug.h"
 
 //! Data array generated by an SGADE tool
 static const u16 defaultFontImageData[ 3008 ] = { 
@@ -793,6 +795,334 @@ const SoImage* SoFontGetDefaultFontImage()
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Initializes a proportional font.
+
+	\param	a_This			This pointer
+	\param	a_Image			Palettized image with all the glyphs in it, on one row.
+							It has to stay around as long as \a a_This is used.
+	\param	a_GlyphX			\a SO_FONT_NUM_GLYPHS leftmost columns, one for every glyph.
+	\param	a_GlyphWidths	\a SO_FONT_NUM_GLYPHS widths, at least 1, one for every glyph.
+	\param	a_Spacing		Number of pixels in between two glyphs.
+	\param	a_SpaceWidth		Number of pixels of a space, or any other character 
+							without a glyph.
+
+	The first glyph is the one of \a SO_FONT_FIRST_CHAR. The tables are copied, 
+	so they don't have to stay around. Glyphs are drawn opaque, so palette index 0 
+	is their background color. There's no kerning until \a SoFontSetKerningPairs 
+	is called, and the font can't be drawn until \a SoFontCache is called.
+*/
+// ----------------------------------------------------------------------------
+void SoFontInitialize( SoFont* a_This, const SoImage* a_Image, const u16* a_GlyphX, 
+					   const u8* a_GlyphWidths, u32 a_Spacing, u32 a_SpaceWidth )
+{
+	u32 i;
+
+	SO_ASSERT( SoImageIsPalettized( a_Image ), "Font image must be palettized." );
+	SO_ASSERT( a_Spacing < 256 && a_SpaceWidth < 256, "Spacing too wide." );
+
+	a_This->m_Image			  = a_Image;
+	a_This->m_Spacing		  = a_Spacing;
+	a_This->m_SpaceWidth	  = a_SpaceWidth;
+	a_This->m_KerningPairs	  = NULL;
+	a_This->m_NumKerningPairs = 0;
+	a_This->m_Cache			  = NULL;
+
+	for ( i = 0; i < SO_FONT_NUM_GLYPHS; i++ )
+	{
+		SO_ASSERT( a_GlyphWidths[ i ] > 0, "Glyphs are at least one pixel wide." );
+		SO_ASSERT( a_GlyphX[ i ] + a_GlyphWidths[ i ] <= SoImageGetWidth( a_Image ), 
+				   "Glyph lies outside the image." );
+
+		a_This->m_GlyphX[ i ]	   = a_GlyphX[ i ];
+		a_This->m_GlyphWidths[ i ] = a_GlyphWidths[ i ];
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Initializes a proportional font from a fixed width font image.
+
+	\param	a_This		This pointer
+	\param	a_Image		Palettized image with all the glyphs next to each other,
+						like \a SoFontGetDefaultFontImage. It has to stay around 
+						as long as \a a_This is used.
+	\param	a_Spacing	Number of pixels in between two glyphs.
+
+	The empty columns (palette index 0) on the left and right of every glyph 
+	are left out. Glyphs without any pixels, and spaces, become half a 
+	character wide.
+*/
+// ----------------------------------------------------------------------------
+void SoFontInitializeFromFixedWidthImage( SoFont* a_This, const SoImage* a_Image, u32 a_Spacing )
+{
+	u16 glyphX[ SO_FONT_NUM_GLYPHS ];
+	u8	glyphWidths[ SO_FONT_NUM_GLYPHS ];
+
+	u32 width	  = SoImageGetWidth(  a_Image );
+	u32 height	  = SoImageGetHeight( a_Image );
+	u32 cellWidth = width / SO_FONT_NUM_GLYPHS;
+	u32 i, x, y;
+	s32 left, right;
+
+	const u8* pixels = (const u8*) SoImageGetData( a_Image );
+
+	SO_ASSERT( cellWidth > 0 && cellWidth < 256, "Font image has the wrong width." );
+
+	for ( i = 0; i < SO_FONT_NUM_GLYPHS; i++ )
+	{
+		// Find the leftmost and rightmost columns with pixels;
+		left  = cellWidth;
+		right = -1;
+
+		for ( x = 0; x < cellWidth; x++ )
+		{
+			for ( y = 0; y < height; y++ )
+			{
+				if ( pixels[ width * y + cellWidth * i + x ] )
+				{
+					if ( (s32) x < left  ) left  = x;
+					if ( (s32) x > right ) right = x;
+				}
+			}
+		}
+
+		if ( right < left )
+		{
+			left  = 0;
+			right = SO_MAX( cellWidth >> 1, 1 ) - 1;
+		}
+
+		glyphX[ i ]		 = cellWidth * i + left;
+		glyphWidths[ i ] = right - left + 1;
+	}
+
+	SoFontInitialize( a_This, a_Image, glyphX, glyphWidths, a_Spacing, SO_MAX( cellWidth >> 1, 1 ) );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the kerning pairs of a proportional font.
+
+	\param	a_This		This pointer
+	\param	a_Pairs		Kerning pairs sorted on their first, and then on their second
+						character. They have to stay around as long as \a a_This is used.
+						Pass \a NULL for no kerning.
+	\param	a_NumPairs	Number of pairs.
+
+	The adjustment of a pair is added to the spacing in between the two characters,
+	but glyphs never overlap, so at most the spacing can be taken away.
+*/
+// ----------------------------------------------------------------------------
+void SoFontSetKerningPairs( SoFont* a_This, const SoFontKerningPair* a_Pairs, u32 a_NumPairs )
+{
+	a_This->m_KerningPairs	  = a_Pairs;
+	a_This->m_NumKerningPairs = a_Pairs ? a_NumPairs : 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the width of the glyph of a character, or of a space if it has none.
+
+	\param	a_This		This pointer
+	\param	a_Character	Character.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFontGetGlyphWidth( const SoFont* a_This, char a_Character )
+{
+	if ( ! SoFontIsDrawable( a_Character ) ) return a_This->m_SpaceWidth;
+
+	return a_This->m_GlyphWidths[ a_Character - SO_FONT_FIRST_CHAR ];
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the kerning adjustment of a pair of characters.
+
+	\param	a_This		This pointer
+	\param	a_First		Character on the left.
+	\param	a_Second	Character on the right.
+
+	Zero if the pair has no kerning. Does a binary search of the kerning pairs.
+*/
+// ----------------------------------------------------------------------------
+s32 SoFontGetKerning( const SoFont* a_This, char a_First, char a_Second )
+{
+	u32 key = ((u8) a_First << 8) | (u8) a_Second;
+	u32 pairKey;
+	u32 low	 = 0;
+	u32 high = a_This->m_NumKerningPairs;
+	u32 middle;
+
+	while ( low < high )
+	{
+		middle	= (low + high) >> 1;
+		pairKey = ((u8) a_This->m_KerningPairs[ middle ].m_First << 8) | 
+				  (u8) a_This->m_KerningPairs[ middle ].m_Second;
+
+		if ( pairKey == key ) return a_This->m_KerningPairs[ middle ].m_Adjust;
+
+		if ( pairKey < key ) low = middle + 1; else high = middle;
+	}
+
+	return 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of pixels from a character to the next one.
+
+	\param	a_This		This pointer
+	\param	a_Character	Character.
+	\param	a_Next		Character after it, or 0 if there is none.
+
+	That's the width of the glyph plus the spacing, with the kerning of the pair 
+	added if both have glyphs. Never less than the width of the glyph. For a 
+	character without a glyph it's the width of a space.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFontGetAdvance( const SoFont* a_This, char a_Character, char a_Next )
+{
+	s32 width;
+	s32 spacing;
+
+	if ( ! SoFontIsDrawable( a_Character ) ) return a_This->m_SpaceWidth;
+
+	width	= a_This->m_GlyphWidths[ a_Character - SO_FONT_FIRST_CHAR ];
+	spacing = a_This->m_Spacing;
+
+	if ( a_This->m_NumKerningPairs && SoFontIsDrawable( a_Next ) )
+	{
+		spacing += SoFontGetKerning( a_This, a_Character, a_Next );
+		if ( spacing < 0 ) spacing = 0;
+	}
+
+	return width + spacing;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the width of a string in pixels.
+
+	\param	a_This		This pointer
+	\param	a_String	String, only its first line is measured.
+
+	From the left of the string to the right of its last glyph, so the spacing 
+	after the last glyph and any trailing spaces don't count.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFontGetStringWidth( const SoFont* a_This, const char* a_String )
+{
+	u32 x	  = 0;
+	u32 width = 0;
+
+	for ( ; *a_String != '\0' && *a_String != '\n'; a_String++ )
+	{
+		if ( SoFontIsDrawable( *a_String ) ) width = x + a_This->m_GlyphWidths[ *a_String - SO_FONT_FIRST_CHAR ];
+
+		x += SoFontGetAdvance( a_This, a_String[ 0 ], a_String[ 1 ] );
+	}
+
+	return width;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of bytes \a SoFontCache needs.
+
+	\param	a_This		This pointer
+
+	Always a multiple of 4. About twice the size of the glyphs, plus 
+	4 bytes per glyph.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFontGetCacheSize( const SoFont* a_This )
+{
+	u32 i, width;
+
+	// The offset table;
+	u32 size = SO_FONT_NUM_GLYPHS * 2;
+
+	// Both versions of every glyph;
+	for ( i = 0; i < SO_FONT_NUM_GLYPHS; i++ )
+	{
+		width = a_This->m_GlyphWidths[ i ];
+		size += SoFontGetHeight( a_This ) * ( ((width + 1) >> 1) + ((width + 2) >> 1) );
+	}
+
+	return ((size << 1) + 3) & ~3;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Converts the glyphs to mode 4 pixel pairs, so the font can be drawn.
+
+	\param	a_This		This pointer
+	\param	a_Buffer	Memory on a 32 bit boundary, of \a SoFontGetCacheSize bytes. 
+						It has to stay around as long as \a a_This is used. EWRAM
+						is fine, IWRAM is faster.
+
+	Mode 4 pixels are written two at a time, so a glyph at an odd X shares its
+	first pixel pair with whatever is left of it. That's why every glyph is stored 
+	twice here, as rows of pixel pairs: once starting at an even X, and once
+	starting at an odd X (shifted right by one pixel). Pixels in a pair that 
+	don't belong to the glyph are zero. \a SoMode4RendererDrawText picks the 
+	version for the X it draws a glyph at, and just ORs in the pixel that is left 
+	over from the glyph before it, so it only reads the screen at the ends of a line.
+
+	The cache starts with a table of two 16 bit offsets per glyph, for the even 
+	and the odd version, in halfwords from the start of the cache.
+*/
+// ----------------------------------------------------------------------------
+void SoFontCache( SoFont* a_This, void* a_Buffer )
+{
+	u16*	  cache		= (u16*) a_Buffer;
+	u16*	  pair		= cache + SO_FONT_NUM_GLYPHS * 2;
+	const u8* pixels	= (const u8*) SoImageGetData( a_This->m_Image );
+	u32		  width		= SoImageGetWidth( a_This->m_Image );
+	u32		  height	= SoFontGetHeight( a_This );
+	u32		  i, odd, y;
+	s32		  glyphWidth, x;
+	const u8* row;
+
+	SO_ASSERT( ((u32) a_Buffer & 3) == 0, "Cache should be on a 32 bit boundary." );
+	SO_ASSERT( SoFontGetCacheSize( a_This ) < (1 << 17), "Font is too big to cache." );
+
+	for ( i = 0; i < SO_FONT_NUM_GLYPHS; i++ )
+	{
+		glyphWidth = a_This->m_GlyphWidths[ i ];
+
+		for ( odd = 0; odd < 2; odd++ )
+		{
+			cache[ (i << 1) + odd ] = pair - cache;
+
+			for ( y = 0; y < height; y++ )
+			{
+				row = pixels + width * y + a_This->m_GlyphX[ i ];
+
+				// Pixel x of the glyph goes in pixel x + odd of the row;
+				for ( x = -(s32) odd; x < glyphWidth; x += 2 )
+				{
+					*pair++ = ( x	  >= 0		   ? row[ x	 ]		: 0 ) | 
+							  ( x + 1 < glyphWidth ? row[ x + 1 ] << 8 : 0 );
+				}
+			}
+		}
+	}
+
+	a_This->m_Cache = cache;
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 // EOF
 // ----------------------------------------------------------------------------
@@ -0,0 +1,272 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoFramePacer.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoFramePacer
+
+	See the \a SoFramePacer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoFramePacer.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Function forwards
+// ----------------------------------------------------------------------------
+void SoFramePacerVBlankHandler( void );
+
+// ----------------------------------------------------------------------------
+// Variables
+// ----------------------------------------------------------------------------
+
+//! \internal Renderer that is flipped, \a NULL if the pacer is disabled.
+static const SoRenderer* s_Renderer = NULL;
+
+//! \internal Target frame time, in VBlanks.
+static u32 s_VBlanksPerFrame = SO_FRAME_PACER_60_HZ;
+
+//! \internal Called every VBlank after the flip, see \a SoFramePacerSetVBlankHandler.
+static SoInterruptHandler s_VBlankHandler = NULL;
+
+// These are changed by the VBlank interrupt;
+
+static volatile u32	 s_VBlankCount		= 0;		//!< \internal Number of VBlanks since the pacer was enabled.
+static volatile u32	 s_LastFlipVBlank	= 0;		//!< \internal VBlank count at the last flip.
+static volatile u32	 s_FrameVBlanks		= 0;		//!< \internal VBlanks in between the last two flips.
+static volatile u32	 s_PendingVBlanks	= 0;		//!< \internal VBlanks not yet handed out as steps.
+static volatile bool s_FrameReady		= false;	//!< \internal True when a finished frame waits for its flip.
+
+// ----------------------------------------------------------------------------
+// Function implementations
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Starts pacing the frames of a renderer.
+
+	\param	a_Renderer			Renderer to flip, like \a g_SoMode4Renderer.
+	\param	a_VBlanksPerFrame	One of the \a SO_FRAME_PACER_60_HZ, \a SO_FRAME_PACER_30_HZ
+								and \a SO_FRAME_PACER_20_HZ constants.
+
+	Initializes the \a SoIntManager if that wasn't done yet, installs the VBlank
+	interrupt handler and enables the VBlank interrupt and the interrupt master.
+	Don't install another VBlank handler while the pacer is enabled, use
+	\a SoFramePacerSetVBlankHandler instead.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerEnable( const SoRenderer* a_Renderer, u32 a_VBlanksPerFrame )
+{
+	SO_ASSERT( a_Renderer != NULL, "Renderer can't be NULL." );
+
+	SoFramePacerSetVBlanksPerFrame( a_VBlanksPerFrame );
+
+	SoIntManagerInitialize();
+	SoIntManagerDisableInterrupt( SO_INTERRUPT_TYPE_VBLANK );
+
+	// Start counting from here;
+	s_Renderer		 = a_Renderer;
+	s_VBlankCount	 = 0;
+	s_LastFlipVBlank = 0;
+	s_FrameVBlanks	 = 0;
+	s_PendingVBlanks = 0;
+	s_FrameReady	 = false;
+
+	SoIntManagerSetInterruptHandler( SO_INTERRUPT_TYPE_VBLANK, SoFramePacerVBlankHandler );
+	SoIntManagerEnableInterrupt( SO_INTERRUPT_TYPE_VBLANK );
+	SoIntManagerEnableInterruptMaster();
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Stops pacing frames.
+
+	Disables the VBlank interrupt and removes the handler. Flip by hand again
+	after this.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerDisable( void )
+{
+	SoIntManagerDisableInterrupt( SO_INTERRUPT_TYPE_VBLANK );
+	SoIntManagerSetInterruptHandler( SO_INTERRUPT_TYPE_VBLANK, NULL );
+
+	s_Renderer	 = NULL;
+	s_FrameReady = false;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the target frame time.
+
+	\param	a_VBlanksPerFrame	One of the \a SO_FRAME_PACER_60_HZ, \a SO_FRAME_PACER_30_HZ
+								and \a SO_FRAME_PACER_20_HZ constants, or any
+								other number of VBlanks, at least 1.
+
+	Frames are never flipped sooner than this after the previous flip. This is
+	also the time one step of \a SoFramePacerGetNumSteps stands for.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerSetVBlanksPerFrame( u32 a_VBlanksPerFrame )
+{
+	SO_ASSERT( a_VBlanksPerFrame >= 1, "A frame takes at least one VBlank." );
+
+	s_VBlanksPerFrame = a_VBlanksPerFrame;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the target frame time, in VBlanks.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFramePacerGetVBlanksPerFrame( void )
+{
+	return s_VBlanksPerFrame;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets a function that is called in every VBlank.
+
+	\param	a_Handler	Function, or \a NULL for none.
+
+	The pacer owns the VBlank interrupt, so install things that need to be done
+	in every VBlank (like copying sprite attributes) here. It is called from
+	within the interrupt, after the flip if there was one.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerSetVBlankHandler( SoInterruptHandler a_Handler )
+{
+	s_VBlankHandler = a_Handler;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Hands the finished frame to the pacer, and waits until it is shown.
+
+	Call this when you are done rendering into the backbuffer. The frame is
+	flipped in the first VBlank at least \a SoFramePacerGetVBlanksPerFrame
+	VBlanks after the previous flip. The CPU is halted until then, so the
+	backbuffer is free to render the next frame in when this returns.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerEndFrame( void )
+{
+	SO_ASSERT( s_Renderer != NULL, "Call SoFramePacerEnable first." );
+
+	s_FrameReady = true;
+
+	// Halt until the next interrupt, until the VBlank handler has flipped. This
+	// file is compiled as thumb code, so use the thumb SWI number;
+	while ( s_FrameReady )
+	{
+		asm volatile( "swi 0x02" ::: "r0", "r1", "r2", "r3" );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns how many fixed simulation steps to do before rendering again.
+
+	One step stands for \a SoFramePacerGetVBlanksPerFrame VBlanks. This is the
+	number of whole steps that passed between the flips since the last call,
+	at most \a SO_FRAME_PACER_MAX_NUM_STEPS. The VBlanks that don't make a whole
+	step are kept for the next call.
+
+	So when every frame makes its target, this returns 1 every time. When a
+	frame runs late, the next call returns more steps, and the frames in
+	between are skipped. When the target is changed in between, it can return 0.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFramePacerGetNumSteps( void )
+{
+	u32 steps	= 0;
+	u32 pending = s_PendingVBlanks;
+
+	// Only a handful of iterations, unless we're dropping time;
+	while ( pending >= s_VBlanksPerFrame )
+	{
+		pending -= s_VBlanksPerFrame;
+
+		if ( steps < SO_FRAME_PACER_MAX_NUM_STEPS ) steps++;
+	}
+
+	// Flips only happen in SoFramePacerEndFrame, so nothing changed in between;
+	s_PendingVBlanks = pending;
+
+	return steps;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of VBlanks in between the last two flips.
+
+	That's how long the last frame was shown, and how long it took to make the
+	current one. At least \a SoFramePacerGetVBlanksPerFrame, and more if the
+	frame didn't make its target. Zero before the first flip.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFramePacerGetFrameVBlanks( void )
+{
+	return s_FrameVBlanks;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of VBlanks since \a SoFramePacerEnable.
+
+	Wraps around after about two years.
+*/
+// ----------------------------------------------------------------------------
+u32 SoFramePacerGetVBlankCount( void )
+{
+	return s_VBlankCount;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	The VBlank interrupt handler.
+
+	\internal
+
+	Counts the VBlank, and flips if a frame is ready and its target time has passed.
+*/
+// ----------------------------------------------------------------------------
+void SoFramePacerVBlankHandler( void )
+{
+	u32 count = s_VBlankCount + 1;
+
+	s_VBlankCount = count;
+
+	if ( s_FrameReady && count - s_LastFlipVBlank >= s_VBlanksPerFrame )
+	{
+		s_Renderer->m_Flip();
+
+		s_FrameVBlanks	  = count - s_LastFlipVBlank;
+		s_PendingVBlanks += s_FrameVBlanks;
+		s_LastFlipVBlank  = count;
+		s_FrameReady	  = false;
+	}
+
+	if ( s_VBlankHandler ) s_VBlankHandler();
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
@@ -104,6 +104,37 @@ void SoImageBkgLoad( const SoImage* a_This, u32 a_CharBase, u32 a_BaseIdx )
 		SoImageGetWidth( a_This ), SoImageGetHeight( a_This ) );
 }
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the data of the given mipmap level.
+
+	\param	a_This	This pointer
+	\param	a_Level	Mipmap level, 0 is the full size image.
+
+	See the \a SoImage module for the layout of the mipmap chain.
+*/
+// ----------------------------------------------------------------------------
+u16* SoImageGetMipLevelData( const SoImage* a_This, u32 a_Level )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Data of the current level;
+	u8* data = (u8*) SoImageGetData( a_This );
+
+	SO_ASSERT( SoImageIsPalettized( a_This ), "Only palettized images can have mipmaps." );
+	SO_ASSERT( a_Level < SoImageGetNumMipLevels( a_This ), "Image doesn't have this mipmap level." );
+
+	// Skip the levels before it;
+	for ( i = 0; i < a_Level; i++ )
+	{
+		data += SoImageGetMipLevelWidth( a_This, i ) * SoImageGetMipLevelHeight( a_This, i );
+	}
+
+	return (u16*) data;
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 // EOF
 // ----------------------------------------------------------------------------
@@ -159,6 +159,196 @@ void SoMeshSetTexture( SoMesh* a_This, SoImage* a_Texture )
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Turns perspective correct texture mapping on or off for this mesh.
+	
+	\param	a_This			This pointer
+	\param	a_SpanLength	Number of pixels between two perspective divides. This must be 
+							a power of two between 2 and 64. Use 0 to go back to the default 
+							affine texture mapping.
+
+	With perspective correction on, the rasterizer does a real divide at every 
+	\a a_SpanLength pixels of a scanline and interpolates affinely in between. Use 8
+	or 16 for large polygons close to the camera (floors and walls), and leave it off
+	for small or distant meshes, where the warping isn't visible anyway.
+*/
+// ----------------------------------------------------------------------------
+void SoMeshSetPerspectiveSpanLength( SoMesh* a_This, u32 a_SpanLength ) 
+{ 
+	SO_ASSERT( (a_SpanLength & (a_SpanLength - 1)) == 0, "Span length should be a power of two." );
+	SO_ASSERT( a_SpanLength != 1 && a_SpanLength <= 64, "Span length should be between 2 and 64." );
+
+	a_This->m_PerspectiveSpanLength = a_SpanLength; 
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the number of pixels between two perspective divides.
+	
+	\param	a_This		This pointer
+
+	\return Zero if the mesh is texture mapped affinely.
+*/
+// ----------------------------------------------------------------------------
+u32 SoMeshGetPerspectiveSpanLength( SoMesh* a_This ) 
+{ 
+	return a_This->m_PerspectiveSpanLength; 
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Calculates a sphere around all the vertices of the mesh.
+
+	\param	a_This		This pointer
+
+	Call this once after the vertices are set up, and again if you change them. 
+	A camera tests the sphere against its frustum before it transforms the 
+	vertices. Meshes that are entirely outside are skipped, and meshes that are
+	entirely inside are drawn without any clipping tests (see \a SoCameraDrawMesh).
+	Meshes of which this was never called have no bounding sphere, and are always 
+	transformed.
+
+	The center is the middle of the bounding box of the vertices, and the radius is 
+	the distance to the vertex farthest away from it, rounded up. Squares are 
+	taken of scaled down distances, so large meshes don't overflow.
+*/
+// ----------------------------------------------------------------------------
+void SoMeshCalculateBoundingSphere( SoMesh* a_This )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Bounding box of the vertices;
+	SoVector3 minimum, maximum;
+
+	// Distance from the center to a vertex, and its square;
+	SoVector3		offset;
+	sofixedpoint	squaredDistance;
+	sofixedpoint	maximumSquaredDistance = 0;
+	sofixedpoint	maximumOffset		   = 0;
+	u32				shift				   = 0;
+
+	SO_ASSERT( a_This->m_NumVertices > 0, "Mesh has no vertices." );
+
+	// Find the bounding box;
+	minimum = maximum = a_This->m_Vertices[ 0 ];
+
+	for ( i = 1; i < a_This->m_NumVertices; i++ )
+	{
+		minimum.m_X = SO_MIN( minimum.m_X, a_This->m_Vertices[ i ].m_X );
+		minimum.m_Y = SO_MIN( minimum.m_Y, a_This->m_Vertices[ i ].m_Y );
+		minimum.m_Z = SO_MIN( minimum.m_Z, a_This->m_Vertices[ i ].m_Z );
+		maximum.m_X = SO_MAX( maximum.m_X, a_This->m_Vertices[ i ].m_X );
+		maximum.m_Y = SO_MAX( maximum.m_Y, a_This->m_Vertices[ i ].m_Y );
+		maximum.m_Z = SO_MAX( maximum.m_Z, a_This->m_Vertices[ i ].m_Z );
+	}
+
+	// Its middle is the center;
+	a_This->m_BoundingSphereCenter.m_X = minimum.m_X + ((maximum.m_X - minimum.m_X) >> 1);
+	a_This->m_BoundingSphereCenter.m_Y = minimum.m_Y + ((maximum.m_Y - minimum.m_Y) >> 1);
+	a_This->m_BoundingSphereCenter.m_Z = minimum.m_Z + ((maximum.m_Z - minimum.m_Z) >> 1);
+
+	// Scale the distances down until the sum of three squares fits in 16.16;
+	maximumOffset = SO_MAX( maximum.m_X - minimum.m_X, maximum.m_Y - minimum.m_Y );
+	maximumOffset = SO_MAX( maximum.m_Z - minimum.m_Z, maximumOffset );
+
+	while ( (maximumOffset >> shift) >= SO_FIXED_FROM_WHOLE( 100 ) ) shift++;
+
+	// Find the vertex farthest away;
+	for ( i = 0; i < a_This->m_NumVertices; i++ )
+	{
+		offset.m_X = (a_This->m_Vertices[ i ].m_X - a_This->m_BoundingSphereCenter.m_X) >> shift;
+		offset.m_Y = (a_This->m_Vertices[ i ].m_Y - a_This->m_BoundingSphereCenter.m_Y) >> shift;
+		offset.m_Z = (a_This->m_Vertices[ i ].m_Z - a_This->m_BoundingSphereCenter.m_Z) >> shift;
+
+		squaredDistance = SoMathFixedMultiply( offset.m_X, offset.m_X ) +
+						  SoMathFixedMultiply( offset.m_Y, offset.m_Y ) +
+						  SoMathFixedMultiply( offset.m_Z, offset.m_Z );
+
+		maximumSquaredDistance = SO_MAX( maximumSquaredDistance, squaredDistance );
+	}
+
+	// Round up, so the sphere is never too small;
+	a_This->m_BoundingSphereRadius = (SoMathFixedSqrt( maximumSquaredDistance ) + SO_FIXED_FROM_WHOLE( 1 )) << shift;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the center of the bounding sphere, in object space.
+
+	\param	a_This		This pointer
+
+	See \a SoMeshCalculateBoundingSphere.
+*/
+// ----------------------------------------------------------------------------
+SoVector3* SoMeshGetBoundingSphereCenter( SoMesh* a_This ) 
+{ 
+	return &a_This->m_BoundingSphereCenter; 
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the radius of the bounding sphere, in object space.
+
+	\param	a_This		This pointer
+
+	\return Zero if the mesh has no bounding sphere, see \a SoMeshCalculateBoundingSphere.
+*/
+// ----------------------------------------------------------------------------
+sofixedpoint SoMeshGetBoundingSphereRadius( SoMesh* a_This ) 
+{ 
+	return a_This->m_BoundingSphereRadius; 
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Calculates the plane of every polygon of the mesh.
+
+	\param	a_This		This pointer
+
+	Call this once after the vertices and polygons are set up, and again if you 
+	change them. See \a SoPolygonCalculatePlane. 
+	
+	With the planes, a camera puts itself in object space and throws away the 
+	polygons facing away from it before anything is transformed, and it only 
+	transforms the vertices of the polygons that are left. This is skipped for 
+	meshes with a scale other than one, those are culled on the screen only.
+	So are meshes with more than \a SO_MESH_MAX_NUM_POLYGONS polygons.
+*/
+// ----------------------------------------------------------------------------
+void SoMeshCalculatePolygonPlanes( SoMesh* a_This )
+{
+	// Dummy counter;
+	u32 i;
+
+	for ( i = 0; i < a_This->m_NumPolygons; i++ )
+	{
+		SoPolygonCalculatePlane( &a_This->m_Polygons[ i ], a_This->m_Vertices );
+	}
+
+	a_This->m_HasPolygonPlanes = true;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns whether \a SoMeshCalculatePolygonPlanes was called.
+
+	\param	a_This		This pointer
+*/
+// ----------------------------------------------------------------------------
+bool SoMeshHasPolygonPlanes( SoMesh* a_This ) 
+{ 
+	return a_This->m_HasPolygonPlanes; 
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 // EOF;
 // ----------------------------------------------------------------------------
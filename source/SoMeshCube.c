@@ -124,8 +124,12 @@ void SoMeshMakeDefaultCube( SoMesh* a_This )
 	a_This->m_NumPolygons = 12;	
 	a_This->m_Polygons = (SoPolygon*) s_CubeTriangles;
 	a_This->m_Vertices = (SoVector3*) s_CubeVertices;
+	a_This->m_PerspectiveSpanLength = 0;
 
 	SoTransformMakeIdentity( &a_This->m_Transform );
+
+	SoMeshCalculateBoundingSphere( a_This );
+	SoMeshCalculatePolygonPlanes(  a_This );
 }
 // ----------------------------------------------------------------------------
 
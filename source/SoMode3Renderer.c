@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode3Renderer.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode3Renderer
+
+	See the \a SoMode3Renderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoMode3Renderer.h"
+#include "SoRenderer.h"
+#include "SoDisplay.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! \internal Pointer to the mode 3 buffer
+#define SO_MODE3_RENDERER_BUFFER	((u16*)0x6000000)
+
+// ----------------------------------------------------------------------------
+// Function implementations;
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Switches the Gameboy Advance to mode 3.
+
+	Use this method before you are going to use any other mode 3 rendering function.
+
+	Make sure you have already called \a SoDisplayInitialize too.
+*/
+// ----------------------------------------------------------------------------
+void SoMode3RendererEnable( void )
+{
+	SoDisplaySetMode( 3 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Clears the mode 3 buffer to palette index zero.
+
+	See \a SoRendererSetPalette.
+*/
+// ----------------------------------------------------------------------------
+void SoMode3RendererClear( void )
+{
+	SoRendererClear16( SO_MODE3_RENDERER_BUFFER, SO_SCREEN_WIDTH * SO_SCREEN_HEIGHT );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a pointer to the mode 3 buffer.
+
+	There is only one, so it is always visible.
+*/
+// ----------------------------------------------------------------------------
+void* SoMode3RendererGetBuffer( void )
+{
+	return (void*) SO_MODE3_RENDERER_BUFFER;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws (part of) an image of any size into the mode 3 buffer.
+
+	Takes the same parameters as \a SoMode4RendererBlit, see \a SoRendererBlit16.
+*/
+// ----------------------------------------------------------------------------
+void SoMode3RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y,
+						  const SoMode4RendererRectangle* a_Source, u32 a_Flags )
+{
+	SoRendererBlit16( SO_MODE3_RENDERER_BUFFER, SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT,
+					  a_Image, a_X, a_Y, a_Source, a_Flags );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Plots a single pixel into the mode 3 buffer.
+
+	\param a_X			X position of the pixel in the range 0 to 239.
+	\param a_Y			Y position of the pixel in the range 0 to 159.
+	\param a_Color		16 bit color of the pixel.
+*/
+// ----------------------------------------------------------------------------
+void SoMode3RendererDrawPixel( u32 a_X, u32 a_Y, u16 a_Color )
+{
+	SO_ASSERT( a_X < SO_SCREEN_WIDTH && a_Y < SO_SCREEN_HEIGHT, "Pixel is offscreen." );
+
+	SO_MODE3_RENDERER_BUFFER[ SO_SCREEN_WIDTH * a_Y + a_X ] = a_Color;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
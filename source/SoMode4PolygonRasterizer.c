@@ -25,8 +25,20 @@
 #include "SoFont.h"
 #include "SoDebug.h"
 #include "SoPalette.h"
+#include "SoTextureCache.h"
 
 
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+
+//! \internal Accurate one over the fixed point height of an edge. Edges that are
+//!			  shared by two polygons get exactly the same pixels, so the tangents
+//!			  need to be accurate, or pixels near the end of an edge are drawn twice
+//!			  or not at all. Guards against a division by zero for nearly
+//!			  horizontal edges.
+#define SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( n ) SO_FIXED_ONE_OVER_SLOW_ACCURATE( SO_MAX( (n), 4 ) )
+
 // ----------------------------------------------------------------------------
 // Typedefs 
 // ----------------------------------------------------------------------------
@@ -49,12 +61,6 @@ typedef struct
 // Static variables
 // ----------------------------------------------------------------------------
 
-static u8*				s_TextureData = NULL;	//!< \internal Current texture data used to draw a polygon
-static s32				s_TextureUShift;		//!< \internal 2log( texture width )
-static s32				s_TextureVShift;		//!< \internal 2log( texture height )
-static s32				s_TextureUMask;			//!< \internal Used for texture coord wrapping;
-static s32				s_TextureVMask;			//!< \internal Used for texture coord wrapping;
-
 static s32				s_PolygonMinY;	//!< \internal Maximum screen Y of a polygon
 static s32				s_PolygonMaxY;	//!< \internal Minimum screen Y of a polygon
 
@@ -69,6 +75,9 @@ static SoEdgeTableEntry s_EdgeTableR[ SO_SCREEN_HEIGHT ];
 //! True once \a SoMode4PolygonRasterizerInitialize is called.
 static bool				s_Initialized = false;
 
+static SoImage*			s_Texture		= NULL;	//!< \internal Texture set by \a SoMode4PolygonRasterizerSetTexture.
+static u32				s_TextureLevel	= 0;	//!< \internal Mipmap level of \a s_Texture that is used.
+
 
 // ----------------------------------------------------------------------------
 // Global variables
@@ -76,51 +85,193 @@ static bool				s_Initialized = false;
 
 u16*	g_SoMode4PolygonRasterizerBuffer;	//!< \internal Buffer the polygon rasterizer renders to;
 
+s32		g_SoMode4PolygonRasterizerBufferWidth  = SO_SCREEN_WIDTH;		//!< \internal Width of the buffer in pixels;
+s32		g_SoMode4PolygonRasterizerBufferHeight = SO_SCREEN_HEIGHT;		//!< \internal Height of the buffer in pixels;
+s32		g_SoMode4PolygonRasterizerBufferPitch  = SO_SCREEN_HALF_WIDTH;	//!< \internal Halfwords from one row to the next;
+
+u8*		g_SoMode4PolygonRasterizerTextureData = NULL;	//!< \internal Current texture data used to draw a polygon
+s32		g_SoMode4PolygonRasterizerTextureUShift;		//!< \internal 2log( texture width )
+s32		g_SoMode4PolygonRasterizerTextureVShift;		//!< \internal 2log( texture height )
+s32		g_SoMode4PolygonRasterizerTextureUMask;			//!< \internal Used for texture coord wrapping;
+s32		g_SoMode4PolygonRasterizerTextureVMask;			//!< \internal Used for texture coord wrapping;
+
+u32		g_SoMode4PolygonRasterizerTextureMode = SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE;	//!< \internal Current texture mode;
+u32		g_SoMode4PolygonRasterizerTextureFade = SO_FADE_MAX;							//!< \internal Weight of the texels when translucent;
+
 // ----------------------------------------------------------------------------
 // Forward declarations
 // ----------------------------------------------------------------------------
 void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void );
 void SoMode4PolygonRasterizerDrawSolidPolygonFromEdgeTables( u32 a_PaletteIndex );
 
-
 // ----------------------------------------------------------------------------
-// Forward declaration that is implemented in assembly and need to be documented here
-// by their declaration, because Doxygen can't handle .s files.
+/*!
+	\brief	Sets the backbuffer the rasterizer will render to.
+	
+	\param	a_Buffer	Pointer to the start of an 8 bit buffer.
+	
+	Only changes the buffer pointer. The width, height and pitch stay what they were,
+	which is 240 by 160 pixels unless you changed them with 
+	\a SoMode4PolygonRasterizerSetRenderTarget. So if you render at a lower resolution
+	into the mode 4 backbuffer, the size survives \a SoMode4RendererFlip.
+*/
 // ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerSetBuffer( void* a_Buffer ) 
+{ 
+	g_SoMode4PolygonRasterizerBuffer = a_Buffer; 
 
+	// A new buffer has nothing drawn on it yet;
+	if ( g_SoMode4PolygonRasterizerSpanBufferEnabled )
+	{
+		SoMode4PolygonRasterizerClearSpanBuffer();
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
 /*!
-	\brief Draws a 4 by 4 triangle from the given 10 bit code.
+	\brief	Sets the buffer, size and pitch the rasterizer will render to.
+	
+	\param	a_Target	Description of the render target.
 
-	\internal	Only called from within \a SoMode4PolygonRasterizerDraw4x4Triangle
-		
-	\param	a_4x4WordAddress		Word (32 bits aligned) address of the top left corner of
-									the 4 by 4 pixel rectangle.
-	\param	a_WordOffset			Offset (0, 1, 2 or 3) in the above 32 bits word of the top 
-									left corder of the rectangle.
-	\param	a_QuadPaletteIndex		Quadrupled palette index of the color of the triangle.
-									This means that a palette index of 0xAB becomes 0xABABABAB.
-	\param	a_TriangleCode			10 bits code of the triangle you want to draw.
-
-	Check the documentation for the \a SoMode4PolygonRasterizerDraw4x4Triangle function
-	for more information.
+	Use this to render into something other than a full screen mode 4 
+	backbuffer. For example the top left 120 by 80 pixels of the backbuffer with a 
+	pitch of 240, scaled up by the affine background hardware, which halves the 
+	number of pixels you draw. Or into a 64 by 64 buffer in RAM that is used as a 
+	texture afterwards.
+
+	The rasterizers don't clip, so everything you draw should be inside the 
+	target. \a SoCamera projects into the current target, so it takes care of this.
+
+	Setting the render target clears the span buffer, if it is enabled.
 */
-void SoMode4PolygonRasterizerDraw4x4TriangleFromCode(	void* a_4x4WordAddress, u32 a_WordOffset, 
-														u32 a_QuadPaletteIndex, u32 a_TriangleCode );
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerSetRenderTarget( const SoMode4PolygonRasterizerRenderTarget* a_Target )
+{
+	SO_ASSERT( a_Target->m_Width  <= SO_SCREEN_WIDTH,  "Render targets can't be wider than the screen." );
+	SO_ASSERT( a_Target->m_Height <= SO_SCREEN_HEIGHT, "Render targets can't be higher than the screen." );
+	SO_ASSERT( a_Target->m_Pitch  >= a_Target->m_Width, "Render target pitch is smaller than its width." );
+	SO_ASSERT( ((a_Target->m_Pitch | (u32) a_Target->m_Buffer) & 1) == 0, 
+			   "Render target buffer and pitch should be on 16 bit boundaries." );
+
+	g_SoMode4PolygonRasterizerBufferWidth  = a_Target->m_Width;
+	g_SoMode4PolygonRasterizerBufferHeight = a_Target->m_Height;
+	g_SoMode4PolygonRasterizerBufferPitch  = a_Target->m_Pitch >> 1;
+
+	SoMode4PolygonRasterizerSetBuffer( a_Target->m_Buffer );
+}
+// ----------------------------------------------------------------------------
 
 // ----------------------------------------------------------------------------
 /*!
-	\brief	Sets the backbuffer the rasterizer will render to.
+	\brief	Returns the buffer, size and pitch the rasterizer renders to.
 	
-	\param	a_Buffer	Pointer to the start of a 240 x 160 x 8 bit buffer.
+	\param	a_Target	Filled with the description of the current render target.
+
+	Handy to restore the render target after rendering to a texture.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerGetRenderTarget( SoMode4PolygonRasterizerRenderTarget* a_Target )
+{
+	a_Target->m_Buffer = g_SoMode4PolygonRasterizerBuffer;
+	a_Target->m_Width  = g_SoMode4PolygonRasterizerBufferWidth;
+	a_Target->m_Height = g_SoMode4PolygonRasterizerBufferHeight;
+	a_Target->m_Pitch  = g_SoMode4PolygonRasterizerBufferPitch << 1;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Enables or disables the span buffer.
 	
-	Note that this buffer (for perfomance reasons) always is a 240 by 160 pixel buffer, 
-	where each pixel is 8 bit. I could change this in the future (to support other sizes)
-	even without a performance loss, but for now I have other priorities.
+	\param	a_Enable	True if you want to use the span buffer.
+
+	The span buffer remembers, for every scanline, which pixels are already drawn
+	since the last call to \a SoMode4PolygonRasterizerSetBuffer. Triangles then only 
+	draw the pixels that are still uncovered. So if you draw front to back, every
+	pixel is written only once, no matter how much overdraw your scene has. This 
+	saves a lot of slow VRAM writes in dense scenes, but it costs a bit of time 
+	for every scanline, so don't use it for scenes with little overdraw.
+
+	Only \a SoMode4PolygonRasterizerDrawSolidTriangleC, 
+	\a SoMode4PolygonRasterizerDrawTexturedTriangle and 
+	\a SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle use the span buffer.
+	\a SoCamera takes care of this when the span buffer is enabled.
+
+	Enabling the span buffer clears it.
 */
 // ----------------------------------------------------------------------------
-void SoMode4PolygonRasterizerSetBuffer( void* a_Buffer ) 
-{ 
-	g_SoMode4PolygonRasterizerBuffer = a_Buffer; 
+void SoMode4PolygonRasterizerSetSpanBufferEnable( bool a_Enable )
+{
+	g_SoMode4PolygonRasterizerSpanBufferEnabled = a_Enable;
+
+	if ( a_Enable )
+	{
+		SoMode4PolygonRasterizerClearSpanBuffer();
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns true if the span buffer is enabled.
+
+	See \a SoMode4PolygonRasterizerSetSpanBufferEnable.
+*/
+// ----------------------------------------------------------------------------
+bool SoMode4PolygonRasterizerGetSpanBufferEnable( void )
+{
+	return g_SoMode4PolygonRasterizerSpanBufferEnabled;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets how the textured triangle routines write their texels.
+
+	\param	a_Mode	\a SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE, or a combination of
+					\a SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSPARENT and 
+					\a SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSLUCENT.
+	\param	a_Fade	Weight of the texels when translucent, from 0 (invisible) to 
+					\a SO_FADE_MAX (opaque). Ignored otherwise.
+
+	Transparent skips every texel with palette index 0, use it for foliage and 
+	fences. Translucent blends each texel with the pixel behind it through the
+	\a g_Fade table, use it for glass and water. Like the cross fade of the 
+	\a SoMode4Renderer, blending only looks right if your palette is a ramp, so
+	that palette indices can be added like colors.
+
+	Only \a SoMode4PolygonRasterizerDrawTexturedTriangle, 
+	\a SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle and 
+	\a SoMode4PolygonRasterizerDrawTexturedTriangles use the mode. In opaque
+	mode they run exactly as fast as before. 
+
+	The span buffer still treats these triangles as if they covered every pixel, 
+	so disable it, and draw them after the opaque triangles behind them.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerSetTextureMode( u32 a_Mode, u32 a_Fade )
+{
+	SO_ASSERT( (a_Mode & ~(SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSPARENT |
+						   SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSLUCENT)) == 0, 
+			   "Unknown texture mode" );
+	SO_ASSERT( a_Fade <= SO_FADE_MAX, "Fade level out of range" );
+
+	g_SoMode4PolygonRasterizerTextureMode = a_Mode;
+	g_SoMode4PolygonRasterizerTextureFade = a_Fade;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the current texture mode.
+
+	See \a SoMode4PolygonRasterizerSetTextureMode.
+*/
+// ----------------------------------------------------------------------------
+u32 SoMode4PolygonRasterizerGetTextureMode( void )
+{
+	return g_SoMode4PolygonRasterizerTextureMode;
 }
 // ----------------------------------------------------------------------------
 
@@ -129,6 +280,10 @@ void SoMode4PolygonRasterizerSetBuffer( void* a_Buffer )
 	\brief	Sets the texture the rasterizer should use for textured polygons.
 
 	\param a_Texture	Texture you want to use.
+
+	Uses the full size mipmap level of the texture. If the \a SoTextureCache is 
+	initialized, the rasterizer reads the texels from the copy of the texture in 
+	the cache.
  */
 // ----------------------------------------------------------------------------
 void SoMode4PolygonRasterizerSetTexture( SoImage* a_Texture ) 
@@ -137,10 +292,12 @@ void SoMode4PolygonRasterizerSetTexture( SoImage* a_Texture )
 	s32 textureWidth;
 	s32 textureHeight;
 
+	s_Texture = a_Texture;
+
 	// Maybe we're just disabling texturing;
 	if ( a_Texture == NULL )
 	{
-		s_TextureData = NULL;
+		g_SoMode4PolygonRasterizerTextureData = NULL;
 		return;
 	}
 
@@ -158,16 +315,125 @@ void SoMode4PolygonRasterizerSetTexture( SoImage* a_Texture )
 	// Assert that the texture is palettized;
 	SO_ASSERT( SoImageIsPalettized( a_Texture ), "Only palettized images can be used as textures." );
 
+	// Use the full size level;
+	s_TextureLevel = SoImageGetNumMipLevels( a_Texture );
+	SoMode4PolygonRasterizerSetTextureLevel( 0 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the mipmap level of the current texture the rasterizer should use.
+
+	\param a_Level		Mipmap level, 0 is the full size texture. Levels beyond the 
+						last one use the last one.
+
+	Texture coordinates stay the same for every level. Returns immediately if
+	the level is already in use.
+ */
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerSetTextureLevel( u32 a_Level ) 
+{ 
+	// Variables;
+	s32 textureWidth;
+	s32 textureHeight;
+
+	// Maybe there is nothing to do;
+	if ( s_Texture == NULL ) return;
+
+	if ( a_Level >= SoImageGetNumMipLevels( s_Texture ) )
+	{
+		a_Level = SoImageGetNumMipLevels( s_Texture ) - 1;
+	}
+
+	if ( a_Level == s_TextureLevel ) return;
+
+	s_TextureLevel = a_Level;
+
+	// Get the level width and height;
+	textureWidth  = SoImageGetMipLevelWidth(  s_Texture, a_Level );
+	textureHeight = SoImageGetMipLevelHeight( s_Texture, a_Level );
+
 	// Calculate the wrapper masks;
-	s_TextureUMask = textureWidth  - 1;
-	s_TextureVMask = textureHeight - 1;
+	g_SoMode4PolygonRasterizerTextureUMask = textureWidth  - 1;
+	g_SoMode4PolygonRasterizerTextureVMask = textureHeight - 1;
 
 	// Calculate the texture shifts;
-	s_TextureUShift  = 0; while ( textureWidth  >>= 1 ) ++s_TextureUShift; --s_TextureUShift;
-	s_TextureVShift  = 0; while ( textureWidth  >>= 1 ) ++s_TextureVShift; --s_TextureVShift;
+	g_SoMode4PolygonRasterizerTextureUShift = 0; while ( textureWidth  >>= 1 ) ++g_SoMode4PolygonRasterizerTextureUShift;
+	g_SoMode4PolygonRasterizerTextureVShift = 0; while ( textureHeight >>= 1 ) ++g_SoMode4PolygonRasterizerTextureVShift;
 	
-	// Set the texture;
-	s_TextureData = (u8*) SoImageGetData( a_Texture ); 
+	// Set the texture, or its copy in fast RAM;
+	g_SoMode4PolygonRasterizerTextureData = SoTextureCacheGetData( s_Texture, a_Level ); 
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Calculates the mipmap level a textured polygon should be drawn with.
+
+	\param a_Texture				Texture of the polygon.
+	\param a_NumVertices			Number of vertices in the polygon.
+	\param a_ScreenCoordinates		Screen coordinates of the polygon.
+	\param a_TextureCoordinates	Texture coordinates of the polygon.
+
+	\return The mipmap level to pass to \a SoMode4PolygonRasterizerSetTextureLevel.
+
+	Compares the area of the polygon on the screen with the area it covers in the 
+	full size texture. Every level has a quarter of the texels of the previous one, 
+	so the level is the number of times the texel area can be divided by four without
+	getting smaller than the screen area. This way a texel is never smaller than a 
+	pixel, which avoids the shimmering of distant polygons and reads less texture memory.
+ */
+// ----------------------------------------------------------------------------
+u32 SoMode4PolygonRasterizerCalculateTextureLevel( const SoImage* a_Texture, 
+												   u32			  a_NumVertices, 
+												   SoVector2*	  a_ScreenCoordinates,
+												   SoVector2*	  a_TextureCoordinates )
+{
+	// Dummy counters;
+	u32 i, j;
+
+	// Twice the areas, in a fixed point format with two bits of fraction;
+	s32 screenArea	= 0;
+	s32 texelArea	= 0;
+
+	// Mipmap level;
+	u32 level = 0;
+	u32 lastLevel = SoImageGetNumMipLevels( a_Texture ) - 1;
+
+	// Texture shifts to go from texture coordinates to full size texels;
+	s32 uShift = 0;
+	s32 vShift = 0;
+
+	// Maybe there are no mipmaps;
+	if ( lastLevel == 0 ) return 0;
+
+	while ( (SoImageGetWidth(  a_Texture ) >> uShift) > 1 ) uShift++;
+	while ( (SoImageGetHeight( a_Texture ) >> vShift) > 1 ) vShift++;
+
+	// Calculate both areas with the shoelace formula;
+	for ( i = 0; i < a_NumVertices; i++ )
+	{
+		j = (i + 1 == a_NumVertices) ? 0 : i + 1;
+
+		screenArea += (a_ScreenCoordinates[ i ].m_X >> 14) * (a_ScreenCoordinates[ j ].m_Y >> 14)
+					- (a_ScreenCoordinates[ j ].m_X >> 14) * (a_ScreenCoordinates[ i ].m_Y >> 14);
+
+		texelArea  += ((a_TextureCoordinates[ i ].m_X >> 14) << uShift) * ((a_TextureCoordinates[ j ].m_Y >> 14) << vShift)
+					- ((a_TextureCoordinates[ j ].m_X >> 14) << uShift) * ((a_TextureCoordinates[ i ].m_Y >> 14) << vShift);
+	}
+
+	if ( screenArea < 0 ) screenArea = -screenArea;
+	if ( texelArea  < 0 ) texelArea	 = -texelArea;
+
+	// Every level down has a quarter of the texels;
+	while ( level < lastLevel && texelArea >= (screenArea << 2) )
+	{
+		texelArea >>= 2;
+		level++;
+	}
+
+	return level;
 }
 // ----------------------------------------------------------------------------
 
@@ -219,9 +485,8 @@ void SoMode4PolygonRasterizerInitialize( void )
 				drawing polygons, but triangles. This routine uses edge tables, which means slow 
 				nasty memory reads everywhere. Besides, it's not affine, thus slow. 
 				
-				If you really want a fast texturemapper, keep bugging me and I'll write you one.
-				Or even better, write it yourself (in assembly ofcourse) and submit it for the
-				SGADE.
+				If you want a fast texturemapper, subdivide your polygons in triangles and use
+				\a SoMode4PolygonRasterizerDrawTexturedTriangle instead.
 */
 // ----------------------------------------------------------------------------
 void SoMode4PolygonRasterizerDrawTexturedPolygon( u32 a_NumVertices, 
@@ -253,6 +518,7 @@ void SoMode4PolygonRasterizerDrawTexturedPolygon( u32 a_NumVertices,
 	s32	tX, tU, tV;				// Tangent values;
 	s32	dY, oodY;				// Delta Y and one-over-delta Y value;
 	s32 topY, botY;				// Whole top and bot Y values of one edge;
+	s32 yShift;					// Distance from the top of an edge to the first scanline;
 
 	// Reset the min and max y values of this polygon
 	s_PolygonMinY = SO_SCREEN_HEIGHT; 
@@ -277,11 +543,12 @@ void SoMode4PolygonRasterizerDrawTexturedPolygon( u32 a_NumVertices,
 			botText = textB;
 		}
 
-		// Calculate the dY;
-		dY = botVert->m_Y - topVert->m_Y;
+		// Calculate whole top and bot Y, using a top left filling convention;
+		topY = SO_FIXED_CEIL_WHOLE( topVert->m_Y );
+		botY = SO_FIXED_CEIL_WHOLE( botVert->m_Y );
 
-		// If dY is smaller then fixed one we can skip this edge;
-		if ( dY < SO_FIXED_FROM_WHOLE( 1 ) ) 
+		// If the edge doesn't cross a scanline we can skip it;
+		if ( topY == botY ) 
 		{
 			// Go to the next edge;
 			vertA = vertB;
@@ -294,21 +561,18 @@ void SoMode4PolygonRasterizerDrawTexturedPolygon( u32 a_NumVertices,
 		}
 
 		// Calculate one-over-dY;
-		oodY = SO_FIXED_ONE_OVER_FAST_INACCURATE( dY );
+		oodY = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( botVert->m_Y - topVert->m_Y );
 
 		// Calculate the tangents;
-		tX = SO_FIXED_MULTIPLY_BIG_SMALL( (botVert->m_X - topVert->m_X), oodY );
-		tU = SO_FIXED_MULTIPLY_BIG_SMALL( (botText->m_X - topText->m_X), oodY );
-		tV = SO_FIXED_MULTIPLY_BIG_SMALL( (botText->m_Y - topText->m_Y), oodY );
-
-		// Set initial X, U and V;
-		rX = topVert->m_X;
-		rU = topText->m_X;
-		rV = topText->m_Y;
+		tX = SO_FIXED_MULTIPLY_LONG( (botVert->m_X - topVert->m_X), oodY );
+		tU = SO_FIXED_MULTIPLY_LONG( (botText->m_X - topText->m_X), oodY );
+		tV = SO_FIXED_MULTIPLY_LONG( (botText->m_Y - topText->m_Y), oodY );
 
-		// Calculate whole top and bot Y;
-		topY = SO_FIXED_TO_WHOLE( topVert->m_Y );
-		botY = SO_FIXED_TO_WHOLE( botVert->m_Y );
+		// Set initial X, U and V, subpixel corrected to the first scanline;
+		yShift = SO_FIXED_FROM_WHOLE( topY ) - topVert->m_Y;
+		rX = topVert->m_X + SO_FIXED_MULTIPLY_LONG( tX, yShift );
+		rU = topText->m_X + SO_FIXED_MULTIPLY_LONG( tU, yShift );
+		rV = topText->m_Y + SO_FIXED_MULTIPLY_LONG( tV, yShift );
 
 		// Are these top and bot Y values the maximum and minimum?
 		if ( topY < s_PolygonMinY ) s_PolygonMinY = topY;
@@ -319,10 +583,10 @@ void SoMode4PolygonRasterizerDrawTexturedPolygon( u32 a_NumVertices,
 
 		// Multiply the texture values by the texture width and height
 		// to go from [0..1] range to [0..width or height] range;
-		tU <<= s_TextureUShift;
-		rU <<= s_TextureUShift;
-		tV <<= s_TextureVShift;
-		rV <<= s_TextureVShift;
+		tU <<= g_SoMode4PolygonRasterizerTextureUShift;
+		rU <<= g_SoMode4PolygonRasterizerTextureUShift;
+		tV <<= g_SoMode4PolygonRasterizerTextureVShift;
+		rV <<= g_SoMode4PolygonRasterizerTextureVShift;
 
 		// Get a pointer to the the start of the edge tables;
 		edgeL = &s_EdgeTableL[ topY ];
@@ -385,9 +649,9 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 {
 	// Pointers;
 	u16				 *pixels;
-	u8				 *texture		= s_TextureData;
+	u8				 *texture		= g_SoMode4PolygonRasterizerTextureData;
 	u16				 *scanline		= g_SoMode4PolygonRasterizerBuffer 
-									+ SO_SCREEN_HALF_WIDTH_MULTIPLY( s_PolygonMinY );
+									+ g_SoMode4PolygonRasterizerBufferPitch * s_PolygonMinY;
 	SoEdgeTableEntry *edgeL			= &s_EdgeTableL[ s_PolygonMinY ];
 	SoEdgeTableEntry *edgeR			= &s_EdgeTableR[ s_PolygonMinY ];
 	
@@ -402,29 +666,31 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 	// Draw each horizontal line of the polygon;
 	for ( rY = s_PolygonMaxY - s_PolygonMinY; rY != 0; rY-- )
 	{
-		// Get the left and right whole values;
-		lX = SO_FIXED_TO_WHOLE( edgeL->m_X );
-		rX = SO_FIXED_TO_WHOLE( edgeR->m_X );
+		// Get the left and right whole values, using a top left filling convention;
+		lX = SO_FIXED_CEIL_WHOLE( edgeL->m_X );
+		rX = SO_FIXED_CEIL_WHOLE( edgeR->m_X );
 
-		// Calculate the fixed length of the line;
-		dX = (edgeR->m_X - edgeL->m_X);
+		// Never leave the screen;
+		if ( lX < 0 )				lX = 0;
+		if ( rX > g_SoMode4PolygonRasterizerBufferWidth ) rX = g_SoMode4PolygonRasterizerBufferWidth;
 
-		// If the length is at least something;
-		if ( dX > SO_FIXED_FROM_WHOLE( 1 ) )
+		// If the line covers at least one pixel;
+		if ( lX < rX )
 		{
 			// Get a pointer to the first two pixels;
 			pixels = scanline + (lX >> 1);
 		
 			// Calculate one over deltaX;
+			dX	 = (edgeR->m_X - edgeL->m_X);
 			oodX = SO_FIXED_ONE_OVER_FAST_INACCURATE( dX );
 
 			// Calculate the tangents;
 			tU = SO_FIXED_MULTIPLY_BIG_SMALL( (edgeR->m_U - edgeL->m_U), oodX );
 			tV = SO_FIXED_MULTIPLY_BIG_SMALL( (edgeR->m_V - edgeL->m_V), oodX );
 
-			// Set the initial u and v values;
-			rU = edgeL->m_U;
-			rV = edgeL->m_V;
+			// Set the initial u and v values, subpixel corrected to the first pixel;
+			rU = edgeL->m_U + SO_FIXED_MULTIPLY_LONG( tU, SO_FIXED_FROM_WHOLE( lX ) - edgeL->m_X );
+			rV = edgeL->m_V + SO_FIXED_MULTIPLY_LONG( tV, SO_FIXED_FROM_WHOLE( lX ) - edgeL->m_X );
 
 			// If the line starts at uneven pixel, we
 			// need to take care of it;
@@ -435,11 +701,11 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 				iV = SO_FIXED_TO_WHOLE( rV );
 
 				// Wrap the texture coordinates;
-				iU &= s_TextureUMask;
-				iV &= s_TextureVMask;
+				iU &= g_SoMode4PolygonRasterizerTextureUMask;
+				iV &= g_SoMode4PolygonRasterizerTextureVMask;
 
 				// Create the second palette index of the two-pixel value;
-				paletteIndices = (u16)texture[ (iV << s_TextureUShift) + iU ] << 8;
+				paletteIndices = (u16)texture[ (iV << g_SoMode4PolygonRasterizerTextureUShift) + iU ] << 8;
 
 				// Mask out the second pixel;
 				*pixels &= 0x00FF;
@@ -469,11 +735,11 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 				iV = SO_FIXED_TO_WHOLE( rV );
 
 				// Wrap the texture coordinates;
-				iU &= s_TextureUMask;
-				iV &= s_TextureVMask;
+				iU &= g_SoMode4PolygonRasterizerTextureUMask;
+				iV &= g_SoMode4PolygonRasterizerTextureVMask;
 
 				// Create the first palette index of the two-pixel value;
-				paletteIndices = (u16)texture[ (iV << s_TextureUShift) + iU ];
+				paletteIndices = (u16)texture[ (iV << g_SoMode4PolygonRasterizerTextureUShift) + iU ];
 
 				// Add the tangents;
 				rU += tU;
@@ -484,11 +750,11 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 				iV = SO_FIXED_TO_WHOLE( rV );
 
 				// Wrap the texture coordinates;
-				iU &= s_TextureUMask;
-				iV &= s_TextureVMask;
+				iU &= g_SoMode4PolygonRasterizerTextureUMask;
+				iV &= g_SoMode4PolygonRasterizerTextureVMask;
 
 				// Create the second palette index of the two-pixel value;
-				paletteIndices |= (((u16)texture[ (iV << s_TextureUShift) + iU ]) << 8);
+				paletteIndices |= (((u16)texture[ (iV << g_SoMode4PolygonRasterizerTextureUShift) + iU ]) << 8);
 
 				// Put the palette-indices in the buffer;
 				*pixels = paletteIndices;
@@ -511,11 +777,11 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 				iV = SO_FIXED_TO_WHOLE( rV );
 
 				// Wrap the texture coordinates;
-				iU &= s_TextureUMask;
-				iV &= s_TextureVMask;
+				iU &= g_SoMode4PolygonRasterizerTextureUMask;
+				iV &= g_SoMode4PolygonRasterizerTextureVMask;
 
 				// Create the first palette index of the two-pixel value;
-				paletteIndices = (u16)texture[ (iV << s_TextureUShift) + iU ];
+				paletteIndices = (u16)texture[ (iV << g_SoMode4PolygonRasterizerTextureUShift) + iU ];
 
 				// Mask out the first pixel;
 				*pixels &= 0xFF00;
@@ -526,7 +792,7 @@ void SoMode4PolygonRasterizerDrawTexturedPolygonFromEdgeTables( void )
 		}
 
 		// Go to the next scanline;
-		scanline += SO_SCREEN_HALF_WIDTH;
+		scanline += g_SoMode4PolygonRasterizerBufferPitch;
 		
 		// Restore the edge tables to their initial values;
 		(edgeL++)->m_X = SO_FIXED_FROM_WHOLE( SO_SCREEN_WIDTH );
@@ -582,6 +848,7 @@ void SoMode4PolygonRasterizerDrawSolidPolygon( u32 a_NumVertices,
 	s32	tX;						// Tangent values;
 	s32	dY, oodY;				// Delta Y and one-over-delta Y value;
 	s32 topY, botY;				// Whole top and bot Y values of one edge;
+	s32 yShift;					// Distance from the top of an edge to the first scanline;
 
 	// Reset the min and max y values of this polygon
 	s_PolygonMinY = SO_SCREEN_HEIGHT; 
@@ -602,11 +869,12 @@ void SoMode4PolygonRasterizerDrawSolidPolygon( u32 a_NumVertices,
 			botVert = vertB;
 		}
 
-		// Calculate the dY;
-		dY = botVert->m_Y - topVert->m_Y;
+		// Calculate whole top and bot Y, using a top left filling convention;
+		topY = SO_FIXED_CEIL_WHOLE( topVert->m_Y );
+		botY = SO_FIXED_CEIL_WHOLE( botVert->m_Y );
 
-		// If dY is smaller then fixed one we can skip this edge;
-		if ( dY < SO_FIXED_FROM_WHOLE( 1 ) ) 
+		// If the edge doesn't cross a scanline we can skip it;
+		if ( topY == botY ) 
 		{
 			// Go to the next edge;
 			vertA = vertB;
@@ -617,17 +885,14 @@ void SoMode4PolygonRasterizerDrawSolidPolygon( u32 a_NumVertices,
 		}
 
 		// Calculate one-over-dY;
-		oodY = SO_FIXED_ONE_OVER_FAST_INACCURATE( dY );
+		oodY = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( botVert->m_Y - topVert->m_Y );
 
 		// Calculate the X tangent;
-		tX = SO_FIXED_MULTIPLY_BIG_SMALL( (botVert->m_X - topVert->m_X), oodY );
+		tX = SO_FIXED_MULTIPLY_LONG( (botVert->m_X - topVert->m_X), oodY );
 
-		// Set initial X;
-		rX = topVert->m_X;
-		
-		// Calculate whole top and bot Y;
-		topY = SO_FIXED_TO_WHOLE( topVert->m_Y );
-		botY = SO_FIXED_TO_WHOLE( botVert->m_Y );
+		// Set initial X, subpixel corrected to the first scanline;
+		yShift = SO_FIXED_FROM_WHOLE( topY ) - topVert->m_Y;
+		rX = topVert->m_X + SO_FIXED_MULTIPLY_LONG( tX, yShift );
 
 		// Are these top and bot Y values the maximum and minimum?
 		if ( topY < s_PolygonMinY ) s_PolygonMinY = topY;
@@ -690,7 +955,7 @@ void SoMode4PolygonRasterizerDrawSolidPolygonFromEdgeTables( u32 a_PaletteIndex
 	// Pointers;
 	u16				 *pixels;
 	u16				 *scanline		= g_SoMode4PolygonRasterizerBuffer 
-									+ SO_SCREEN_HALF_WIDTH_MULTIPLY( s_PolygonMinY );
+									+ g_SoMode4PolygonRasterizerBufferPitch * s_PolygonMinY;
 	SoEdgeTableEntry *edgeL			= &s_EdgeTableL[ s_PolygonMinY ];
 	SoEdgeTableEntry *edgeR			= &s_EdgeTableR[ s_PolygonMinY ];
 	
@@ -705,15 +970,16 @@ void SoMode4PolygonRasterizerDrawSolidPolygonFromEdgeTables( u32 a_PaletteIndex
 	// Draw each horizontal line of the polygon;
 	for ( rY = s_PolygonMaxY - s_PolygonMinY; rY != 0; rY-- )
 	{
-		// Get the left and right whole values;
-		lX = SO_FIXED_TO_WHOLE( edgeL->m_X );
-		rX = SO_FIXED_TO_WHOLE( edgeR->m_X );
+		// Get the left and right whole values, using a top left filling convention;
+		lX = SO_FIXED_CEIL_WHOLE( edgeL->m_X );
+		rX = SO_FIXED_CEIL_WHOLE( edgeR->m_X );
 
-		// Calculate the fixed length of the line;
-		dX = (edgeR->m_X - edgeL->m_X);
+		// Never leave the screen;
+		if ( lX < 0 )				lX = 0;
+		if ( rX > g_SoMode4PolygonRasterizerBufferWidth ) rX = g_SoMode4PolygonRasterizerBufferWidth;
 
-		// If the length is at least something;
-		if ( dX > SO_FIXED_FROM_WHOLE( 1 ) )
+		// If the line covers at least one pixel;
+		if ( lX < rX )
 		{
 			// Get a pointer to the first two pixels;
 			pixels = scanline + (lX >> 1);
@@ -761,7 +1027,7 @@ void SoMode4PolygonRasterizerDrawSolidPolygonFromEdgeTables( u32 a_PaletteIndex
 		}
 
 		// Go to the next scanline;
-		scanline += SO_SCREEN_HALF_WIDTH;
+		scanline += g_SoMode4PolygonRasterizerBufferPitch;
 		
 		// Restore the edge tables to their initial values;
 		(edgeL++)->m_X = SO_FIXED_FROM_WHOLE( SO_SCREEN_WIDTH );
@@ -775,6 +1041,12 @@ void SoMode4PolygonRasterizerDrawSolidPolygonFromEdgeTables( u32 a_PaletteIndex
 	\brief C version of the assembly solid triangle rasterizer;
 
 	I actually implemented this one first, and then converted it to assembly;
+
+	Unlike the assembly version, this one skips the rows above and below the
+	render target, so the triangle only needs to be within its width. Like the
+	assembly version, it clamps the scanlines to that width.
+	\a SoCamera relies on this when it renders in bands, see 
+	\a SoCameraSetBinning.
 */
 // ----------------------------------------------------------------------------
 void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32 a_PaletteIndex )
@@ -794,12 +1066,21 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 
 	s32 yShift;
 	
-	sofixedpoint tangentLeftX, tangentRightX;
+	// The tangent of a top half without scanlines isn't calculated, but
+	// it still goes through the subpixel correction;
+	sofixedpoint tangentLeftX = 0, tangentRightX = 0;
 
 	sofixedpoint ooQ;
 
 	u16* scanline;
 	u16* pixel;
+
+	// Uncovered parts of a scanline, if the span buffer is enabled;
+	u8	 gaps[ 2 * (SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS + 1) ];
+	u8*	 gap;
+	u32	 numGaps;
+	s32	 pixelDuos;
+	s32	 integerY;
 	
 	bool middleVertexRight = true;
 
@@ -827,54 +1108,78 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 	// Calculate the tangents;
 	if ( middleVertexRight )
 	{
-		         ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v2->m_Y - v0->m_Y);
-		tangentLeftX = SO_FIXED_MULTIPLY( (v2->m_X - v0->m_X), ooQ );
+		         ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v2->m_Y - v0->m_Y );
+		tangentLeftX = SO_FIXED_MULTIPLY_LONG( (v2->m_X - v0->m_X), ooQ );
 
 
 		if ( integerDeltaY ) 
 		{
-			          ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v1->m_Y - v0->m_Y);
-			tangentRightX = SO_FIXED_MULTIPLY( (v1->m_X - v0->m_X), ooQ );
+			          ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v1->m_Y - v0->m_Y );
+			tangentRightX = SO_FIXED_MULTIPLY_LONG( (v1->m_X - v0->m_X), ooQ );
 		}			
 	}
 	else
 	{
 		if ( integerDeltaY ) 
 		{
-			         ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v1->m_Y - v0->m_Y);
-			tangentLeftX = SO_FIXED_MULTIPLY( (v1->m_X - v0->m_X), ooQ );
+			         ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v1->m_Y - v0->m_Y );
+			tangentLeftX = SO_FIXED_MULTIPLY_LONG( (v1->m_X - v0->m_X), ooQ );
 		}
 
-		          ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v2->m_Y - v0->m_Y);
-		tangentRightX = SO_FIXED_MULTIPLY( (v2->m_X - v0->m_X), ooQ );
+		          ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v2->m_Y - v0->m_Y );
+		tangentRightX = SO_FIXED_MULTIPLY_LONG( (v2->m_X - v0->m_X), ooQ );
 	}
 
 	// Calculate the start X values;
 	fixedLeftX = fixedRightX = v0->m_X;
 
-	// Calculate the starting scanline pointer;
-	scanline = g_SoMode4PolygonRasterizerBuffer + SO_SCREEN_HALF_WIDTH * SO_FIXED_CEIL_WHOLE( v0->m_Y );
+	// Calculate the starting scanline and its pointer;
+	integerY = SO_FIXED_CEIL_WHOLE( v0->m_Y );
+	scanline = g_SoMode4PolygonRasterizerBuffer + g_SoMode4PolygonRasterizerBufferPitch * integerY;
 	
 	// Subpixel correct the starting X values;
 	yShift = SO_FIXED_FROM_WHOLE( SO_FIXED_CEIL_WHOLE( v0->m_Y ) ) - v0->m_Y;
-	fixedLeftX  += SO_FIXED_MULTIPLY( tangentLeftX,  yShift );
-	fixedRightX += SO_FIXED_MULTIPLY( tangentRightX, yShift );
+	fixedLeftX  += SO_FIXED_MULTIPLY_LONG( tangentLeftX,  yShift );
+	fixedRightX += SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
 
 	// Break out after the second triangle half;
 	while ( true )
 	{		
+		// Skip the rows above the render target;
+		if ( integerY < 0 && integerDeltaY > 0 )
+		{
+			yShift = SO_MIN( -integerY, integerDeltaY );
+
+			integerY	  += yShift;
+			integerDeltaY -= yShift;
+			scanline	  += g_SoMode4PolygonRasterizerBufferPitch * yShift;
+			fixedLeftX	  += tangentLeftX * yShift;
+			fixedRightX	  += tangentRightX * yShift;
+		}
+
+		// Stop at the bottom of the render target;
+		if ( integerY + integerDeltaY > g_SoMode4PolygonRasterizerBufferHeight )
+		{
+			integerDeltaY  = SO_MAX( g_SoMode4PolygonRasterizerBufferHeight - integerY, 0 );
+			bottomPartDone = true;
+		}
+
 		// Iterate over the triangle-half;
 		while ( integerDeltaY-- )
 		{
-			// Get the scanline start and end;
+			// Get the scanline start and end. An edge on the border of the render 
+			// target can end up a bit outside of it, because the tangent is rounded;
 			integerLeftX   = SO_FIXED_CEIL_WHOLE( fixedLeftX  );
 			integerRightX  = SO_FIXED_CEIL_WHOLE( fixedRightX );
 
+			if ( integerLeftX  < 0 )										integerLeftX  = 0;
+			if ( integerRightX > g_SoMode4PolygonRasterizerBufferWidth )	integerRightX = g_SoMode4PolygonRasterizerBufferWidth;
+
 			// Get the length;
 			scanlineLength = integerRightX - integerLeftX; 
 
-			// Is there a scanline
-			if ( scanlineLength > 0 )
+			// Is there a scanline, and should all of it be drawn;
+			if ( scanlineLength > 0 && ! g_SoMode4PolygonRasterizerSpanBufferEnabled )
 			{		
 				// Get the pixel pointer on a 16 bit boundary;
 				pixel = scanline + (integerLeftX >> 1);
@@ -882,7 +1187,8 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 				// Is there a funky first pixel;
 				if ( integerLeftX & 1 ) 
 				{
-					*pixel++ |= 0xFF00 & a_PaletteIndex;
+					*pixel = (*pixel & 0x00FF) | (a_PaletteIndex & 0xFF00);
+					pixel++;
 					--scanlineLength;
 				}
 
@@ -893,11 +1199,39 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 				while ( scanlineLength-- ) *pixel++ = a_PaletteIndex;
 
 				// Is there a funky last pixel;
-				if ( integerRightX & 1 ) *pixel |= 0x00FF & a_PaletteIndex;
+				if ( integerRightX & 1 ) *pixel = (*pixel & 0xFF00) | (a_PaletteIndex & 0x00FF);
+			}
+			else if ( scanlineLength > 0 )
+			{
+				// Only draw the parts that aren't covered yet;
+				numGaps = SoMode4PolygonRasterizerSpanBufferInsert( integerY, integerLeftX, integerRightX, gaps );
+
+				for ( gap = gaps; numGaps--; gap += 2 )
+				{
+					// Get the pixel pointer on a 16 bit boundary;
+					pixel = scanline + (gap[ 0 ] >> 1);
+					scanlineLength = gap[ 1 ] - gap[ 0 ];
+
+					// Is there a funky first pixel. Other polygons might 
+					// already be drawn next to it, so mask it in;
+					if ( gap[ 0 ] & 1 ) 
+					{
+						*pixel = (*pixel & 0x00FF) | (a_PaletteIndex & 0xFF00);
+						pixel++;
+						--scanlineLength;
+					}
+
+					// Draw the pixel pairs;
+					for ( pixelDuos = scanlineLength >> 1; pixelDuos--; ) *pixel++ = a_PaletteIndex;
+
+					// Is there a funky last pixel;
+					if ( scanlineLength & 1 ) *pixel = (*pixel & 0xFF00) | (a_PaletteIndex & 0x00FF);
+				}
 			}
 
 			// Go to the next line;
-			scanline += SO_SCREEN_HALF_WIDTH;		
+			scanline += g_SoMode4PolygonRasterizerBufferPitch;		
+			integerY++;
 
 			// Add the tangents;
 			fixedLeftX	+= tangentLeftX;
@@ -916,23 +1250,23 @@ void SoMode4PolygonRasterizerDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32
 		// Setup the bottom half;
 		if ( middleVertexRight )
 		{
-			          ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v2->m_Y - v1->m_Y);
-			tangentRightX = SO_FIXED_MULTIPLY( (v2->m_X - v1->m_X), ooQ );
+			          ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v2->m_Y - v1->m_Y );
+			tangentRightX = SO_FIXED_MULTIPLY_LONG( (v2->m_X - v1->m_X), ooQ );
 			
 			fixedRightX = v1->m_X;
 	
 			yShift = SO_FIXED_FROM_WHOLE( SO_FIXED_CEIL_WHOLE( v1->m_Y ) ) - v1->m_Y;
-			fixedRightX += SO_FIXED_MULTIPLY( tangentRightX, yShift );
+			fixedRightX += SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
 		}
 		else
 		{
-			         ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE(v2->m_Y - v1->m_Y);
-			tangentLeftX = SO_FIXED_MULTIPLY( (v2->m_X - v1->m_X), ooQ );
+			         ooQ = SO_MODE4_POLYGON_RASTERIZER_ONE_OVER_DELTA_Y( v2->m_Y - v1->m_Y );
+			tangentLeftX = SO_FIXED_MULTIPLY_LONG( (v2->m_X - v1->m_X), ooQ );
 
 			fixedLeftX = v1->m_X;
 		
 			yShift = SO_FIXED_FROM_WHOLE( SO_FIXED_CEIL_WHOLE( v1->m_Y ) ) - v1->m_Y;
-			fixedLeftX += SO_FIXED_MULTIPLY( tangentLeftX, yShift );
+			fixedLeftX += SO_FIXED_MULTIPLY_LONG( tangentLeftX, yShift );
 		}
 	} 
 }
@@ -0,0 +1,277 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode4PolygonRasterizerLine.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode4PolygonRasterizer
+
+	See the \a SoMode4PolygonRasterizer module for more information.
+
+	Everything in this file is compiled as ARM code and lives in IWRAM, so
+	don't call any ROM functions or use divisions in here.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoMath.h"
+#include "SoVector.h"
+#include "SoMode4PolygonRasterizer.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! \internal Cohen-Sutherland outcodes, telling on what sides of the render target a point is;
+//@{
+#define SO_MODE4_POLYGON_RASTERIZER_OUTCODE_LEFT		SO_BIT_0
+#define SO_MODE4_POLYGON_RASTERIZER_OUTCODE_RIGHT		SO_BIT_1
+#define SO_MODE4_POLYGON_RASTERIZER_OUTCODE_TOP			SO_BIT_2
+#define SO_MODE4_POLYGON_RASTERIZER_OUTCODE_BOTTOM		SO_BIT_3
+//@}
+
+/*!
+	\brief Evaluates to the outcode of a point.
+
+	\internal
+*/
+#define SO_MODE4_POLYGON_RASTERIZER_OUTCODE( a_X, a_Y )																\
+	( ( (a_X) < 0									  ? SO_MODE4_POLYGON_RASTERIZER_OUTCODE_LEFT	: 0 ) |		\
+	  ( (a_X) >= g_SoMode4PolygonRasterizerBufferWidth  ? SO_MODE4_POLYGON_RASTERIZER_OUTCODE_RIGHT	: 0 ) |		\
+	  ( (a_Y) < 0									  ? SO_MODE4_POLYGON_RASTERIZER_OUTCODE_TOP		: 0 ) |		\
+	  ( (a_Y) >= g_SoMode4PolygonRasterizerBufferHeight ? SO_MODE4_POLYGON_RASTERIZER_OUTCODE_BOTTOM	: 0 ) )
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a line.
+
+	\param a_X0, a_Y0		Whole pixel coordinates of the first end point.
+	\param a_X1, a_Y1		Whole pixel coordinates of the second end point.
+	\param a_PaletteIndex	Color you want to draw the line with.
+
+	Both end points are drawn. The line is clipped against the render target with
+	the Cohen-Sutherland algorithm, so the end points can be anywhere, as long as
+	they are between -16384 and 16383. The clipped end points are rounded to whole
+	pixels, so the onscreen part of a clipped line can be a pixel off from the 
+	same part of the unclipped line.
+
+	Lines are drawn with Bresenham's algorithm. Mode 4 pixels can only be written
+	two at a time, so for lines that are more horizontal than vertical, two
+	neighbouring pixels on the same scanline are written at once, without reading
+	them first. Only the pixels at the ends of a horizontal run need a read.
+	Lines that are more vertical than horizontal need a read for every pixel.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerDrawLine( s32 a_X0, s32 a_Y0, s32 a_X1, s32 a_Y1, u32 a_PaletteIndex )
+{
+	// Outcodes of both end points;
+	u32 outcode0, outcode1, outcode;
+	s32 x, y;
+
+	// Bresenham values;
+	s32 deltaX, deltaY;
+	s32 error;
+	s32 step;
+	s32 count;
+
+	u16* scanline;
+	u16* pixel;
+
+	// Clip the line against the render target;
+	outcode0 = SO_MODE4_POLYGON_RASTERIZER_OUTCODE( a_X0, a_Y0 );
+	outcode1 = SO_MODE4_POLYGON_RASTERIZER_OUTCODE( a_X1, a_Y1 );
+
+	while ( outcode0 | outcode1 )
+	{
+		// Is it entirely on the outside of one side;
+		if ( outcode0 & outcode1 ) return;
+
+		// Move an outside end point onto the side it is outside of;
+		outcode = outcode0 ? outcode0 : outcode1;
+
+		if ( outcode & SO_MODE4_POLYGON_RASTERIZER_OUTCODE_TOP )
+		{
+			y = 0;
+			x = a_X0 + SO_MATH_DIVIDE_ARM( (a_X1 - a_X0) * (y - a_Y0), a_Y1 - a_Y0 );
+		}
+		else if ( outcode & SO_MODE4_POLYGON_RASTERIZER_OUTCODE_BOTTOM )
+		{
+			y = g_SoMode4PolygonRasterizerBufferHeight - 1;
+			x = a_X0 + SO_MATH_DIVIDE_ARM( (a_X1 - a_X0) * (y - a_Y0), a_Y1 - a_Y0 );
+		}
+		else if ( outcode & SO_MODE4_POLYGON_RASTERIZER_OUTCODE_LEFT )
+		{
+			x = 0;
+			y = a_Y0 + SO_MATH_DIVIDE_ARM( (a_Y1 - a_Y0) * (x - a_X0), a_X1 - a_X0 );
+		}
+		else
+		{
+			x = g_SoMode4PolygonRasterizerBufferWidth - 1;
+			y = a_Y0 + SO_MATH_DIVIDE_ARM( (a_Y1 - a_Y0) * (x - a_X0), a_X1 - a_X0 );
+		}
+
+		if ( outcode == outcode0 )
+		{
+			a_X0 = x; a_Y0 = y;
+			outcode0 = SO_MODE4_POLYGON_RASTERIZER_OUTCODE( a_X0, a_Y0 );
+		}
+		else
+		{
+			a_X1 = x; a_Y1 = y;
+			outcode1 = SO_MODE4_POLYGON_RASTERIZER_OUTCODE( a_X1, a_Y1 );
+		}
+	}
+
+	// Double the palette index (we're plotting double pixels);
+	a_PaletteIndex |= a_PaletteIndex << 8;
+
+	deltaX = SO_ABS( a_X1 - a_X0 );
+	deltaY = SO_ABS( a_Y1 - a_Y0 );
+
+	// More horizontal than vertical;
+	if ( deltaX >= deltaY )
+	{
+		// Always go from left to right;
+		if ( a_X0 > a_X1 )
+		{
+			x = a_X0; a_X0 = a_X1; a_X1 = x;
+			y = a_Y0; a_Y0 = a_Y1; a_Y1 = y;
+		}
+
+		step  = a_Y1 > a_Y0 ? g_SoMode4PolygonRasterizerBufferPitch : -g_SoMode4PolygonRasterizerBufferPitch;
+		pixel = g_SoMode4PolygonRasterizerBuffer + g_SoMode4PolygonRasterizerBufferPitch * a_Y0 + (a_X0 >> 1);
+		error = deltaX >> 1;
+		count = deltaX + 1;
+		x	  = a_X0;
+
+		while ( count > 0 )
+		{
+			// Is the next pixel on the same scanline, and in the same pixel pair;
+			if ( ! (x & 1) && count > 1 && error >= deltaY )
+			{
+				*pixel++ = a_PaletteIndex;
+
+				x	  += 2;
+				count -= 2;
+				error -= deltaY << 1;
+			}
+			else
+			{
+				if ( x & 1 )
+				{
+					*pixel = (*pixel & 0x00FF) | (a_PaletteIndex & 0xFF00);
+					pixel++;
+				}
+				else
+				{
+					*pixel = (*pixel & 0xFF00) | (a_PaletteIndex & 0x00FF);
+				}
+
+				x++;
+				count--;
+				error -= deltaY;
+			}
+
+			// Go to the next scanline;
+			if ( error < 0 )
+			{
+				error += deltaX;
+				pixel += step;
+			}
+		}
+	}
+	// More vertical than horizontal;
+	else
+	{
+		// Always go from top to bottom;
+		if ( a_Y0 > a_Y1 )
+		{
+			x = a_X0; a_X0 = a_X1; a_X1 = x;
+			y = a_Y0; a_Y0 = a_Y1; a_Y1 = y;
+		}
+
+		step	 = a_X1 > a_X0 ? 1 : -1;
+		scanline = g_SoMode4PolygonRasterizerBuffer + g_SoMode4PolygonRasterizerBufferPitch * a_Y0;
+		error	 = deltaY >> 1;
+		count	 = deltaY + 1;
+		x		 = a_X0;
+
+		while ( count-- )
+		{
+			pixel = scanline + (x >> 1);
+
+			if ( x & 1 )
+			{
+				*pixel = (*pixel & 0x00FF) | (a_PaletteIndex & 0xFF00);
+			}
+			else
+			{
+				*pixel = (*pixel & 0xFF00) | (a_PaletteIndex & 0x00FF);
+			}
+
+			scanline += g_SoMode4PolygonRasterizerBufferPitch;
+			error	 -= deltaX;
+
+			if ( error < 0 )
+			{
+				error += deltaY;
+				x	  += step;
+			}
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws lines between a row of points.
+
+	\param a_NumVertices	Number of points.
+	\param a_Vertices		Array of \a SoVector2 points, in a fixed point format.
+							They are rounded to the nearest pixel.
+	\param a_Closed			If \a true, the last point is connected to the first one too.
+	\param a_PaletteIndex	Color you want to draw the lines with.
+
+	Uses \a SoMode4PolygonRasterizerDrawLine, so the points can be offscreen.
+	\a SoCamera uses this to draw polygon outlines, see \a SoCameraSetWireframeEnable.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerDrawPolyline( u32 a_NumVertices, SoVector2* a_Vertices,
+										   bool a_Closed, u32 a_PaletteIndex )
+{
+	u32 i;
+	s32 x0, y0, x1, y1;
+
+	if ( a_NumVertices < 2 ) return;
+
+	x1 = SO_FIXED_TO_WHOLE( a_Vertices[ 0 ].m_X + (1 << (SO_FIXED_Q - 1)) );
+	y1 = SO_FIXED_TO_WHOLE( a_Vertices[ 0 ].m_Y + (1 << (SO_FIXED_Q - 1)) );
+
+	for ( i = 1; i < a_NumVertices; i++ )
+	{
+		x0 = x1;
+		y0 = y1;
+		x1 = SO_FIXED_TO_WHOLE( a_Vertices[ i ].m_X + (1 << (SO_FIXED_Q - 1)) );
+		y1 = SO_FIXED_TO_WHOLE( a_Vertices[ i ].m_Y + (1 << (SO_FIXED_Q - 1)) );
+
+		SoMode4PolygonRasterizerDrawLine( x0, y0, x1, y1, a_PaletteIndex );
+	}
+
+	if ( a_Closed && a_NumVertices > 2 )
+	{
+		SoMode4PolygonRasterizerDrawLine( x1, y1,
+										  SO_FIXED_TO_WHOLE( a_Vertices[ 0 ].m_X + (1 << (SO_FIXED_Q - 1)) ),
+										  SO_FIXED_TO_WHOLE( a_Vertices[ 0 ].m_Y + (1 << (SO_FIXED_Q - 1)) ),
+										  a_PaletteIndex );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 @	See the \a SoMode4PolygonRasterizer module for more information.
 @
 @	\implements		SoMode4PolygonRasterizerDrawSolidTriangle
+@	\implements		SoMode4PolygonRasterizerDrawSolidTriangles
 @
 @ --------------------------------------------------------------------------------------
 
@@ -21,13 +22,51 @@
         .ARM
         .ALIGN
         .GLOBL  SoMode4PolygonRasterizerDrawSolidTriangle
+        .GLOBL  SoMode4PolygonRasterizerDrawSolidTriangles
 		
 @ --------------------------------------------------------------------------------------
 @ Externals;
 @ --------------------------------------------------------------------------------------
 		
-		.EXTERN	g_OneOver								@ One over N table, to avoid divisions;
 		.EXTERN	g_SoMode4PolygonRasterizerBuffer		@ Pointer to the current backbuffer;
+		.EXTERN	g_SoMode4PolygonRasterizerBufferWidth	@ Width of the backbuffer in pixels;
+		.EXTERN	g_SoMode4PolygonRasterizerBufferPitch	@ Pitch of the backbuffer in halfwords;
+
+@ --------------------------------------------------------------------------------------
+@ Macros;
+@ --------------------------------------------------------------------------------------
+
+@ Calculates the accurate fixed point one over a positive fixed point delta Y, using
+@ the bios divide. Edges shared by two triangles have to get exactly the same pixels,
+@ and the one-over table is not accurate enough for that. Registers r0 to r3 are 
+@ preserved, the flags are not. The destination can't be r0 to r3;
+
+		.MACRO	ONE_OVER_DELTA_Y destination, deltaY
+
+			stmfd	sp!, {r0-r3}			@ The bios crushes r0, r1 and r3;
+			movs	r1, \deltaY, asr#2		@ Calculate 2^30 / (deltaY / 4), which is
+			moveq	r1, #1					@ 2^32 / deltaY, which is the fixed point
+			mov		r0, #0x40000000			@ one over deltaY. Guard against a division
+			swi		0x60000					@ by zero for nearly horizontal edges;
+			mov		\destination, r0
+			ldmfd	sp!, {r0-r3}
+
+		.ENDM
+
+@ Pushes the width and the pitch in bytes of the render target on the stack, 
+@ so [sp] is the width and [sp, #4] is the pitch. We have no registers left
+@ to keep them in;
+
+		.MACRO	PUSH_RENDER_TARGET scratch0, scratch1
+
+			ldr		\scratch0, =g_SoMode4PolygonRasterizerBufferWidth
+			ldr		\scratch0, [\scratch0]
+			ldr		\scratch1, =g_SoMode4PolygonRasterizerBufferPitch
+			ldr		\scratch1, [\scratch1]
+			mov		\scratch1, \scratch1, lsl#1
+			stmfd	sp!, {\scratch0, \scratch1}
+
+		.ENDM
 
 @ --------------------------------------------------------------------------------------
 @ 
@@ -41,6 +80,10 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 		
 			stmfd	sp!,{r4-r11, r14}
 
+		@ Remember the size of the render target;
+
+			PUSH_RENDER_TARGET r3, r4
+
 		@ ------------------------------------------------------------------------@
 		@					Register usage at this moment						  @	
 		@ ------------------------------------------------------------------------@
@@ -53,20 +96,24 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 
 			orr		r12, r1, r1, lsl#8		@ a_PaletteIndex | (a_PaletteIndex << 8)
 
-		@ We'll be using the top halfword of r12 as two booleans. The 24th bit indicating whether the middle vertex is
+		@ We'll be using the top halfword of r12 as three booleans. The 24th bit indicating whether the middle vertex is
 		@ on the left or on the right (0 means it's on the right), the 25th bit indicating what part 
-		@ of the triangle we're drawing (1 means the bottom half).
+		@ of the triangle we're drawing (1 means the bottom half), the 26th bit indicating whether
+		@ we're drawing a list of triangles (see SoMode4PolygonRasterizerDrawSolidTriangles).
 
 		
 		@ At this moment only r0 contains the starting address of the
 		@ triangle array of SoVector2 objects.
+
+			add		r1, r0, #8				@ Put the addres of a_Triangle[ 1 ] into r1, one SoVector2
+			add		r2, r0, #16				@ is 8 bytes; Do the same with a_Triangle[ 2 ] into r2;
+
 		@ We are going to sort the three vertices in increasing Y order;
 		@ At the end of this block, register 0, 1, and 2 will have pointers to 
 		@ the vertices in sorted order, and the first bit of r11 will be set according
 		@ to where the middle vertex is;
 
-			add		r1, r0, #8				@ Put the addres of a_Triangle[ 1 ] into r1, one SoVector2
-			add		r2, r0, #16				@ is 8 bytes; Do the same with a_Triangle[ 2 ] into r2;
+		sortVertices:
 											
 			ldr		r3, [r0, #4]			@ Load Y values and
 			ldr		r4, [r1, #4]			@ compare them;
@@ -123,22 +170,16 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 			add		r7, r3, r10				@ And another one...
 			subs	r10, r6, r7, lsr#16		@ combined with the subtract, also sets the zero flag;
 
-		@ Check for degenerate triangle (uses r8 to hold ceil value)
-
-			cmp		r10, #0
-			bne		calcTangents
+		@ Check for degenerate triangles, that don't cover a single scanline 
+		@ (uses r8 to hold ceil value);
 
 			ldr		r8, =0xFFFF				@ Temporarily load the ceil value;
-			add     r6, r5, r8
+			add     r6, r5, r8				@ Ceil the bottom Y;
 			mov		r6, r6, lsr#16
-			add		r7, r3, r8
-			subs	r8, r6, r6, lsr#16
-
-			cmp		r8, #0
-			bne		calcTangents
+			add		r7, r3, r8				@ Ceil the top Y, and subtract;
+			subs	r8, r6, r7, lsr#16
 					
-			ldmnefd	sp!,{r4-r11, r14}		@ Restore the registers we threw on the stack before;
-			bxne	lr						@ Return;
+			beq		triangleDone			@ Nothing to draw;
 
 
 		@ ------------------------------------------------------------------------@
@@ -152,10 +193,7 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 	calcTangents:
 
 			sub		r6, r5, r3				@ Calculate the fixed point delta whole Y;
-			mov		r6, r6, lsr#12			@ Now this can be used as an index in the one-over table;
-											
-			ldr		r9, =g_OneOver			@ Load the address of the one over table;
-			ldr		r6, [r9, r6, lsl#2]		@ Load one-over whole Y;
+			ONE_OVER_DELTA_Y r6, r6			@ Calculate one-over whole Y;
 											
 			sub		r7, r2, r0				@ Calculate the fixed point delta whole X;
 											
@@ -163,12 +201,11 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 			mov		r6, r6, lsl#16			@ Finish off the ...
 			add		r6, r6, r14, lsr#16		@ fixed point multiply;			
 											
-			beq		tangentsCalculated		@ If the zero flag is set, there is no top half, so don't calculate the short-side tangent;
+			cmp		r10, #0					@ If the top half has no scanlines,
+			beq		tangentsCalculated		@ don't calculate the short-side tangent;
 											
 			sub		r7, r4, r3				@ Calculate the fixed point delta top Y;
-			mov		r7, r7, lsr#12			@ Now this can be used as an index in the one-over table;
-											
-			ldr		r7, [r9, r7, lsl#2]		@ Load one-over whole Y;
+			ONE_OVER_DELTA_Y r7, r7			@ Calculate one-over top Y;
 											
 			sub		r8, r1, r0				@ Calculate the fixed point delta top X;
 											
@@ -192,22 +229,31 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 
 			ldr		r14, =0xFFFF								@ Temporarily load the ceil value;
 			add		r8, r3, r14									@ Ceil the top Y
-			bic		r8, r3, r14									@ value, keeping it fixed;
+			bic		r8, r8, r14									@ value, keeping it fixed;
 
-			mov		r14, r8, lsr#8								@ Multiply it with 240 (240 = 256 - 16), converting to 
-			sub		r14, r14, r8, lsr#12						@ integer in the process;
+			mov		r14, r8, lsr#16								@ Convert it to integer, and multiply
+			ldr		r9, [sp, #4]								@ it with the pitch of the render target;
+			mul		r14, r9, r14
 
 			ldr		r9, =g_SoMode4PolygonRasterizerBuffer		@ Load the address of the address of the buffer;
 			ldr		r9, [r9]									@ Load the adress of the buffer;
 			add		r14, r9, r14	 							@ Add the screen address;
 		
-			sub		r3, r8, r3									@ r3 now contains the Y shift value;
-			
-			mov		r3, r0										@ r0 and r3 now contain the starting X value for left and right edge;
+			sub		r11, r8, r3									@ r11 now contains the Y shift value;
 			
-			@ Subpixel correct them;
+			@ Subpixel correct the starting X values of the left and right edge,
+			@ by moving them down to the first scanline; 
 
-			@ TODO;
+			smull	r8, r9, r6, r11								@ Left tangent times the Y shift,
+			mov		r9, r9, lsl#16								@ finish off the ...
+			add		r9, r9, r8, lsr#16							@ fixed point multiply;
+
+			smull	r8, r3, r7, r11								@ Right tangent times the Y shift,
+			mov		r3, r3, lsl#16								@ finish off the ...
+			add		r3, r3, r8, lsr#16							@ fixed point multiply;
+
+			add		r3, r3, r0									@ r0 and r3 now contain the starting X value 
+			add		r0, r9, r0									@ for left and right edge;
 
 
 			@ Maybe there is no top triangle half;
@@ -251,14 +297,22 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 			ldr		r11, =0xFFFF			@ Temporarily load the ceil value;
 
 			add		r8, r0, r11				@ Ceil the left fixed X...
-			mov		r8, r8, lsr#16			@ to an integer X;
+			movs	r8, r8, asr#16			@ to an integer X, which should
+			movmi	r8, #0					@ never be left of the screen;
 			
-			add		r9, r3, r11				@ Ceil the right X, to calculate the scanline length;
+			add		r9, r3, r11				@ Ceil the right X, which should
+			mov		r9, r9, asr#16			@ never be right of the render
+			ldr		r11, [sp]				@ target either;
+			cmp		r9, r11
+			movgt	r9, r11
 					
-			rsbs	r9, r8, r9, lsr#16		@ Whole scanline length = whole rightX - whole 
-											@ leftX and sets the zero flag as well;
+			subs	r9, r9, r8				@ Whole scanline length = whole rightX - whole leftX;
+
+			ble		endOfScanline			@ If the scanline is empty, we skip this line;
+
+		@ Plot the pixels of the scanline;
 
-			beq		endOfScanline			@ If the scanline has length zero, we skip this line;
+		drawScanline:
 			
 			add		r8, r8, r14				@ Calculate the starting address of the scanline;
 												
@@ -328,7 +382,8 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 
 		@ Loop around;
 
-			add		r14,  r14, #240			@ Advance the scanline pointer;
+			ldr		r11, [sp, #4]			@ Advance the scanline pointer
+			add		r14,  r14, r11			@ by the render target pitch;
 			
 			subs	r10,  r10, #1			@ One scanline done;			
 			bne		triangleHalfLoop		@ Jump back if we're not done yet;
@@ -339,8 +394,7 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 		@ to do the bottom half of the triangle;
 
 			ands	r11, r12, #0x2000000	@ r11 is bogus register;
-			ldmnefd	sp!,{r4-r11, r14}		@ Restore the registers we threw on the stack before;
-			bxne	lr						@ Return;
+			bne		triangleDone			@ We're done;
 
 		@ We are going to do the bottom triangle now;
 
@@ -357,8 +411,7 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 
 		@ Maybe we're done already;
 
-			ldmeqfd	sp!,{r4-r11, r14}		@ Restore the registers we threw on the stack before;
-			bxeq	lr						@ Return;
+			beq		triangleDone
 
 		@ Setup the tangent and start X for the bottom half;
 
@@ -368,10 +421,7 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 		reSetupLeftHalf:
 		
 			sub		r6, r5, r4			@ Calculate the fixed point delta bottom Y;
-			mov		r6, r6, lsr#12		@ Now this can be used as an index in the one-over table;
-		
-			ldr		r9, =g_OneOver		@ Load the address of the one over table;
-			ldr		r6, [r9, r6, lsl#2]	@ Load one-over whole Y;
+			ONE_OVER_DELTA_Y r6, r6		@ Calculate one-over bottom Y;
 
 			sub		r8, r2, r1			@ Calculate the fixed point delta bottom X;
 			
@@ -379,17 +429,22 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 			mov		r6, r6, lsl#16		@ Finish off the ...
 			add		r6, r6, r11, lsr#16	@ fixed point multiply;			
 
-			mov		r0, r1				@ Reinitialize the left X;
+			ldr		r9, =0xFFFF			@ Calculate the Y shift from the middle
+			add		r8, r4, r9			@ vertex to the first scanline of the
+			bic		r8, r8, r9			@ bottom half;
+			sub		r8, r8, r4
+
+			smull	r9, r11, r6, r8		@ Reinitialize the left X, subpixel 
+			mov		r11, r11, lsl#16	@ corrected by moving it down to the
+			add		r11, r11, r9, lsr#16@ first scanline;
+			add		r0, r1, r11
 			
 			b		drawTriangleHalf	@ We're done with the bottom half setup, so start drawing again;	
 
 		reSetupRightHalf:
 
 			sub		r7, r5, r4			@ Calculate the fixed point delta bottom Y;
-			mov		r7, r7, lsr#12		@ Now this can be used as an index in the one-over table;
-		
-			ldr		r9, =g_OneOver		@ Load the address of the one over table;
-			ldr		r7, [r9, r7, lsl#2]	@ Load one-over whole Y;
+			ONE_OVER_DELTA_Y r7, r7		@ Calculate one-over bottom Y;
 
 			sub		r8, r2, r1			@ Calculate the fixed point delta bottom X;
 			
@@ -397,15 +452,89 @@ SoMode4PolygonRasterizerDrawSolidTriangle:
 			mov		r7, r7, lsl#16		@ Finish off the ...
 			add		r7, r7, r11, lsr#16	@ fixed point multiply;			
 
-			mov		r3, r1				@ Reinitialize the right X;
+			ldr		r9, =0xFFFF			@ Calculate the Y shift from the middle
+			add		r8, r4, r9			@ vertex to the first scanline of the
+			bic		r8, r8, r9			@ bottom half;
+			sub		r8, r8, r4
+
+			smull	r9, r11, r7, r8		@ Reinitialize the right X, subpixel 
+			mov		r11, r11, lsl#16	@ corrected by moving it down to the
+			add		r11, r11, r9, lsr#16@ first scanline;
+			add		r3, r1, r11
 			
 			b		drawTriangleHalf	@ We're done with the bottom half setup, so start drawing again;
 
+		@ The triangle is done. If we are drawing a list of triangles, go to
+		@ the next one. Otherwise return;
 
-			
-			
+		triangleDone:
+
+			tst		r12, #0x4000000			@ Are we drawing a list;
+			addeq	sp, sp, #8				@ Throw away the render target size;
+			ldmeqfd	sp!,{r4-r11, r14}		@ Restore the registers we threw on the stack before;
+			bxeq	lr						@ Return;
+
+			b		nextListTriangle
+
+@ --------------------------------------------------------------------------------------
+
+@ --------------------------------------------------------------------------------------
+@ 
+@ Documentation at declaration in header file.
+@
+@ --------------------------------------------------------------------------------------
 
+SoMode4PolygonRasterizerDrawSolidTriangles:
+
+		@ Store the registers we crush on the stack;
 		
+			stmfd	sp!,{r4-r11, r14}
+
+		@ Maybe there is nothing to draw;
+
+			cmp		r2, #0
+			ldmeqfd	sp!,{r4-r11, r14}
+			bxeq	lr
+
+		@ The triangle code above needs every register, so we keep the list state 
+		@ on the stack, right above the render target size. After this, [sp, #8] 
+		@ is a_Vertices, [sp, #12] is a_Indices, [sp, #16] is the number of triangles 
+		@ left and [sp, #20] is a_PaletteIndices;
+
+			stmfd	sp!,{r0-r3}
+			PUSH_RENDER_TARGET r4, r5
+
+		listTriangleLoop:
+
+			ldr		r3, [sp, #20]			@ Load the palette index of this triangle,
+			ldrb	r12, [r3], #1			@ and double it like above. Also set the
+			str		r3, [sp, #20]			@ bit that tells we're drawing a list;
+			orr		r12, r12, r12, lsl#8
+			orr		r12, r12, #0x4000000
+
+			ldr		r4, [sp, #12]			@ Load the three indices of this triangle;
+			ldrh	r0, [r4], #2
+			ldrh	r1, [r4], #2
+			ldrh	r2, [r4], #2
+			str		r4, [sp, #12]
+
+			ldr		r4, [sp, #8]			@ Turn them into pointers to vertices,
+			add		r0, r4, r0, lsl#3		@ one SoVector2 is 8 bytes;
+			add		r1, r4, r1, lsl#3
+			add		r2, r4, r2, lsl#3
+
+			b		sortVertices			@ Draw it;
+
+		nextListTriangle:
+
+			ldr		r2, [sp, #16]			@ One triangle less to go;
+			subs	r2, r2, #1
+			str		r2, [sp, #16]
+			bne		listTriangleLoop
+
+			add		sp, sp, #24				@ Throw away the render target size and the list state;
+			ldmfd	sp!,{r4-r11, r14}		@ Restore the registers we threw on the stack before;
+			bx		lr						@ Return;
 
 @ --------------------------------------------------------------------------------------
 
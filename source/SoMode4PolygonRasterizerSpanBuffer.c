@@ -0,0 +1,170 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode4PolygonRasterizerSpanBuffer.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode4PolygonRasterizer
+
+	See the \a SoMode4PolygonRasterizer module for more information.
+
+	Everything in this file is compiled as ARM code and lives in IWRAM, so
+	don't call any ROM functions or use divisions in here.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoDisplay.h"
+#include "SoMode4PolygonRasterizer.h"
+
+// ----------------------------------------------------------------------------
+// Static variables
+// ----------------------------------------------------------------------------
+
+//! \internal Number of covered spans on every scanline.
+static u8 s_NumSpans[ SO_SCREEN_HEIGHT ];
+
+//! \internal Covered spans of every scanline, as sorted, disjoint and non-touching
+//!			  pairs of start and end X. Ends are exclusive.
+static u8 s_Spans[ SO_SCREEN_HEIGHT ][ SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS * 2 ];
+
+// ----------------------------------------------------------------------------
+// Global variables
+// ----------------------------------------------------------------------------
+
+bool g_SoMode4PolygonRasterizerSpanBufferEnabled = false;	//!< \internal True if the span buffer is used.
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Marks every pixel of the span buffer as uncovered.
+
+	\internal Called by \a SoMode4PolygonRasterizerSetBuffer.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerClearSpanBuffer( void )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Remove all spans of every scanline;
+	for ( i = 0; i < SO_SCREEN_HEIGHT; i++ )
+	{
+		s_NumSpans[ i ] = 0;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Adds a span to the span buffer, and returns the parts of it that were
+		   not covered yet.
+
+	\internal Called by the triangle routines for every scanline, when the span
+			  buffer is enabled.
+
+	\param a_Y		Scanline of the span.
+	\param a_Left	First pixel of the span.
+	\param a_Right	Pixel after the last pixel of the span.
+	\param a_Gaps	Array of at least 2 * (\a SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS + 1)
+					bytes, which receives the start and end X (exclusive) of every uncovered 
+					part of the span, from left to right.
+
+	\return Number of uncovered parts written to \a a_Gaps. 
+
+	After this call the whole span is marked as covered. Spans that touch or overlap
+	are merged, so a scanline fully covered by adjacent polygons ends up with a 
+	single span. 
+	
+	If a scanline already has the maximum number of spans and the new span doesn't 
+	touch any of them, the new span is still returned as a gap but it isn't recorded. 
+	Polygons drawn later may then draw over it. 
+*/
+// ----------------------------------------------------------------------------
+u32 SoMode4PolygonRasterizerSpanBufferInsert( s32 a_Y, s32 a_Left, s32 a_Right, u8* a_Gaps )
+{
+	// Spans of this scanline;
+	u8* spans	 = s_Spans[ a_Y ];
+	u32 numSpans = s_NumSpans[ a_Y ];
+
+	// Range of spans that overlap or touch the new one;
+	u32 first, last, i;
+
+	// Merged span;
+	s32 mergedLeft  = a_Left;
+	s32 mergedRight = a_Right;
+
+	// Left end of the part that is still to be checked;
+	s32 x = a_Left;
+
+	// Number of gaps found;
+	u32 numGaps = 0;
+
+	// Skip the spans that are completely to the left;
+	for ( first = 0; first < numSpans && spans[ first * 2 + 1 ] < a_Left; first++ );
+
+	// Walk the spans that overlap or touch the new span;
+	for ( last = first; last < numSpans && spans[ last * 2 ] <= a_Right; last++ )
+	{
+		// Is there a gap before this span;
+		if ( spans[ last * 2 ] > x )
+		{
+			a_Gaps[ numGaps * 2     ] = x;
+			a_Gaps[ numGaps * 2 + 1 ] = spans[ last * 2 ];
+			numGaps++;
+		}
+
+		if ( spans[ last * 2 + 1 ] > x ) x = spans[ last * 2 + 1 ];
+
+		if ( spans[ last * 2	 ] < mergedLeft  ) mergedLeft  = spans[ last * 2	 ];
+		if ( spans[ last * 2 + 1 ] > mergedRight ) mergedRight = spans[ last * 2 + 1 ];
+	}
+
+	// Is there a gap after the last span;
+	if ( x < a_Right )
+	{
+		a_Gaps[ numGaps * 2     ] = x;
+		a_Gaps[ numGaps * 2 + 1 ] = a_Right;
+		numGaps++;
+	}
+
+	// Record the coverage;
+	if ( first == last )
+	{
+		// A new span, but only if there's room for it;
+		if ( numSpans == SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS ) return numGaps;
+
+		for ( i = numSpans * 2; i > first * 2; i-- )
+		{
+			spans[ i + 1 ] = spans[ i - 1 ];
+		}
+
+		numSpans++;
+	}
+	else
+	{
+		// Replace the touched spans by a single one;
+		for ( i = last * 2; i < numSpans * 2; i++ )
+		{
+			spans[ i - (last - first - 1) * 2 ] = spans[ i ];
+		}
+
+		numSpans -= last - first - 1;
+	}
+
+	spans[ first * 2	 ] = mergedLeft;
+	spans[ first * 2 + 1 ] = mergedRight;
+
+	s_NumSpans[ a_Y ] = numSpans;
+
+	return numGaps;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
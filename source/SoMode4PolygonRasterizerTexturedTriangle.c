@@ -0,0 +1,970 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode4PolygonRasterizerTexturedTriangle.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode4PolygonRasterizer
+
+	See the \a SoMode4PolygonRasterizer module for more information.
+
+	Everything in this file is compiled as ARM code and lives in IWRAM, so
+	don't call any ROM functions or use divisions in here.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+#include "SoTables.h"
+#include "SoMath.h"
+#include "SoVector.h"
+#include "SoDisplay.h"
+#include "SoMode4PolygonRasterizer.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Finds the parts of a scanline that should be drawn.
+
+	\internal
+
+	If the span buffer is enabled these are the parts that aren't covered yet, 
+	otherwise it is the whole scanline. Evaluates to the number of parts.
+*/
+#define SO_MODE4_POLYGON_RASTERIZER_FIND_GAPS( a_Y, a_Left, a_Right, a_Gaps )						\
+	( g_SoMode4PolygonRasterizerSpanBufferEnabled													\
+		? SoMode4PolygonRasterizerSpanBufferInsert( (a_Y), (a_Left), (a_Right), (a_Gaps) )			\
+		: ( (a_Gaps)[ 0 ] = (a_Left), (a_Gaps)[ 1 ] = (a_Right), 1 ) )
+
+// ----------------------------------------------------------------------------
+// Forward declarations;
+// ----------------------------------------------------------------------------
+
+static inline void SoMode4PolygonRasterizerDrawAffineTriangle( SoVector2* a_V0, SoVector2* a_V1, SoVector2* a_V2,
+															   SoVector2* a_T0, SoVector2* a_T1, SoVector2* a_T2,
+															   u8* a_Texture, s32 a_UShift, s32 a_VShift, 
+															   s32 a_UMask, s32 a_VMask ) SO_IWRAM_CODE;
+
+static inline void SoMode4PolygonRasterizerWriteTexels( u16* a_Pixel, u32 a_Texels, u32 a_Mask, u32 a_Mode,
+														const u8* a_Fade, const u8* a_InverseFade ) SO_IWRAM_CODE;
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws an affine textured 2D triangle.
+
+	\param a_Triangle				Array of 3 \a SoVector2 objects, which are the three
+									corner points of the triangle, in a fixed point format.
+									They need to be within the width of the render target,
+									rows above and below it are skipped.
+	\param a_TextureCoordinates		Array of 3 \a SoVector2 objects that are the texture
+									coordinates of the corner points, in the [0..1] range.
+
+	Draws the triangle with the texture set by \a SoMode4PolygonRasterizerSetTexture,
+	in the mode set by \a SoMode4PolygonRasterizerSetTextureMode.
+
+	Because the U and V gradients along a scanline are constant for an affine
+	triangle, they are calculated only once, at the widest scanline of the
+	triangle (the one through the middle vertex). The left and right edges are
+	then walked directly, so unlike \a SoMode4PolygonRasterizerDrawTexturedPolygon
+	this routine doesn't need the edge tables.
+
+	The same top left filling convention as \a SoMode4PolygonRasterizerDrawSolidTriangleC
+	is used.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerDrawTexturedTriangle( SoVector2 a_Triangle[ 3 ],
+												   SoVector2 a_TextureCoordinates[ 3 ] )
+{
+	SoMode4PolygonRasterizerDrawAffineTriangle( &a_Triangle[ 0 ], &a_Triangle[ 1 ], &a_Triangle[ 2 ],
+												&a_TextureCoordinates[ 0 ], 
+												&a_TextureCoordinates[ 1 ], 
+												&a_TextureCoordinates[ 2 ],
+												g_SoMode4PolygonRasterizerTextureData,
+												g_SoMode4PolygonRasterizerTextureUShift,
+												g_SoMode4PolygonRasterizerTextureVShift,
+												g_SoMode4PolygonRasterizerTextureUMask,
+												g_SoMode4PolygonRasterizerTextureVMask );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a list of indexed affine textured 2D triangles.
+
+	\param a_Vertices				Array of screen space vertices, in a fixed point format.
+									All vertices used by the triangles need to be onscreen.
+									This routine does not do any clipping.
+	\param a_Indices				Three indices into \a a_Vertices for every triangle.
+	\param a_NumTriangles			Number of triangles in the list.
+	\param a_TextureCoordinates		Three texture coordinates for every triangle, in the 
+									[0..1] range, in the same order as \a a_Indices. 
+
+	Draws the triangles with the texture set by \a SoMode4PolygonRasterizerSetTexture,
+	exactly like calling \a SoMode4PolygonRasterizerDrawTexturedTriangle for every
+	triangle. But the texture state is only loaded once, and the vertices don't 
+	have to be copied into a triangle array first. 
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerDrawTexturedTriangles( SoVector2* a_Vertices, 
+													u16*	   a_Indices, 
+													u32		   a_NumTriangles,
+													SoVector2* a_TextureCoordinates )
+{
+	// Local copies of the texture state;
+	u8* texture = g_SoMode4PolygonRasterizerTextureData;
+	s32 uShift	= g_SoMode4PolygonRasterizerTextureUShift;
+	s32 vShift	= g_SoMode4PolygonRasterizerTextureVShift;
+	s32 uMask	= g_SoMode4PolygonRasterizerTextureUMask;
+	s32 vMask	= g_SoMode4PolygonRasterizerTextureVMask;
+
+	// Draw each triangle;
+	while ( a_NumTriangles-- )
+	{
+		SoMode4PolygonRasterizerDrawAffineTriangle( &a_Vertices[ a_Indices[ 0 ] ], 
+													&a_Vertices[ a_Indices[ 1 ] ], 
+													&a_Vertices[ a_Indices[ 2 ] ],
+													&a_TextureCoordinates[ 0 ], 
+													&a_TextureCoordinates[ 1 ], 
+													&a_TextureCoordinates[ 2 ],
+													texture, uShift, vShift, uMask, vMask );
+		a_Indices			 += 3;
+		a_TextureCoordinates += 3;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Writes one or two texels to a 16 bit pair of pixels, in a non opaque texture mode.
+
+	\internal Used by the textured triangle routines when the texture mode isn't
+			  \a SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE.
+
+	\param a_Pixel			Pixel pair to write to.
+	\param a_Texels			Texels, already shifted to the byte they go to.
+	\param a_Mask			0xFF00 for the funky first pixel, 0x00FF for the funky last
+							pixel, and 0xFFFF for a pair.
+	\param a_Mode			Texture mode, see \a SoMode4PolygonRasterizerSetTextureMode.
+	\param a_Fade			Row of \a g_Fade for the texels.
+	\param a_InverseFade	Row of \a g_Fade for the pixels behind them.
+*/
+// ----------------------------------------------------------------------------
+static inline void SoMode4PolygonRasterizerWriteTexels( u16* a_Pixel, u32 a_Texels, u32 a_Mask, u32 a_Mode,
+														const u8* a_Fade, const u8* a_InverseFade )
+{
+	u32 pixels;
+
+	// Leave the pixels behind transparent texels alone;
+	if ( a_Mode & SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSPARENT )
+	{
+		if ( ! (a_Texels & 0x00FF) ) a_Mask &= 0xFF00;
+		if ( ! (a_Texels & 0xFF00) ) a_Mask &= 0x00FF;
+		if ( ! a_Mask ) return;
+	}
+
+	// Without blending a whole pair doesn't need the pixels behind it;
+	if ( a_Mask == 0xFFFF && ! (a_Mode & SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSLUCENT) )
+	{
+		*a_Pixel = a_Texels;
+		return;
+	}
+
+	pixels = *a_Pixel;
+
+	// Blend both bytes, the one that isn't written is masked out below;
+	if ( a_Mode & SO_MODE4_POLYGON_RASTERIZER_TEXTURE_TRANSLUCENT )
+	{
+		a_Texels = ( a_Fade[ a_Texels & 0xFF ] + a_InverseFade[ pixels & 0xFF ] ) |
+				   ( ( a_Fade[ a_Texels >> 8 ] + a_InverseFade[ pixels >> 8 ] ) << 8 );
+	}
+
+	*a_Pixel = (pixels & ~a_Mask) | (a_Texels & a_Mask);
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws an affine textured 2D triangle, given the texture state.
+
+	\internal Used by \a SoMode4PolygonRasterizerDrawTexturedTriangle and 
+			  \a SoMode4PolygonRasterizerDrawTexturedTriangles.
+
+	\param a_V0, a_V1, a_V2		Corner points of the triangle.
+	\param a_T0, a_T1, a_T2		Texture coordinates of the corner points.
+	\param a_Texture			Texture data.
+	\param a_UShift, a_VShift	2log of the texture width and height.
+	\param a_UMask, a_VMask		Texture width and height minus one.
+*/
+// ----------------------------------------------------------------------------
+static inline void SoMode4PolygonRasterizerDrawAffineTriangle( SoVector2* a_V0, SoVector2* a_V1, SoVector2* a_V2,
+															   SoVector2* a_T0, SoVector2* a_T1, SoVector2* a_T2,
+															   u8* a_Texture, s32 a_UShift, s32 a_VShift, 
+															   s32 a_UMask, s32 a_VMask )
+{
+	// Vertices and their texture coordinates;
+	SoVector2* v0 = a_V0;
+	SoVector2* v1 = a_V1;
+	SoVector2* v2 = a_V2;
+	SoVector2* t0 = a_T0;
+	SoVector2* t1 = a_T1;
+	SoVector2* t2 = a_T2;
+	SoVector2* vT; // Temporary vector for swapping;
+
+	// The V shift and mask turn a fixed point V into a texel row offset at once;
+	u8* texture = a_Texture;
+	s32 uMask	= a_UMask;
+	s32 vMask	= a_VMask << a_UShift;
+	s32 vShift	= SO_FIXED_Q - a_UShift;
+
+	// Texture mode, see SoMode4PolygonRasterizerSetTextureMode;
+	u32		  mode		  = g_SoMode4PolygonRasterizerTextureMode;
+	const u8* fade		  = &g_Fade[ g_SoMode4PolygonRasterizerTextureFade << 8 ];
+	const u8* inverseFade = &g_Fade[ (SO_FADE_MAX - g_SoMode4PolygonRasterizerTextureFade) << 8 ];
+
+	// Render target size, see SoMode4PolygonRasterizerSetRenderTarget;
+	s32 targetWidth  = g_SoMode4PolygonRasterizerBufferWidth;
+	s32 targetHeight = g_SoMode4PolygonRasterizerBufferHeight;
+	s32 pitch		 = g_SoMode4PolygonRasterizerBufferPitch;
+
+	// Texture coordinates in texel space;
+	sofixedpoint u0, u1, u2;
+	sofixedpoint w0, w1, w2;	// These are the V coordinates, but v0 is already taken;
+
+	// Whole top, middle and bottom scanlines;
+	s32 y0, y1, y2;
+
+	// Values at the long edge (v0 to v2) at the height of the middle vertex;
+	sofixedpoint ooLongHeight;
+	sofixedpoint longT, longX, longU, longV;
+	sofixedpoint width;
+
+	// Constant gradients along each scanline;
+	sofixedpoint gradientU, gradientV;
+
+	// Edge values;
+	sofixedpoint fixedLeftX,   fixedRightX, fixedLeftU,   fixedLeftV;
+	sofixedpoint tangentLeftX, tangentRightX, tangentLeftU, tangentLeftV;
+	sofixedpoint ooQ;
+	sofixedpoint xShift, yShift;
+
+	// Scanline values;
+	s32 integerDeltaY;
+	s32 integerLeftX;
+	s32 integerRightX;
+	s32 scanlineLength;
+	s32 pixelDuos;
+	sofixedpoint u, v;
+	u32 texels;
+
+	u16* scanline;
+	u16* pixel;
+
+	// Parts of a scanline that should be drawn;
+	u8	 gaps[ 2 * (SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS + 1) ];
+	u8*	 gap;
+	u32	 numGaps;
+	s32	 integerY;
+
+	bool middleVertexRight;
+	bool bottomPartDone = false;
+
+	// Sort the vertices in top to bottom Y-order;
+	if ( v0->m_Y > v1->m_Y ) { vT = v0; v0 = v1; v1 = vT; vT = t0; t0 = t1; t1 = vT; }
+	if ( v1->m_Y > v2->m_Y ) { vT = v1; v1 = v2; v2 = vT; vT = t1; t1 = t2; t2 = vT; }
+	if ( v0->m_Y > v1->m_Y ) { vT = v0; v0 = v1; v1 = vT; vT = t0; t0 = t1; t1 = vT; }
+
+	// Calculate the whole scanlines, using a top left filling convention;
+	y0 = SO_FIXED_CEIL_WHOLE( v0->m_Y );
+	y1 = SO_FIXED_CEIL_WHOLE( v1->m_Y );
+	y2 = SO_FIXED_CEIL_WHOLE( v2->m_Y );
+
+	// Check for triangles that don't cover a single scanline;
+	if ( y0 == y2 ) return;
+
+	// Go from [0..1] texture coordinates to [0..width or height] texel coordinates;
+	u0 = t0->m_X << a_UShift;
+	u1 = t1->m_X << a_UShift;
+	u2 = t2->m_X << a_UShift;
+	w0 = t0->m_Y << a_VShift;
+	w1 = t1->m_Y << a_VShift;
+	w2 = t2->m_Y << a_VShift;
+
+	// Find the point on the long edge at the height of the middle vertex;
+	ooLongHeight = SO_FIXED_ONE_OVER_ARM( v2->m_Y - v0->m_Y );
+	longT = SO_FIXED_MULTIPLY_LONG( v1->m_Y - v0->m_Y, ooLongHeight );
+	longX = v0->m_X + SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, longT );
+	longU = u0		+ SO_FIXED_MULTIPLY_LONG( u2 - u0, longT );
+	longV = w0		+ SO_FIXED_MULTIPLY_LONG( w2 - w0, longT );
+
+	// The span from there to the middle vertex is the widest of the triangle, so
+	// it gives the most accurate gradients;
+	width = v1->m_X - longX;
+	middleVertexRight = width > 0;
+	width = SO_ABS( width );
+
+	// Calculate the gradients, unless the triangle is less than a pixel wide;
+	if ( width >= SO_FIXED_FROM_WHOLE( 1 ) )
+	{
+		ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE( width );
+		gradientU = SO_FIXED_MULTIPLY_LONG( u1 - longU, ooQ );
+		gradientV = SO_FIXED_MULTIPLY_LONG( w1 - longV, ooQ );
+
+		if ( ! middleVertexRight )
+		{
+			gradientU = -gradientU;
+			gradientV = -gradientV;
+		}
+	}
+	else
+	{
+		gradientU = 0;
+		gradientV = 0;
+	}
+
+	// Calculate the subpixel offset to the first scanline;
+	yShift = SO_FIXED_FROM_WHOLE( y0 ) - v0->m_Y;
+
+	// Setup the long edge, and the top half of the short edge;
+	if ( middleVertexRight )
+	{
+		tangentLeftX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, ooLongHeight );
+		tangentLeftU = SO_FIXED_MULTIPLY_LONG( u2 - u0,			  ooLongHeight );
+		tangentLeftV = SO_FIXED_MULTIPLY_LONG( w2 - w0,			  ooLongHeight );
+
+		ooQ = SO_FIXED_ONE_OVER_ARM( v1->m_Y - v0->m_Y );
+		tangentRightX = SO_FIXED_MULTIPLY_LONG( v1->m_X - v0->m_X, ooQ );
+	}
+	else
+	{
+		ooQ = SO_FIXED_ONE_OVER_ARM( v1->m_Y - v0->m_Y );
+		tangentLeftX = SO_FIXED_MULTIPLY_LONG( v1->m_X - v0->m_X, ooQ );
+		tangentLeftU = SO_FIXED_MULTIPLY_LONG( u1 - u0,			  ooQ );
+		tangentLeftV = SO_FIXED_MULTIPLY_LONG( w1 - w0,			  ooQ );
+
+		tangentRightX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, ooLongHeight );
+	}
+
+	// Subpixel correct the starting values;
+	fixedLeftX  = v0->m_X + SO_FIXED_MULTIPLY_LONG( tangentLeftX,  yShift );
+	fixedLeftU  = u0	  + SO_FIXED_MULTIPLY_LONG( tangentLeftU,  yShift );
+	fixedLeftV  = w0	  + SO_FIXED_MULTIPLY_LONG( tangentLeftV,  yShift );
+	fixedRightX = v0->m_X + SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
+
+	// Calculate the starting scanline pointer;
+	scanline = g_SoMode4PolygonRasterizerBuffer + pitch * y0;
+	integerY = y0;
+
+	// Calculate the height of the top half;
+	integerDeltaY = y1 - y0;
+
+	// Break out after the second triangle half;
+	while ( true )
+	{
+		// Skip the rows above the render target;
+		if ( integerY < 0 && integerDeltaY > 0 )
+		{
+			yShift = SO_MIN( -integerY, integerDeltaY );
+
+			integerY	  += yShift;
+			integerDeltaY -= yShift;
+			scanline	  += pitch * yShift;
+			fixedLeftX	  += tangentLeftX * yShift;
+			fixedLeftU	  += tangentLeftU * yShift;
+			fixedLeftV	  += tangentLeftV * yShift;
+			fixedRightX	  += tangentRightX * yShift;
+		}
+
+		// Stop at the bottom of the render target;
+		if ( integerY + integerDeltaY > targetHeight )
+		{
+			integerDeltaY  = SO_MAX( targetHeight - integerY, 0 );
+			bottomPartDone = true;
+		}
+
+		// Iterate over the triangle-half;
+		while ( integerDeltaY-- )
+		{
+			// Get the scanline start and end;
+			integerLeftX  = SO_FIXED_CEIL_WHOLE( fixedLeftX  );
+			integerRightX = SO_FIXED_CEIL_WHOLE( fixedRightX );
+
+			// The reciprocal table is not exact, so never leave the screen;
+			if ( integerLeftX  < 0 )				integerLeftX  = 0;
+			if ( integerRightX > targetWidth ) integerRightX = targetWidth;
+
+			// Get the length;
+			scanlineLength = integerRightX - integerLeftX;
+
+			// Is there a scanline;
+			if ( scanlineLength > 0 )
+			{
+				// Find the parts of it that should be drawn;
+				numGaps = SO_MODE4_POLYGON_RASTERIZER_FIND_GAPS( integerY, integerLeftX, integerRightX, gaps );
+
+				for ( gap = gaps; numGaps--; gap += 2 )
+				{
+					scanlineLength = gap[ 1 ] - gap[ 0 ];
+
+					// Subpixel correct the texture coordinates to the first pixel;
+					xShift = SO_FIXED_FROM_WHOLE( gap[ 0 ] ) - fixedLeftX;
+					u = fixedLeftU + SO_FIXED_MULTIPLY_LONG( gradientU, xShift );
+					v = fixedLeftV + SO_FIXED_MULTIPLY_LONG( gradientV, xShift );
+
+					// Get the pixel pointer on a 16 bit boundary;
+					pixel = scanline + (gap[ 0 ] >> 1);
+
+					// Same as below, but through SoMode4PolygonRasterizerWriteTexels;
+					if ( mode != SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE )
+					{
+						if ( gap[ 0 ] & 1 )
+						{
+							texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							SoMode4PolygonRasterizerWriteTexels( pixel++, texels << 8, 0xFF00, mode, fade, inverseFade );
+
+							u += gradientU;
+							v += gradientV;
+							--scanlineLength;
+						}
+
+						pixelDuos = scanlineLength >> 1;
+
+						while ( pixelDuos-- )
+						{
+							texels  = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							u += gradientU;
+							v += gradientV;
+
+							texels |= texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ] << 8;
+							u += gradientU;
+							v += gradientV;
+
+							SoMode4PolygonRasterizerWriteTexels( pixel++, texels, 0xFFFF, mode, fade, inverseFade );
+						}
+
+						if ( scanlineLength & 1 )
+						{
+							texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							SoMode4PolygonRasterizerWriteTexels( pixel, texels, 0x00FF, mode, fade, inverseFade );
+						}
+
+						continue;
+					}
+
+					// Is there a funky first pixel;
+					if ( gap[ 0 ] & 1 )
+					{
+						texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+						*pixel = (*pixel & 0x00FF) | (texels << 8);
+						pixel++;
+
+						u += gradientU;
+						v += gradientV;
+						--scanlineLength;
+					}
+
+					// From now on, we plot two pixels at once;
+					pixelDuos = scanlineLength >> 1;
+
+					// Draw the line;
+					while ( pixelDuos-- )
+					{
+						texels  = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+						u += gradientU;
+						v += gradientV;
+
+						texels |= texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ] << 8;
+						u += gradientU;
+						v += gradientV;
+
+						*pixel++ = texels;
+					}
+
+					// Is there a funky last pixel;
+					if ( scanlineLength & 1 )
+					{
+						texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+						*pixel = (*pixel & 0xFF00) | texels;
+					}
+				}
+			}
+
+			// Go to the next line;
+			scanline += pitch;
+			integerY++;
+
+			// Add the tangents;
+			fixedLeftX	+= tangentLeftX;
+			fixedLeftU	+= tangentLeftU;
+			fixedLeftV	+= tangentLeftV;
+			fixedRightX	+= tangentRightX;
+		}
+
+		// Is the bottom half done;
+		if ( bottomPartDone ) return; else bottomPartDone = true;
+
+		// Calculate the height of the bottom half;
+		integerDeltaY = y2 - y1;
+
+		// Maybe we're done already;
+		if ( ! integerDeltaY ) return;
+
+		// Setup the bottom half of the short edge;
+		ooQ	   = SO_FIXED_ONE_OVER_ARM( v2->m_Y - v1->m_Y );
+		yShift = SO_FIXED_FROM_WHOLE( y1 ) - v1->m_Y;
+
+		if ( middleVertexRight )
+		{
+			tangentRightX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v1->m_X, ooQ );
+			fixedRightX   = v1->m_X + SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
+		}
+		else
+		{
+			tangentLeftX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v1->m_X, ooQ );
+			tangentLeftU = SO_FIXED_MULTIPLY_LONG( u2 - u1,			  ooQ );
+			tangentLeftV = SO_FIXED_MULTIPLY_LONG( w2 - w1,			  ooQ );
+
+			fixedLeftX = v1->m_X + SO_FIXED_MULTIPLY_LONG( tangentLeftX, yShift );
+			fixedLeftU = u1		 + SO_FIXED_MULTIPLY_LONG( tangentLeftU, yShift );
+			fixedLeftV = w1		 + SO_FIXED_MULTIPLY_LONG( tangentLeftV, yShift );
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a perspective correct textured 2D triangle.
+
+	\param a_Triangle				Array of 3 \a SoVector2 objects, which are the three
+									corner points of the triangle, in a fixed point format.
+									They need to be within the width of the render target,
+									rows above and below it are skipped.
+	\param a_TextureCoordinates		Array of 3 \a SoVector2 objects that are the texture
+									coordinates of the corner points, in the [0..1] range.
+	\param a_Depths					Array of 3 fixed point camera space Z values of the corner
+									points. These should be in between the near and far plane.
+	\param a_SpanLength				Number of pixels between two perspective divides. Must be a
+									power of two between 2 and 64.
+
+	Draws the triangle with the texture set by \a SoMode4PolygonRasterizerSetTexture,
+	in the mode set by \a SoMode4PolygonRasterizerSetTextureMode.
+
+	Instead of U and V, this routine interpolates 1/Z, U/Z and V/Z over the triangle,
+	since those are linear in screen space. Dividing them back to U and V for every
+	pixel would be way too slow, so a scanline is cut in spans of \a a_SpanLength
+	pixels (aligned to multiples of \a a_SpanLength on the screen, so that every span
+	but the first starts at an even pixel). The real U and V are calculated at the end
+	of every span with a single bios divide, and interpolated affinely inside the span.
+
+	The 1/Z values are scaled by 2^30 / 2^8, so for Z in between the near and far plane
+	they stay well inside 32 bits with plenty of precision. U/Z and V/Z use the same 
+	scale.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle( SoVector2	   a_Triangle[ 3 ],
+															  SoVector2	   a_TextureCoordinates[ 3 ],
+															  sofixedpoint a_Depths[ 3 ],
+															  u32		   a_SpanLength )
+{
+	// Vertices, their texture coordinates and their depths;
+	SoVector2* v0 = &a_Triangle[ 0 ];
+	SoVector2* v1 = &a_Triangle[ 1 ];
+	SoVector2* v2 = &a_Triangle[ 2 ];
+	SoVector2* t0 = &a_TextureCoordinates[ 0 ];
+	SoVector2* t1 = &a_TextureCoordinates[ 1 ];
+	SoVector2* t2 = &a_TextureCoordinates[ 2 ];
+	sofixedpoint* z0 = &a_Depths[ 0 ];
+	sofixedpoint* z1 = &a_Depths[ 1 ];
+	sofixedpoint* z2 = &a_Depths[ 2 ];
+	SoVector2*	  vT;	// Temporary vector for swapping;
+	sofixedpoint* zT;	// Temporary depth for swapping;
+
+	// Local copies of the texture state, see SoMode4PolygonRasterizerDrawTexturedTriangle;
+	u8* texture = g_SoMode4PolygonRasterizerTextureData;
+	s32 uMask	= g_SoMode4PolygonRasterizerTextureUMask;
+	s32 vMask	= g_SoMode4PolygonRasterizerTextureVMask << g_SoMode4PolygonRasterizerTextureUShift;
+	s32 vShift	= SO_FIXED_Q - g_SoMode4PolygonRasterizerTextureUShift;
+	s32 spanMask = a_SpanLength - 1;
+
+	// Texture mode, see SoMode4PolygonRasterizerSetTextureMode;
+	u32		  mode		  = g_SoMode4PolygonRasterizerTextureMode;
+	const u8* fade		  = &g_Fade[ g_SoMode4PolygonRasterizerTextureFade << 8 ];
+	const u8* inverseFade = &g_Fade[ (SO_FADE_MAX - g_SoMode4PolygonRasterizerTextureFade) << 8 ];
+
+	// Render target size, see SoMode4PolygonRasterizerSetRenderTarget;
+	s32 targetWidth  = g_SoMode4PolygonRasterizerBufferWidth;
+	s32 targetHeight = g_SoMode4PolygonRasterizerBufferHeight;
+	s32 pitch		 = g_SoMode4PolygonRasterizerBufferPitch;
+
+	// 1/Z, U/Z and V/Z of each vertex;
+	s32 o0, o1, o2;
+	s32 uo0, uo1, uo2;
+	s32 vo0, vo1, vo2;
+
+	// Whole top, middle and bottom scanlines;
+	s32 y0, y1, y2;
+
+	// Values at the long edge (v0 to v2) at the height of the middle vertex;
+	sofixedpoint ooLongHeight;
+	sofixedpoint longT;
+	s32 longX, longO, longUO, longVO;
+	sofixedpoint width;
+
+	// Constant gradients along each scanline;
+	s32 gradientO, gradientUO, gradientVO;
+
+	// Edge values;
+	sofixedpoint fixedLeftX,   fixedRightX;
+	sofixedpoint tangentLeftX, tangentRightX;
+	s32 leftO, leftUO, leftVO;
+	s32 tangentLeftO, tangentLeftUO, tangentLeftVO;
+	sofixedpoint ooQ;
+	sofixedpoint xShift, yShift;
+
+	// Scanline values;
+	s32 integerDeltaY;
+	s32 integerLeftX;
+	s32 integerRightX;
+	s32 scanlineLength;
+	s32 spanLength;
+	s32 pixelDuos;
+	s32 o, uo, vo, z;
+	sofixedpoint u, v, endU, endV, gradientU, gradientV;
+	u32 texels;
+
+	u16* scanline;
+	u16* pixel;
+
+	// Parts of a scanline that should be drawn;
+	u8	 gaps[ 2 * (SO_MODE4_POLYGON_RASTERIZER_SPAN_BUFFER_MAX_SPANS + 1) ];
+	u8*	 gap;
+	u32	 numGaps;
+	s32	 integerY;
+
+	bool middleVertexRight;
+	bool bottomPartDone = false;
+
+	// Sort the vertices in top to bottom Y-order;
+	if ( v0->m_Y > v1->m_Y ) { vT = v0; v0 = v1; v1 = vT; vT = t0; t0 = t1; t1 = vT; zT = z0; z0 = z1; z1 = zT; }
+	if ( v1->m_Y > v2->m_Y ) { vT = v1; v1 = v2; v2 = vT; vT = t1; t1 = t2; t2 = vT; zT = z1; z1 = z2; z2 = zT; }
+	if ( v0->m_Y > v1->m_Y ) { vT = v0; v0 = v1; v1 = vT; vT = t0; t0 = t1; t1 = vT; zT = z0; z0 = z1; z1 = zT; }
+
+	// Calculate the whole scanlines, using a top left filling convention;
+	y0 = SO_FIXED_CEIL_WHOLE( v0->m_Y );
+	y1 = SO_FIXED_CEIL_WHOLE( v1->m_Y );
+	y2 = SO_FIXED_CEIL_WHOLE( v2->m_Y );
+
+	// Check for triangles that don't cover a single scanline;
+	if ( y0 == y2 ) return;
+
+	// Calculate the 1/Z, U/Z and V/Z values, with U and V in texel space;
+	o0	= SO_MATH_DIVIDE_ARM( 1 << 30, (*z0) >> 8 );
+	o1	= SO_MATH_DIVIDE_ARM( 1 << 30, (*z1) >> 8 );
+	o2	= SO_MATH_DIVIDE_ARM( 1 << 30, (*z2) >> 8 );
+	uo0 = SO_FIXED_MULTIPLY_LONG( t0->m_X << g_SoMode4PolygonRasterizerTextureUShift, o0 );
+	uo1 = SO_FIXED_MULTIPLY_LONG( t1->m_X << g_SoMode4PolygonRasterizerTextureUShift, o1 );
+	uo2 = SO_FIXED_MULTIPLY_LONG( t2->m_X << g_SoMode4PolygonRasterizerTextureUShift, o2 );
+	vo0 = SO_FIXED_MULTIPLY_LONG( t0->m_Y << g_SoMode4PolygonRasterizerTextureVShift, o0 );
+	vo1 = SO_FIXED_MULTIPLY_LONG( t1->m_Y << g_SoMode4PolygonRasterizerTextureVShift, o1 );
+	vo2 = SO_FIXED_MULTIPLY_LONG( t2->m_Y << g_SoMode4PolygonRasterizerTextureVShift, o2 );
+
+	// Find the point on the long edge at the height of the middle vertex;
+	ooLongHeight = SO_FIXED_ONE_OVER_ARM( v2->m_Y - v0->m_Y );
+	longT  = SO_FIXED_MULTIPLY_LONG( v1->m_Y - v0->m_Y, ooLongHeight );
+	longX  = v0->m_X + SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, longT );
+	longO  = o0		 + SO_FIXED_MULTIPLY_LONG( o2  - o0,  longT );
+	longUO = uo0	 + SO_FIXED_MULTIPLY_LONG( uo2 - uo0, longT );
+	longVO = vo0	 + SO_FIXED_MULTIPLY_LONG( vo2 - vo0, longT );
+
+	// Use the widest span for the gradients;
+	width = v1->m_X - longX;
+	middleVertexRight = width > 0;
+	width = SO_ABS( width );
+
+	// Calculate the gradients, unless the triangle is less than a pixel wide;
+	if ( width >= SO_FIXED_FROM_WHOLE( 1 ) )
+	{
+		ooQ = SO_FIXED_ONE_OVER_FAST_INACCURATE( width );
+		gradientO  = SO_FIXED_MULTIPLY_LONG( o1  - longO,  ooQ );
+		gradientUO = SO_FIXED_MULTIPLY_LONG( uo1 - longUO, ooQ );
+		gradientVO = SO_FIXED_MULTIPLY_LONG( vo1 - longVO, ooQ );
+
+		if ( ! middleVertexRight )
+		{
+			gradientO  = -gradientO;
+			gradientUO = -gradientUO;
+			gradientVO = -gradientVO;
+		}
+	}
+	else
+	{
+		gradientO  = 0;
+		gradientUO = 0;
+		gradientVO = 0;
+	}
+
+	// Calculate the subpixel offset to the first scanline;
+	yShift = SO_FIXED_FROM_WHOLE( y0 ) - v0->m_Y;
+
+	// Setup the long edge, and the top half of the short edge;
+	if ( middleVertexRight )
+	{
+		tangentLeftX  = SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, ooLongHeight );
+		tangentLeftO  = SO_FIXED_MULTIPLY_LONG( o2  - o0,		   ooLongHeight );
+		tangentLeftUO = SO_FIXED_MULTIPLY_LONG( uo2 - uo0,		   ooLongHeight );
+		tangentLeftVO = SO_FIXED_MULTIPLY_LONG( vo2 - vo0,		   ooLongHeight );
+
+		ooQ = SO_FIXED_ONE_OVER_ARM( v1->m_Y - v0->m_Y );
+		tangentRightX = SO_FIXED_MULTIPLY_LONG( v1->m_X - v0->m_X, ooQ );
+	}
+	else
+	{
+		ooQ = SO_FIXED_ONE_OVER_ARM( v1->m_Y - v0->m_Y );
+		tangentLeftX  = SO_FIXED_MULTIPLY_LONG( v1->m_X - v0->m_X, ooQ );
+		tangentLeftO  = SO_FIXED_MULTIPLY_LONG( o1  - o0,		   ooQ );
+		tangentLeftUO = SO_FIXED_MULTIPLY_LONG( uo1 - uo0,		   ooQ );
+		tangentLeftVO = SO_FIXED_MULTIPLY_LONG( vo1 - vo0,		   ooQ );
+
+		tangentRightX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v0->m_X, ooLongHeight );
+	}
+
+	// Subpixel correct the starting values;
+	fixedLeftX  = v0->m_X + SO_FIXED_MULTIPLY_LONG( tangentLeftX,  yShift );
+	leftO		= o0	  + SO_FIXED_MULTIPLY_LONG( tangentLeftO,  yShift );
+	leftUO		= uo0	  + SO_FIXED_MULTIPLY_LONG( tangentLeftUO, yShift );
+	leftVO		= vo0	  + SO_FIXED_MULTIPLY_LONG( tangentLeftVO, yShift );
+	fixedRightX = v0->m_X + SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
+
+	// Calculate the starting scanline pointer;
+	scanline = g_SoMode4PolygonRasterizerBuffer + pitch * y0;
+	integerY = y0;
+
+	// Calculate the height of the top half;
+	integerDeltaY = y1 - y0;
+
+	// Break out after the second triangle half;
+	while ( true )
+	{
+		// Skip the rows above the render target;
+		if ( integerY < 0 && integerDeltaY > 0 )
+		{
+			yShift = SO_MIN( -integerY, integerDeltaY );
+
+			integerY	  += yShift;
+			integerDeltaY -= yShift;
+			scanline	  += pitch * yShift;
+			fixedLeftX	  += tangentLeftX * yShift;
+			leftO		  += tangentLeftO * yShift;
+			leftUO		  += tangentLeftUO * yShift;
+			leftVO		  += tangentLeftVO * yShift;
+			fixedRightX	  += tangentRightX * yShift;
+		}
+
+		// Stop at the bottom of the render target;
+		if ( integerY + integerDeltaY > targetHeight )
+		{
+			integerDeltaY  = SO_MAX( targetHeight - integerY, 0 );
+			bottomPartDone = true;
+		}
+
+		// Iterate over the triangle-half;
+		while ( integerDeltaY-- )
+		{
+			// Get the scanline start and end;
+			integerLeftX  = SO_FIXED_CEIL_WHOLE( fixedLeftX  );
+			integerRightX = SO_FIXED_CEIL_WHOLE( fixedRightX );
+
+			// The reciprocal table is not exact, so never leave the screen;
+			if ( integerLeftX  < 0 )				integerLeftX  = 0;
+			if ( integerRightX > targetWidth ) integerRightX = targetWidth;
+
+			// Get the length;
+			scanlineLength = integerRightX - integerLeftX;
+
+			// Is there a scanline;
+			if ( scanlineLength > 0 )
+			{
+				// Find the parts of it that should be drawn;
+				numGaps = SO_MODE4_POLYGON_RASTERIZER_FIND_GAPS( integerY, integerLeftX, integerRightX, gaps );
+
+				for ( gap = gaps; numGaps--; gap += 2 )
+				{
+					integerLeftX   = gap[ 0 ];
+					scanlineLength = gap[ 1 ] - gap[ 0 ];
+
+					// Subpixel correct the interpolants to the first pixel;
+					xShift = SO_FIXED_FROM_WHOLE( integerLeftX ) - fixedLeftX;
+					o  = leftO	+ SO_FIXED_MULTIPLY_LONG( gradientO,  xShift );
+					uo = leftUO + SO_FIXED_MULTIPLY_LONG( gradientUO, xShift );
+					vo = leftVO + SO_FIXED_MULTIPLY_LONG( gradientVO, xShift );
+
+					// Do the perspective divide for the first pixel;
+					z = SO_MATH_DIVIDE_ARM( 1 << 30, SO_MAX( o, 1 ) );
+					u = (s32)( ((s64) uo * z) >> 14 );
+					v = (s32)( ((s64) vo * z) >> 14 );
+
+					// Get the pixel pointer on a 16 bit boundary;
+					pixel = scanline + (integerLeftX >> 1);
+
+					// Iterate over the spans;
+					while ( scanlineLength > 0 )
+					{
+						// Find the end of this span;
+						spanLength = a_SpanLength - (integerLeftX & spanMask);
+						if ( spanLength > scanlineLength ) spanLength = scanlineLength;
+
+						integerLeftX   += spanLength;
+						scanlineLength -= spanLength;
+
+						// Do the perspective divide at the end of this span;
+						o  += gradientO  * spanLength;
+						uo += gradientUO * spanLength;
+						vo += gradientVO * spanLength;
+
+						z	 = SO_MATH_DIVIDE_ARM( 1 << 30, SO_MAX( o, 1 ) );
+						endU = (s32)( ((s64) uo * z) >> 14 );
+						endV = (s32)( ((s64) vo * z) >> 14 );
+
+						// Interpolate affinely inside the span;
+						ooQ		  = SO_FIXED_ONE_OVER_FAST_INACCURATE( SO_FIXED_FROM_WHOLE( spanLength ) );
+						gradientU = SO_FIXED_MULTIPLY_LONG( endU - u, ooQ );
+						gradientV = SO_FIXED_MULTIPLY_LONG( endV - v, ooQ );
+
+						// Same as below, but through SoMode4PolygonRasterizerWriteTexels;
+						if ( mode != SO_MODE4_POLYGON_RASTERIZER_TEXTURE_OPAQUE )
+						{
+							if ( (integerLeftX - spanLength) & 1 )
+							{
+								texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+								SoMode4PolygonRasterizerWriteTexels( pixel++, texels << 8, 0xFF00, mode, fade, inverseFade );
+
+								u += gradientU;
+								v += gradientV;
+								--spanLength;
+							}
+
+							pixelDuos = spanLength >> 1;
+
+							while ( pixelDuos-- )
+							{
+								texels  = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+								u += gradientU;
+								v += gradientV;
+
+								texels |= texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ] << 8;
+								u += gradientU;
+								v += gradientV;
+
+								SoMode4PolygonRasterizerWriteTexels( pixel++, texels, 0xFFFF, mode, fade, inverseFade );
+							}
+
+							if ( spanLength & 1 )
+							{
+								texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+								SoMode4PolygonRasterizerWriteTexels( pixel, texels, 0x00FF, mode, fade, inverseFade );
+							}
+
+							u = endU;
+							v = endV;
+							continue;
+						}
+
+						// Is there a funky first pixel. Only the first span can start
+						// at an uneven pixel;
+						if ( (integerLeftX - spanLength) & 1 )
+						{
+							texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							*pixel = (*pixel & 0x00FF) | (texels << 8);
+							pixel++;
+
+							u += gradientU;
+							v += gradientV;
+							--spanLength;
+						}
+
+						// Plot two pixels at once;
+						pixelDuos = spanLength >> 1;
+
+						while ( pixelDuos-- )
+						{
+							texels  = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							u += gradientU;
+							v += gradientV;
+
+							texels |= texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ] << 8;
+							u += gradientU;
+							v += gradientV;
+
+							*pixel++ = texels;
+						}
+
+						// Is there a funky last pixel. Only the last span can end at
+						// an uneven pixel;
+						if ( spanLength & 1 )
+						{
+							texels = texture[ ((v >> vShift) & vMask) + ((u >> SO_FIXED_Q) & uMask) ];
+							*pixel = (*pixel & 0xFF00) | texels;
+						}
+
+						// Continue exactly where this span ended;
+						u = endU;
+						v = endV;
+					}
+				}
+			}
+
+			// Go to the next line;
+			scanline += pitch;
+			integerY++;
+
+			// Add the tangents;
+			fixedLeftX	+= tangentLeftX;
+			leftO		+= tangentLeftO;
+			leftUO		+= tangentLeftUO;
+			leftVO		+= tangentLeftVO;
+			fixedRightX	+= tangentRightX;
+		}
+
+		// Is the bottom half done;
+		if ( bottomPartDone ) return; else bottomPartDone = true;
+
+		// Calculate the height of the bottom half;
+		integerDeltaY = y2 - y1;
+
+		// Maybe we're done already;
+		if ( ! integerDeltaY ) return;
+
+		// Setup the bottom half of the short edge;
+		ooQ	   = SO_FIXED_ONE_OVER_ARM( v2->m_Y - v1->m_Y );
+		yShift = SO_FIXED_FROM_WHOLE( y1 ) - v1->m_Y;
+
+		if ( middleVertexRight )
+		{
+			tangentRightX = SO_FIXED_MULTIPLY_LONG( v2->m_X - v1->m_X, ooQ );
+			fixedRightX   = v1->m_X + SO_FIXED_MULTIPLY_LONG( tangentRightX, yShift );
+		}
+		else
+		{
+			tangentLeftX  = SO_FIXED_MULTIPLY_LONG( v2->m_X - v1->m_X, ooQ );
+			tangentLeftO  = SO_FIXED_MULTIPLY_LONG( o2  - o1,		   ooQ );
+			tangentLeftUO = SO_FIXED_MULTIPLY_LONG( uo2 - uo1,		   ooQ );
+			tangentLeftVO = SO_FIXED_MULTIPLY_LONG( vo2 - vo1,		   ooQ );
+
+			fixedLeftX = v1->m_X + SO_FIXED_MULTIPLY_LONG( tangentLeftX,  yShift );
+			leftO	   = o1		 + SO_FIXED_MULTIPLY_LONG( tangentLeftO,  yShift );
+			leftUO	   = uo1	 + SO_FIXED_MULTIPLY_LONG( tangentLeftUO, yShift );
+			leftVO	   = vo1	 + SO_FIXED_MULTIPLY_LONG( tangentLeftVO, yShift );
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
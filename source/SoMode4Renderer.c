@@ -34,6 +34,12 @@
 //! \internal Pointer to the second mode 4 buffer
 #define SO_SCREEN_BUFFER_1			((u16*)0x600A000)
 
+//! \internal Maximum number of glyphs \a SoMode4RendererDrawText puts on one line, longer lines are wrapped.
+#define SO_MODE4_RENDERER_MAX_GLYPHS_PER_LINE	64
+
+//! \internal Index of the current backbuffer in the dirty rectangle arrays.
+#define SO_MODE4_RENDERER_BACK_BUFFER_INDEX	( s_SoMode4RendererBackBuffer == SO_SCREEN_BUFFER_0 ? 0 : 1 )
+
 // ----------------------------------------------------------------------------
 // Variables;
 // ----------------------------------------------------------------------------
@@ -42,6 +48,45 @@
 //! Not static because we need it in an assembly file too.
 u16* s_SoMode4RendererBackBuffer;
 
+//! \internal True if drawing into the buffers is tracked, see \a SoMode4RendererSetDirtyRectanglesEnable.
+static bool s_DirtyRectanglesEnabled = false;
+
+//! \internal Rectangles drawn into each of the two buffers since they were last cleared.
+static SoMode4RendererRectangle s_DirtyRectangles[ 2 ][ SO_MODE4_RENDERER_MAX_NUM_DIRTY_RECTANGLES ];
+
+//! \internal Number of rectangles in \a s_DirtyRectangles, per buffer.
+static u32 s_NumDirtyRectangles[ 2 ] = { 0, 0 };
+
+//! \internal Bounds of everything \a SoMode4RendererClearDirtyRectangles cleared last.
+static SoMode4RendererRectangle s_ClearedRectangle = { 0, 0, 0, 0 };
+
+//! \internal Faded and inversely faded palette indices of one fade level, 
+//! copied from \a g_Fade into IWRAM. See \a SoMode4RendererDrawCrossFadeImage.
+//!
+//! A pixel takes two lookups, one in each half, and an add. A table that does
+//! it in one lookup needs an entry for every pair of palette indices, which is
+//! 64 KB for a single fade level, twice all of IWRAM. The two rows of \a g_Fade
+//! of a level always add up to at most 255, so the sums of the four pixels of
+//! a word never carry into each other. One table keeps both rows within reach
+//! of a single base register.
+static u32 s_CrossFadeTable[ 512 / 4 ];
+
+//! \internal Fade level \a s_CrossFadeTable is for, \a SO_FADE_STEPS if none.
+static u32 s_CrossFadeTableLevel = SO_FADE_STEPS;
+
+// ----------------------------------------------------------------------------
+// Forward declarations of private functions;
+// ----------------------------------------------------------------------------
+void SoMode4RendererBlitScanline( u16* a_Scanline, s32 a_X, s32 a_NumPixels, 
+								  const u8* a_Source, s32 a_Step, bool a_Transparent );
+
+// ----------------------------------------------------------------------------
+// Private functions implemented in assembly (documentation in .s file);
+// ----------------------------------------------------------------------------
+void SoMode4RendererCrossFadeWords( u32* a_Destination, const u32* a_Image0, 
+									const u32* a_Image1, u32 a_NumWords,
+									const u8* a_CrossFadeTable ) SO_IWRAM_CODE;
+
 // ----------------------------------------------------------------------------
 // Function implementations;
 // ----------------------------------------------------------------------------
@@ -157,6 +202,8 @@ void SoMode4RendererDrawPixel( u32 a_X, u32 a_Y, u32 a_PalIndex )
 
 	// Place them back in memory;
 	*pointerToPixels = pixels;
+
+	SoMode4RendererAddDirtyRectangle( a_X, a_Y, a_X + 1, a_Y + 1 );
 }
 // ----------------------------------------------------------------------------
 
@@ -179,6 +226,8 @@ void SoMode4RendererDrawImage( const SoImage* a_Image )
 					SoMode4RendererGetBuffer(),
 					SO_SCREEN_HALF_WIDTH * SO_SCREEN_HEIGHT,
 					SO_DMA_16 | SO_DMA_START_NOW );
+
+	SoMode4RendererAddDirtyRectangle( 0, 0, SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT );
 }
 // ----------------------------------------------------------------------------
 
@@ -190,6 +239,9 @@ void SoMode4RendererDrawImage( const SoImage* a_Image )
 
 	\warning Only pixelduo's are considered to be transparent. This means that only
 			 if a single u16 value (two pixels) equals zero it is not drawn. 
+
+	Every pixel pair of the image is tested. For images that are mostly transparent
+	\a SoMode4RendererDrawRLEImage is a lot faster.
 */
 // ----------------------------------------------------------------------------
 void SoMode4RendererDrawTransparentImage( const SoImage* a_Image )
@@ -219,6 +271,8 @@ void SoMode4RendererDrawTransparentImage( const SoImage* a_Image )
 			buffer++;
 		}		
 	}
+
+	SoMode4RendererAddDirtyRectangle( 0, 0, SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT );
 }
 // ----------------------------------------------------------------------------
 
@@ -237,6 +291,15 @@ void SoMode4RendererDrawTransparentImage( const SoImage* a_Image )
 		destPixel = srcPixel0 *      (a_Fade / SO_FADE_MAX) 
 				  + srcPixel1 * (1 - (a_Fade / SO_FADE_MAX));
 	\endcode
+
+	When both images are on a 32 bit boundary, which they are if they come from
+	the converter, the work is done by an ARM routine in IWRAM that does four 
+	pixels at a time. Words that are the same in both images are just copied. 
+	The two rows of \a g_Fade it needs are copied into IWRAM first, when the fade
+	level differs from the previous call, so no lookup has to wait for the ROM. 
+	That makes full screen transitions fast enough to run every frame. The
+	ARM routine draws exactly what the C loop below draws, which 
+	tools/SoCrossFadeTest checks in an emulator.
 */
 // ----------------------------------------------------------------------------
 void SoMode4RendererDrawCrossFadeImage( const SoImage* a_Image0, const SoImage* a_Image1, u32 a_Fade )
@@ -259,6 +322,29 @@ void SoMode4RendererDrawCrossFadeImage( const SoImage* a_Image0, const SoImage*
 	const u8* crossFade	 = &g_Fade[ a_Fade << 8 ];
 	const u8* invCrossFade = &g_Fade[ (SO_FADE_MAX - a_Fade) << 8 ];
 	
+	SoMode4RendererAddDirtyRectangle( 0, 0, SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT );
+
+	// Can we do four pixels at a time;
+	if ( (((u32) image0 | (u32) image1) & 3) == 0 )
+	{
+		// Put the two table lines in IWRAM, one after the other;
+		if ( s_CrossFadeTableLevel != a_Fade )
+		{
+			for ( i = 0; i < 256; i++ )
+			{
+				((u8*) s_CrossFadeTable)[ i		  ] = crossFade[ i ];
+				((u8*) s_CrossFadeTable)[ i + 256 ] = invCrossFade[ i ];
+			}
+
+			s_CrossFadeTableLevel = a_Fade;
+		}
+
+		SoMode4RendererCrossFadeWords( (u32*) buffer, (const u32*) image0, (const u32*) image1,
+									   (SO_SCREEN_HALF_WIDTH * SO_SCREEN_HEIGHT) >> 1,
+									   (const u8*) s_CrossFadeTable );
+		return;
+	}
+
 	// Clear the buffer;
 	for ( i = (SO_SCREEN_HALF_WIDTH*SO_SCREEN_HEIGHT); i != 0; i-- ) 
 	{
@@ -295,6 +381,527 @@ void SoMode4RendererDrawCrossFadeImage( const SoImage* a_Image0, const SoImage*
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws (part of) an image of any size into the current backbuffer.
+
+	\param a_Image		A palettized \a SoImage instance.
+	\param a_X			Screen X of the top left pixel of the part that is drawn.
+	\param a_Y			Screen Y of the top left pixel of the part that is drawn.
+	\param a_Source		Part of the image you want to draw, or \a NULL for all of it.
+	\param a_Flags		Any combination of \a SO_MODE4_RENDERER_BLIT_TRANSPARENT and 
+						\a SO_MODE4_RENDERER_BLIT_FLIP_X, or 0.
+
+	This is the software sprite of mode 4. The image is clipped against the 
+	screen, so it can be partly or completely offscreen, and both the image and
+	the screen position can start at odd pixels.
+
+	When the source and the screen line up on a pixel pair, and the image is 
+	neither transparent nor flipped, scanlines are copied a word (four pixels) at 
+	a time where both are on a 32 bit boundary, and a pixel pair at a time 
+	otherwise. In all other cases every pixel pair is put together from two 
+	source pixels first, and only pairs that are half transparent are read.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y, 
+						  const SoMode4RendererRectangle* a_Source, u32 a_Flags )
+{
+	// Part of the image to draw, the right and bottom are exclusive;
+	s32 left, top, right, bottom;
+
+	// Pixels that fall off the right or bottom of the screen;
+	s32 overflow;
+
+	s32  width = SoImageGetWidth( a_Image );
+	bool flip  = (a_Flags & SO_MODE4_RENDERER_BLIT_FLIP_X) != 0;
+	s32  y;
+
+	const u8* source;
+	u16*	  scanline;
+
+	// Assert the input image;
+	SO_ASSERT( SoImageIsPalettized( a_Image ), "Image must be palettized." );
+
+	if ( a_Source )
+	{
+		SO_ASSERT( a_Source->m_Left >= 0 && a_Source->m_Right  <= SoImageGetWidth(  a_Image ) &&
+				   a_Source->m_Top  >= 0 && a_Source->m_Bottom <= SoImageGetHeight( a_Image ),
+				   "Source rectangle must lie inside the image." );
+
+		left   = a_Source->m_Left;
+		top	   = a_Source->m_Top;
+		right  = a_Source->m_Right;
+		bottom = a_Source->m_Bottom;
+	}
+	else
+	{
+		left   = 0;
+		top	   = 0;
+		right  = width;
+		bottom = SoImageGetHeight( a_Image );
+	}
+
+	// Clip against the screen. When flipped, the left of the screen 
+	// shows the right of the image;
+	if ( a_X < 0 )
+	{
+		if ( flip ) right += a_X; else left -= a_X;
+		a_X = 0;
+	}
+
+	if ( a_Y < 0 )
+	{
+		top -= a_Y;
+		a_Y  = 0;
+	}
+
+	overflow = a_X + (right - left) - SO_SCREEN_WIDTH;
+	if ( overflow > 0 )
+	{
+		if ( flip ) left += overflow; else right -= overflow;
+	}
+
+	overflow = a_Y + (bottom - top) - SO_SCREEN_HEIGHT;
+	if ( overflow > 0 ) bottom -= overflow;
+
+	if ( right <= left || bottom <= top ) return;
+
+	SoMode4RendererAddDirtyRectangle( a_X, a_Y, a_X + right - left, a_Y + bottom - top );
+
+	// Draw the scanlines, reading flipped ones from right to left;
+	source	 = (const u8*) SoImageGetData( a_Image ) + width * top + (flip ? right - 1 : left);
+	scanline = s_SoMode4RendererBackBuffer + SO_SCREEN_HALF_WIDTH * a_Y;
+
+	for ( y = top; y < bottom; y++ )
+	{
+		SoMode4RendererBlitScanline( scanline, a_X, right - left, source, flip ? -1 : 1, 
+									 (a_Flags & SO_MODE4_RENDERER_BLIT_TRANSPARENT) != 0 );
+
+		source	 += width;
+		scanline += SO_SCREEN_HALF_WIDTH;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Fills in an affine matrix that rotates and scales an image.
+
+	\param a_Matrix		Matrix to fill in, see \a SoMode4RendererDrawAffineImage.
+	\param a_Angle		Clockwise angle on the screen, 256 steps for a full circle.
+	\param a_Scale		Size on the screen, 16.16 fixed point. \a SO_FIXED_FROM_WHOLE( 1 )
+						draws the image at its own size.
+
+	The matrix maps the screen to the image, so it holds the inverse rotation 
+	divided by the scale. That costs one divide, so keep the matrix around if 
+	the angle and scale don't change.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererMakeAffineMatrix( sofixedpoint a_Matrix[ 4 ], u32 a_Angle, sofixedpoint a_Scale )
+{
+	sofixedpoint oneOverScale;
+
+	SO_ASSERT( a_Scale >= 4, "Scale must be larger than zero." );
+
+	oneOverScale = SO_FIXED_ONE_OVER_SLOW_ACCURATE( a_Scale );
+
+	a_Matrix[ 0 ] =	 SoMathFixedMultiply( SO_COSINE( a_Angle ), oneOverScale );
+	a_Matrix[ 1 ] =	 SoMathFixedMultiply( SO_SINE(	 a_Angle ), oneOverScale );
+	a_Matrix[ 2 ] = -a_Matrix[ 1 ];
+	a_Matrix[ 3 ] =	 a_Matrix[ 0 ];
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Narrows a span to the pixels whose texture coordinate lies inside the image.
+
+	\internal
+
+	\param a_U			Texture coordinate at the start of the span, 16.16 fixed point.
+	\param a_Step		Texture coordinate step per pixel, 16.16 fixed point.
+	\param a_Size		Width or height of the image, 16.16 fixed point.
+	\param a_First		First pixel of the span, relative to its start. Only increased.
+	\param a_Last		Pixel just after the span, relative to its start. Only decreased,
+						and never below \a a_First.
+
+	Solves 0 <= \a a_U + \a a_Step * k < \a a_Size for k. Everything is positive
+	when dividing, so the truncating divide is exact, and the divides are skipped
+	when the span already lies inside.
+*/
+// ----------------------------------------------------------------------------
+static void SoMode4RendererClipAffineSpan( s32 a_U, s32 a_Step, s32 a_Size, s32* a_First, s32* a_Last )
+{
+	s32 u0, u1, k;
+
+	if ( *a_First >= *a_Last ) return;
+
+	u0 = a_U + a_Step * *a_First;
+	u1 = a_U + a_Step * (*a_Last - 1);
+
+	if ( a_Step < 0 )
+	{
+		// Walk the other way around, so the step is positive;
+		a_U	   = a_Size - 1 - a_U;
+		a_Step = -a_Step;
+		u0	   = a_Size - 1 - u0;
+		u1	   = a_Size - 1 - u1;
+	}
+
+	if ( a_Step == 0 )
+	{
+		if ( u0 < 0 || u0 >= a_Size ) *a_Last = *a_First;
+		return;
+	}
+
+	// First pixel that isn't left of the image;
+	if ( u0 < 0 )
+	{
+		k = SoMathDivide( a_Step - 1 - a_U, a_Step );
+		if ( k > *a_First ) *a_First = SO_MIN( k, *a_Last );
+	}
+
+	// Pixel just after the last one that isn't right of the image;
+	if ( u1 >= a_Size )
+	{
+		k = a_U >= a_Size ? 0 : SoMathDivide( a_Size - a_U + a_Step - 1, a_Step );
+		if ( k < *a_Last ) *a_Last = SO_MAX( k, *a_First );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a rotated and scaled image into the current backbuffer.
+
+	\param a_Image			Image to draw, palettized.
+	\param a_Destination	Part of the screen the image is drawn in, or \a NULL for 
+							the whole screen. The center of the image is put in 
+							the center of this rectangle. It can lie partly or 
+							completely offscreen.
+	\param a_Matrix			2x2 matrix in 16.16 fixed point, {a, b, c, d}, that maps 
+							screen offsets from the center of \a a_Destination to
+							image offsets from the center of the image:
+							u = a * x + b * y, and v = c * x + d * y. 
+							Use \a SoMode4RendererMakeAffineMatrix for rotozooming.
+	\param a_Flags			Any combination of \a SO_MODE4_RENDERER_BLIT_TRANSPARENT and 
+							\a SO_MODE4_RENDERER_BLIT_FLIP_X, or 0. Flipping mirrors the 
+							image before it is transformed.
+
+	This is the software version of the affine backgrounds. Pixels are sampled
+	at their centers, nearest neighbour, and only those that fall inside the 
+	image are drawn.
+
+	The texture coordinates are set up with multiplies once, and after that 
+	stepped by b and d per scanline and by a and c per pixel. Every scanline 
+	is first clipped against the destination rectangle and the screen, and 
+	then its ends are solved for where it enters and leaves the image. So no 
+	pixel is tested against anything in the inner loop, which just samples the 
+	span into a line buffer. That is blitted with the word and pixel pair code 
+	of \a SoMode4RendererBlit.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererDrawAffineImage( const SoImage* a_Image, const SoMode4RendererRectangle* a_Destination, 
+									 const sofixedpoint a_Matrix[ 4 ], u32 a_Flags )
+{
+	// Samples of one span, with room to line them up with the screen;
+	u32 samples[ (SO_SCREEN_WIDTH >> 2) + 1 ];
+
+	// Clipped destination, the right and bottom are exclusive;
+	s32 left, top, right, bottom;
+
+	// Center of the destination, in half pixels;
+	s32 centerX2, centerY2;
+
+	// Bounds of the pixels that were drawn;
+	s32 dirtyLeft = SO_SCREEN_WIDTH, dirtyTop = SO_SCREEN_HEIGHT, dirtyRight = 0, dirtyBottom = 0;
+
+	s32  width	= SoImageGetWidth(	a_Image );
+	s32  height = SoImageGetHeight( a_Image );
+	bool flip	= (a_Flags & SO_MODE4_RENDERER_BLIT_FLIP_X) != 0;
+	s32  a		= flip ? -a_Matrix[ 0 ] : a_Matrix[ 0 ];
+	s32  b		= flip ? -a_Matrix[ 1 ] : a_Matrix[ 1 ];
+	s32  c		= a_Matrix[ 2 ];
+	s32  d		= a_Matrix[ 3 ];
+	s32  rowU, rowV, u, v;
+	s32  first, last, x, y, k;
+
+	const u8* data = (const u8*) SoImageGetData( a_Image );
+	u8*		  sample;
+	u16*	  scanline;
+
+	// Assert the input;
+	SO_ASSERT( SoImageIsPalettized( a_Image ), "Image must be palettized." );
+	SO_ASSERT( a_Matrix != NULL, "Matrix can't be NULL." );
+
+	if ( a_Destination )
+	{
+		left	 = a_Destination->m_Left;
+		top		 = a_Destination->m_Top;
+		right	 = a_Destination->m_Right;
+		bottom	 = a_Destination->m_Bottom;
+	}
+	else
+	{
+		left	 = 0;
+		top		 = 0;
+		right	 = SO_SCREEN_WIDTH;
+		bottom	 = SO_SCREEN_HEIGHT;
+	}
+
+	centerX2 = left + right;
+	centerY2 = top	+ bottom;
+
+	// Clip against the screen;
+	left   = SO_MAX( left,	 0 );
+	top	   = SO_MAX( top,	 0 );
+	right  = SO_MIN( right,	 SO_SCREEN_WIDTH );
+	bottom = SO_MIN( bottom, SO_SCREEN_HEIGHT );
+
+	if ( right <= left || bottom <= top ) return;
+
+	// Texture coordinates of the center of the top left pixel. The offsets from
+	// the center are in half pixels, so shift them one less;
+	x	 = (2 * left + 1 - centerX2) << (SO_FIXED_Q - 1);
+	y	 = (2 * top	 + 1 - centerY2) << (SO_FIXED_Q - 1);
+	rowU = SO_FIXED_FROM_WHOLE( width  ) / 2 + SoMathFixedMultiply( a, x ) + SoMathFixedMultiply( b, y );
+	rowV = SO_FIXED_FROM_WHOLE( height ) / 2 + SoMathFixedMultiply( c, x ) + SoMathFixedMultiply( d, y );
+
+	scanline = s_SoMode4RendererBackBuffer + SO_SCREEN_HALF_WIDTH * top;
+
+	for ( y = top; y < bottom; y++ )
+	{
+		// Solve the span ends against the image;
+		first = 0;
+		last  = right - left;
+
+		SoMode4RendererClipAffineSpan( rowU, a, SO_FIXED_FROM_WHOLE( width  ), &first, &last );
+		SoMode4RendererClipAffineSpan( rowV, c, SO_FIXED_FROM_WHOLE( height ), &first, &last );
+
+		if ( first < last )
+		{
+			x = left + first;
+			u = rowU + a * first;
+			v = rowV + c * first;
+
+			// Sample the span, with the samples on the same word offset as the 
+			// screen pixels, so they can be copied a word at a time;
+			sample = (u8*) samples + (x & 3);
+
+			for ( k = last - first; k--; )
+			{
+				*sample++ = data[ width * SO_FIXED_TO_WHOLE( v ) + SO_FIXED_TO_WHOLE( u ) ];
+				u += a;
+				v += c;
+			}
+
+			SoMode4RendererBlitScanline( scanline, x, last - first, (u8*) samples + (x & 3), 1, 
+										 (a_Flags & SO_MODE4_RENDERER_BLIT_TRANSPARENT) != 0 );
+
+			dirtyLeft	= SO_MIN( dirtyLeft,   x );
+			dirtyRight	= SO_MAX( dirtyRight,  left + last );
+			dirtyTop	= SO_MIN( dirtyTop,	   y );
+			dirtyBottom = y + 1;
+		}
+
+		rowU	 += b;
+		rowV	 += d;
+		scanline += SO_SCREEN_HALF_WIDTH;
+	}
+
+	if ( dirtyTop < dirtyBottom )
+	{
+		SoMode4RendererAddDirtyRectangle( dirtyLeft, dirtyTop, dirtyRight, dirtyBottom );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a run length encoded image into the current backbuffer.
+
+	\param a_Image		Image to draw.
+	\param a_X			Screen X of the top left pixel of the image.
+	\param a_Y			Screen Y of the top left pixel of the image.
+
+	Only the opaque runs are drawn, the transparent pixels in between are skipped
+	without being looked at. The runs are copied like \a SoMode4RendererBlit does, 
+	a word at a time if \a a_X is a multiple of 4, and a pixel pair at a time if it 
+	is even. The image is clipped against the screen.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererDrawRLEImage( const SoRLEImage* a_Image, s32 a_X, s32 a_Y )
+{
+	const u8*  data	   = SoRLEImageGetData( a_Image );
+	const u32* offsets = (const u32*) data;
+
+	// Current scanline and run;
+	s32		  y, top, bottom;
+	s32		  x, left, length;
+	u32		  numRuns;
+	const u8* run;
+	const u8* source;
+	u16*	  scanline;
+
+	// Clip the scanlines against the screen;
+	top	   = SO_MAX( -a_Y, 0 );
+	bottom = SO_MIN( SoRLEImageGetHeight( a_Image ), SO_SCREEN_HEIGHT - a_Y );
+
+	if ( bottom <= top || a_X >= SO_SCREEN_WIDTH || a_X + SoRLEImageGetWidth( a_Image ) <= 0 ) return;
+
+	SoMode4RendererAddDirtyRectangle( a_X, a_Y + top, a_X + SoRLEImageGetWidth( a_Image ), a_Y + bottom );
+
+	scanline = s_SoMode4RendererBackBuffer + SO_SCREEN_HALF_WIDTH * (a_Y + top);
+
+	for ( y = top; y < bottom; y++, scanline += SO_SCREEN_HALF_WIDTH )
+	{
+		run		= data + offsets[ y ];
+		numRuns = *run++;
+		x		= 0;
+
+		while ( numRuns-- )
+		{
+			// Skip the transparent pixels, and the padding that lines the run up;
+			x	   += run[ 0 ];
+			length	= run[ 1 ];
+			run	   += 2;
+			run	   += (x - (run - data)) & 3;
+
+			// Clip the run against the screen;
+			source = run;
+			left   = a_X + x;
+
+			run += length;
+			x	+= length;
+
+			if ( left < 0 )
+			{
+				source -= left;
+				length += left;
+				left	= 0;
+			}
+
+			if ( left + length > SO_SCREEN_WIDTH ) length = SO_SCREEN_WIDTH - left;
+
+			if ( length > 0 )
+			{
+				SoMode4RendererBlitScanline( scanline, left, length, source, 1, false );
+			}
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws a row of image pixels into a scanline of the backbuffer.
+
+	\internal Used by \a SoMode4RendererBlit and \a SoMode4RendererDrawRLEImage.
+
+	\param a_Scanline		First pixel pair of the scanline.
+	\param a_X				X of the first pixel that is drawn.
+	\param a_NumPixels		Number of pixels to draw, at least 1.
+	\param a_Source			Image pixel that goes at \a a_X.
+	\param a_Step			1 to read the image from left to right, -1 from right to left.
+	\param a_Transparent	If \a true, pixels with palette index 0 are skipped.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererBlitScanline( u16* a_Scanline, s32 a_X, s32 a_NumPixels, 
+								  const u8* a_Source, s32 a_Step, bool a_Transparent )
+{
+	u16* pixel = a_Scanline + (a_X >> 1);
+	u32	 paletteIndex0, paletteIndex1;
+	u32	 numWords;
+
+	// Do the source and the screen line up on pixel pairs;
+	if ( a_Step == 1 && ! a_Transparent && ((a_X ^ (u32) a_Source) & 1) == 0 )
+	{
+		// Is there a funky first pixel;
+		if ( a_X & 1 )
+		{
+			*pixel = (*pixel & 0x00FF) | (*a_Source++ << 8);
+			pixel++;
+			a_NumPixels--;
+		}
+
+		// Copy words if both can get on a 32 bit boundary;
+		if ( a_NumPixels >= 4 && (((u32) pixel ^ (u32) a_Source) & 2) == 0 )
+		{
+			if ( (u32) pixel & 2 )
+			{
+				*pixel++  = *(const u16*) a_Source;
+				a_Source += 2;
+				a_NumPixels -= 2;
+			}
+
+			for ( numWords = a_NumPixels >> 2; numWords--; )
+			{
+				*(u32*) pixel = *(const u32*) a_Source;
+				pixel	 += 2;
+				a_Source += 4;
+			}
+
+			a_NumPixels &= 3;
+		}
+
+		// Copy the remaining pixel pairs;
+		for ( ; a_NumPixels >= 2; a_NumPixels -= 2 )
+		{
+			*pixel++  = *(const u16*) a_Source;
+			a_Source += 2;
+		}
+
+		// Is there a funky last pixel;
+		if ( a_NumPixels ) *pixel = (*pixel & 0xFF00) | *a_Source;
+
+		return;
+	}
+
+	// Is there a funky first pixel;
+	if ( a_X & 1 )
+	{
+		paletteIndex1 = *a_Source;
+		a_Source	 += a_Step;
+
+		if ( paletteIndex1 || ! a_Transparent ) *pixel = (*pixel & 0x00FF) | (paletteIndex1 << 8);
+
+		pixel++;
+		a_NumPixels--;
+	}
+
+	// Put every pixel pair together from two source pixels;
+	for ( ; a_NumPixels >= 2; a_NumPixels -= 2 )
+	{
+		paletteIndex0 = a_Source[ 0 ];
+		paletteIndex1 = a_Source[ a_Step ];
+		a_Source	 += a_Step << 1;
+
+		if ( ( paletteIndex0 && paletteIndex1 ) || ! a_Transparent )
+		{
+			*pixel = paletteIndex0 | (paletteIndex1 << 8);
+		}
+		else if ( paletteIndex0 )
+		{
+			*pixel = (*pixel & 0xFF00) | paletteIndex0;
+		}
+		else if ( paletteIndex1 )
+		{
+			*pixel = (*pixel & 0x00FF) | (paletteIndex1 << 8);
+		}
+
+		pixel++;
+	}
+
+	// Is there a funky last pixel;
+	if ( a_NumPixels )
+	{
+		paletteIndex0 = *a_Source;
+
+		if ( paletteIndex0 || ! a_Transparent ) *pixel = (*pixel & 0xFF00) | paletteIndex0;
+	}
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 /*! 
 	\brief Draws a string with the given font into the current backbuffer.
@@ -328,6 +935,9 @@ void SoMode4RendererDrawString( u32 a_LeftX, u32 a_RightX, u32 a_TopY, char* a_S
 	// Variable to store the number of characters in a single word;
 	u32			numCharsInWord = 0;
 
+	// Rightmost X drawn so far;
+	u32			rightX = a_LeftX;
+
 	// Assert the image is palettized;
 	SO_ASSERT( SoImageIsPalettized( a_Font ), "Font image must be palettized." );
 	
@@ -408,11 +1018,188 @@ void SoMode4RendererDrawString( u32 a_LeftX, u32 a_RightX, u32 a_TopY, char* a_S
 			--numCharsInWord; 
 			x += charWidth;
 			
+			if ( x > rightX ) rightX = x;
 		}
 
 		// Next character;
 		a_String++;
 	}
+
+	SoMode4RendererAddDirtyRectangle( a_LeftX, a_TopY, rightX, y + charHeight );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*! 
+	\brief Draws a string with a proportional font into the current backbuffer.
+
+	\param a_LeftX		Left X of the rectangle where the string is drawn, can be odd.
+	\param a_RightX		Right X of the rectangle where the string is drawn, at most 
+						\a SO_SCREEN_WIDTH. Glyphs don't go past it.
+	\param a_TopY		Top Y position of the rectangle where the string is drawn.
+	\param a_String		String you want to draw.
+	\param a_Font		Font you want to use for the string, see \a SoFontCache.
+
+	Words that don't fit on a line go to the next one, like with 
+	\a SoMode4RendererDrawString, and so do the rest of words that don't fit on 
+	a line at all. Lines that don't fit on the screen anymore aren't drawn.
+
+	Glyphs are drawn opaque, from the left of the first glyph to the right of the 
+	last glyph of every line, including the spacing and spaces in between (palette
+	index 0). Lines are drawn a scanline at a time from the pixel pairs of the font 
+	cache, carrying the last pixel of a glyph over into the first pair of the next. 
+	So no matter where the glyphs are, every pixel pair is written once, and the 
+	screen is only read at the ends of lines that start or end at an odd X.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererDrawText( u32 a_LeftX, u32 a_RightX, u32 a_TopY, const char* a_String, const SoFont* a_Font )
+{
+	// Glyphs of the current line, their first pixel pair of the current row, their X and their width;
+	const u16*	glyphPairs[ SO_MODE4_RENDERER_MAX_GLYPHS_PER_LINE ];
+	u8			glyphX[		SO_MODE4_RENDERER_MAX_GLYPHS_PER_LINE ];
+	u8			glyphWidths[ SO_MODE4_RENDERER_MAX_GLYPHS_PER_LINE ];
+	u32			numGlyphs;
+
+	u32	height	= SoFontGetHeight( a_Font );
+	u32	y		= a_TopY;
+	u32	x, width, wordWidth, index, numPixels, numPairs, row, i, j;
+	bool newWord = true;
+
+	const char* character;
+	const u16*	pairs;
+	u16*		pixel;
+
+	// Pixel left over from the previous glyph, that goes in the low byte of the next pair;
+	u32 pending;
+
+	SO_ASSERT( a_Font->m_Cache != NULL, "Call SoFontCache before drawing with a font." );
+	SO_ASSERT( a_LeftX <= a_RightX && a_RightX <= SO_SCREEN_WIDTH, "Rectangle must lie on the screen." );
+
+	while ( *a_String != '\0' && y + height <= SO_SCREEN_HEIGHT )
+	{
+		// Find the glyphs of the next line;
+		numGlyphs = 0;
+		x		  = a_LeftX;
+
+		while ( *a_String != '\0' )
+		{
+			// Is this a newline;
+			if ( *a_String == '\n' )
+			{
+				a_String++;
+				newWord = true;
+				break;
+			}
+
+			// Is this a non-drawable character;
+			if ( ! SoFontIsDrawable( *a_String ) )
+			{
+				x += SoFontGetSpaceWidth( a_Font );
+				a_String++;
+				newWord = true;
+				continue;
+			}
+
+			// If this word doesn't fit on this line, go to the next;
+			if ( newWord )
+			{
+				for ( character = a_String, width = 0, wordWidth = 0; SoFontIsDrawable( *character ); character++ )
+				{
+					wordWidth = width + SoFontGetGlyphWidth( a_Font, *character );
+					width	 += SoFontGetAdvance( a_Font, character[ 0 ], character[ 1 ] );
+				}
+
+				if ( numGlyphs > 0 && x + wordWidth > a_RightX ) break;
+
+				newWord = false;
+			}
+
+			// Break up words that don't fit on a line at all;
+			width = SoFontGetGlyphWidth( a_Font, *a_String );
+
+			if ( x + width > a_RightX || numGlyphs == SO_MODE4_RENDERER_MAX_GLYPHS_PER_LINE )
+			{
+				if ( numGlyphs > 0 ) break;
+
+				// Not even this glyph fits, leave it out;
+				a_String++;
+				continue;
+			}
+
+			// Take the version of the glyph that starts at an even or odd X;
+			index = *a_String - SO_FONT_FIRST_CHAR;
+
+			glyphPairs[ numGlyphs ]	 = a_Font->m_Cache + a_Font->m_Cache[ (index << 1) + (x & 1) ];
+			glyphX[ numGlyphs ]		 = x;
+			glyphWidths[ numGlyphs ] = width;
+			numGlyphs++;
+
+			x += SoFontGetAdvance( a_Font, a_String[ 0 ], a_String[ 1 ] );
+			a_String++;
+		}
+
+		// Draw the line a scanline at a time;
+		for ( row = 0; row < height && numGlyphs > 0; row++ )
+		{
+			x	  = glyphX[ 0 ];
+			pixel = s_SoMode4RendererBackBuffer + SO_SCREEN_HALF_WIDTH * (y + row) + (x >> 1);
+
+			// A line at an odd X starts with the pixel that's already there;
+			pending = (x & 1) ? *pixel & 0x00FF : 0;
+
+			for ( i = 0; i < numGlyphs; i++ )
+			{
+				// Fill the gap before the glyph;
+				if ( x < glyphX[ i ] )
+				{
+					if ( x & 1 ) 
+					{
+						*pixel++ = pending;
+						x++;
+					}
+
+					for ( ; x + 2 <= glyphX[ i ]; x += 2 ) *pixel++ = 0;
+
+					pending = 0;
+					x		= glyphX[ i ];
+				}
+
+				// Plot the whole pixel pairs of the glyph row, and keep the last pixel
+				// if it's only half a pair;
+				pairs	  = glyphPairs[ i ];
+				numPixels = glyphWidths[ i ] + (x & 1);
+				numPairs  = numPixels >> 1;
+
+				if ( numPairs > 0 )
+				{
+					pixel[ 0 ] = pairs[ 0 ] | pending;
+
+					for ( j = 1; j < numPairs; j++ ) pixel[ j ] = pairs[ j ];
+
+					pixel += numPairs;
+				}
+
+				pending = (numPixels & 1) ? pairs[ numPairs ] : 0;
+
+				// Next row of the glyph;
+				glyphPairs[ i ] += (numPixels + 1) >> 1;
+				x				+= glyphWidths[ i ];
+			}
+
+			// A line at an odd X ends with the pixel that's already there;
+			if ( x & 1 ) *pixel = (*pixel & 0xFF00) | pending;
+		}
+
+		if ( numGlyphs > 0 )
+		{
+			SoMode4RendererAddDirtyRectangle( glyphX[ 0 ], y, 
+											  glyphX[ numGlyphs - 1 ] + glyphWidths[ numGlyphs - 1 ], 
+											  y + height );
+		}
+
+		// Next line;
+		y += height + SO_FONT_VERTICAL_SPACING;
+	}
 }
 // ----------------------------------------------------------------------------
 
@@ -450,6 +1237,245 @@ void SoMode4RendererClearFrontAndBackBuffer( void )
 	SoMode4RendererClear();
 	SoMode4RendererFlip();
 	SoMode4RendererClear();
+
+	// Nothing is drawn in either buffer anymore;
+	s_NumDirtyRectangles[ 0 ] = 0;
+	s_NumDirtyRectangles[ 1 ] = 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Enables or disables keeping track of what is drawn into the buffers.
+
+	\param	a_Enable	\a true to enable, \a false to disable.
+
+	Most mode 4 screens, like menus and puzzle boards, hardly change from one 
+	frame to the next. Clearing all 38400 bytes of the backbuffer every frame 
+	is a waste there. With dirty rectangles enabled, the renderer remembers the
+	rectangles that were drawn into each of the two buffers, and 
+	\a SoMode4RendererClearDirtyRectangles only clears those.
+
+	Because the buffers are flipped, the backbuffer shows what was drawn two 
+	frames ago. So that's what \a SoMode4RendererClearDirtyRectangles clears, 
+	before the rectangles of the new frame are added.
+
+	The image, string and pixel functions of this module add their rectangles
+	themselves. The \a SoMode4PolygonRasterizer doesn't know about them, so call 
+	\a SoMode4RendererAddDirtyRectangle with the screen bounds of whatever you 
+	draw with it.
+
+	Enabling marks both buffers as completely dirty, because we don't know what's
+	in them. By default dirty rectangles are disabled.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererSetDirtyRectanglesEnable( bool a_Enable )
+{
+	u32 i;
+
+	s_DirtyRectanglesEnabled = a_Enable;
+
+	for ( i = 0; i < 2; i++ )
+	{
+		s_DirtyRectangles[ i ][ 0 ].m_Left	 = 0;
+		s_DirtyRectangles[ i ][ 0 ].m_Top	 = 0;
+		s_DirtyRectangles[ i ][ 0 ].m_Right	 = SO_SCREEN_WIDTH;
+		s_DirtyRectangles[ i ][ 0 ].m_Bottom = SO_SCREEN_HEIGHT;
+
+		s_NumDirtyRectangles[ i ] = 1;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Tells the renderer a part of the backbuffer was drawn into.
+
+	\param	a_Left		Leftmost pixel column that was drawn into.
+	\param	a_Top		Topmost pixel row that was drawn into.
+	\param	a_Right		Pixel column just right of the drawn part.
+	\param	a_Bottom	Pixel row just below the drawn part.
+
+	The rectangle is clipped to the screen and widened to whole pixel pairs.
+	It is merged with a rectangle already there if that one grows by no more 
+	than the area of the new one, which happens when they overlap a lot or touch.
+	When there are \a SO_MODE4_RENDERER_MAX_NUM_DIRTY_RECTANGLES already, the 
+	rectangle is merged with the one that grows the least by it.
+
+	Does nothing if dirty rectangles are disabled, see 
+	\a SoMode4RendererSetDirtyRectanglesEnable.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererAddDirtyRectangle( s32 a_Left, s32 a_Top, s32 a_Right, s32 a_Bottom )
+{
+	u32  buffer;
+	u32  i, best;
+	s32  growth, bestGrowth;
+	SoMode4RendererRectangle* rectangle;
+
+	if ( ! s_DirtyRectanglesEnabled ) return;
+
+	// Clip to the screen, and widen to whole pixel pairs;
+	a_Left	 = SO_MAX( a_Left, 0 ) & ~1;
+	a_Top	 = SO_MAX( a_Top,  0 );
+	a_Right	 = (SO_MIN( a_Right, SO_SCREEN_WIDTH ) + 1) & ~1;
+	a_Bottom = SO_MIN( a_Bottom, SO_SCREEN_HEIGHT );
+
+	if ( a_Right <= a_Left || a_Bottom <= a_Top ) return;
+
+	buffer = SO_MODE4_RENDERER_BACK_BUFFER_INDEX;
+
+	// Find the rectangle that grows the least when we merge with it. If it grows
+	// by no more than the area of the new rectangle, merging them doesn't make 
+	// clearing any more expensive;
+	best	   = 0;
+	bestGrowth = SO_SCREEN_WIDTH * SO_SCREEN_HEIGHT;
+
+	for ( i = 0; i < s_NumDirtyRectangles[ buffer ]; i++ )
+	{
+		rectangle = &s_DirtyRectangles[ buffer ][ i ];
+
+		growth = ( SO_MAX( rectangle->m_Right,  a_Right  ) - SO_MIN( rectangle->m_Left, a_Left ) ) *
+				 ( SO_MAX( rectangle->m_Bottom, a_Bottom ) - SO_MIN( rectangle->m_Top,	a_Top  ) ) -
+				 ( rectangle->m_Right  - rectangle->m_Left ) * 
+				 ( rectangle->m_Bottom - rectangle->m_Top  );
+
+		if ( growth < bestGrowth )
+		{
+			best	   = i;
+			bestGrowth = growth;
+		}
+	}
+
+	// Add a new one if there is no overlap and there is room;
+	if ( s_NumDirtyRectangles[ buffer ] < SO_MODE4_RENDERER_MAX_NUM_DIRTY_RECTANGLES &&
+		 bestGrowth > (a_Right - a_Left) * (a_Bottom - a_Top) )
+	{
+		rectangle = &s_DirtyRectangles[ buffer ][ s_NumDirtyRectangles[ buffer ]++ ];
+
+		rectangle->m_Left	= a_Left;
+		rectangle->m_Top	= a_Top;
+		rectangle->m_Right	= a_Right;
+		rectangle->m_Bottom = a_Bottom;
+	}
+	else
+	{
+		rectangle = &s_DirtyRectangles[ buffer ][ best ];
+
+		rectangle->m_Left	= SO_MIN( rectangle->m_Left,   a_Left	);
+		rectangle->m_Top	= SO_MIN( rectangle->m_Top,	   a_Top	);
+		rectangle->m_Right	= SO_MAX( rectangle->m_Right,  a_Right	);
+		rectangle->m_Bottom = SO_MAX( rectangle->m_Bottom, a_Bottom );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Clears the parts of the backbuffer that were drawn into, to palette index zero.
+
+	Clears the rectangles that were added the last time this buffer was the 
+	backbuffer, and forgets them. Rectangles that span the whole screen width 
+	are cleared with a single 32 bit DMA transfer, others with one per scanline.
+
+	Anything that was drawn there and should stay on the screen needs to be drawn 
+	again. \a SoMode4RendererGetClearedRectangle tells you where that is.
+
+	If dirty rectangles are disabled, this clears the entire backbuffer with
+	\a SoMode4RendererClear.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererClearDirtyRectangles( void )
+{
+	u32  buffer = SO_MODE4_RENDERER_BACK_BUFFER_INDEX;
+	u32  i;
+	s32  y;
+	u32  numPixelDuos;
+	u16* scanline;
+	u16* pixel;
+	SoMode4RendererRectangle* rectangle;
+
+	if ( ! s_DirtyRectanglesEnabled )
+	{
+		SoMode4RendererClear();
+
+		s_ClearedRectangle.m_Left	= 0;
+		s_ClearedRectangle.m_Top	= 0;
+		s_ClearedRectangle.m_Right	= SO_SCREEN_WIDTH;
+		s_ClearedRectangle.m_Bottom = SO_SCREEN_HEIGHT;
+		return;
+	}
+
+	// Start with an empty rectangle;
+	s_ClearedRectangle.m_Left	= SO_SCREEN_WIDTH;
+	s_ClearedRectangle.m_Top	= SO_SCREEN_HEIGHT;
+	s_ClearedRectangle.m_Right	= 0;
+	s_ClearedRectangle.m_Bottom = 0;
+
+	for ( i = 0; i < s_NumDirtyRectangles[ buffer ]; i++ )
+	{
+		rectangle = &s_DirtyRectangles[ buffer ][ i ];
+		scanline  = s_SoMode4RendererBackBuffer + SO_SCREEN_HALF_WIDTH * rectangle->m_Top;
+
+		// Full scanlines are one block of memory;
+		if ( rectangle->m_Left == 0 && rectangle->m_Right == SO_SCREEN_WIDTH )
+		{
+			SO_DMA_MEMSET( scanline, (SO_SCREEN_HALF_WIDTH >> 1) * (rectangle->m_Bottom - rectangle->m_Top), 0 );
+		}
+		else
+		{
+			for ( y = rectangle->m_Top; y < rectangle->m_Bottom; y++ )
+			{
+				pixel		 = scanline + (rectangle->m_Left >> 1);
+				numPixelDuos = (rectangle->m_Right - rectangle->m_Left) >> 1;
+
+				// Get on a 32 bit boundary;
+				if ( (u32) pixel & 2 )
+				{
+					*pixel++ = 0;
+					numPixelDuos--;
+				}
+
+				// A DMA transfer of zero words would do the maximum instead;
+				if ( numPixelDuos >> 1 )
+				{
+					SO_DMA_MEMSET( pixel, numPixelDuos >> 1, 0 );
+				}
+
+				if ( numPixelDuos & 1 ) pixel[ numPixelDuos - 1 ] = 0;
+
+				scanline += SO_SCREEN_HALF_WIDTH;
+			}
+		}
+
+		s_ClearedRectangle.m_Left	= SO_MIN( s_ClearedRectangle.m_Left,	rectangle->m_Left	);
+		s_ClearedRectangle.m_Top	= SO_MIN( s_ClearedRectangle.m_Top,		rectangle->m_Top	);
+		s_ClearedRectangle.m_Right	= SO_MAX( s_ClearedRectangle.m_Right,	rectangle->m_Right	);
+		s_ClearedRectangle.m_Bottom = SO_MAX( s_ClearedRectangle.m_Bottom,	rectangle->m_Bottom );
+	}
+
+	s_NumDirtyRectangles[ buffer ] = 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the bounds of what \a SoMode4RendererClearDirtyRectangles cleared last.
+
+	\param	a_Rectangle		Filled with the bounds.
+
+	\retval	true	if anything was cleared.
+	\retval	false	if nothing was cleared, so nothing needs to be redrawn.
+
+	Static parts of the screen only have to be redrawn where they intersect 
+	this rectangle.
+*/
+// ----------------------------------------------------------------------------
+bool SoMode4RendererGetClearedRectangle( SoMode4RendererRectangle* a_Rectangle )
+{
+	*a_Rectangle = s_ClearedRectangle;
+
+	return s_ClearedRectangle.m_Right > s_ClearedRectangle.m_Left;
 }
 // ----------------------------------------------------------------------------
 
@@ -0,0 +1,150 @@
+@ --------------------------------------------------------------------------------------
+@
+@	Copyright (C) 2002 by the SGADE authors
+@	For conditions of distribution and use, see copyright notice in SoLicense.txt
+@
+@	\file		SoMode4RendererCrossFade.s
+@	\author		Jaap Suter
+@	\date		Oct 17 2026
+@	\ingroup	SoMode4Renderer
+@
+@	See the \a SoMode4Renderer module for more information.
+@
+@	\implements		SoMode4RendererCrossFadeWords
+@
+@ --------------------------------------------------------------------------------------
+
+@ --------------------------------------------------------------------------------------
+@ Initialize;
+@ --------------------------------------------------------------------------------------
+
+		.SECTION .iwram, "ax", %progbits
+        .ARM
+        .ALIGN
+        .GLOBL  SoMode4RendererCrossFadeWords
+
+@ --------------------------------------------------------------------------------------
+@ Macros;
+@ --------------------------------------------------------------------------------------
+
+@ Blends byte number \index of the image 0 and image 1 words into the \result byte.
+@ The two faded indices never add up to more than 255, so nothing carries into
+@ the next byte. Uses r9, r10 and r14 as scratch registers;
+
+		.MACRO	CROSS_FADE_BYTE index, result
+
+			.IF \index == 0
+			and		r9, r11, r5							@ Pixel of image 0;
+			and		r10, r11, r6						@ Pixel of image 1;
+			.ELSE
+			and		r9, r11, r5, lsr #(\index * 8)		@ Pixel of image 0;
+			and		r10, r11, r6, lsr #(\index * 8)		@ Pixel of image 1;
+			.ENDIF
+
+			ldrb	r9, [r4, r9]						@ Look up its faded index;
+			ldrb	r10, [r12, r10]						@ Look up its inversely faded index;
+
+			.IF \index == 0
+			add		\result, r9, r10					@ Add them;
+			.ELSE
+			add		r14, r9, r10						@ Add them, and put them in place;
+			orr		\result, \result, r14, lsl #(\index * 8)
+			.ENDIF
+
+		.ENDM
+
+@ --------------------------------------------------------------------------------------
+@
+@	\brief Cross fades words of two images into a destination.
+@
+@	\param	r0	Destination, on a 32 bit boundary.
+@	\param	r1	Pixels of the first image, on a 32 bit boundary.
+@	\param	r2	Pixels of the second image, on a 32 bit boundary.
+@	\param	r3	Number of words (four pixels each) to do, at least 1.
+@	\param	sp	Cross fade table of the fade level: 256 bytes with the faded palette
+@				indices of the first image, followed by 256 bytes with the inversely
+@				faded palette indices of the second image.
+@
+@	Does four pixels per iteration. Words that are the same in both images are
+@	copied without any lookups, and so are pixel pairs, exactly like the C loop
+@	does. Lives in IWRAM, so keep the table in IWRAM too.
+@	Called by \a SoMode4RendererDrawCrossFadeImage, which explains it all.
+@
+@	\prototype
+@
+@	void SoMode4RendererCrossFadeWords( u32* a_Destination, const u32* a_Image0,
+@										const u32* a_Image1, u32 a_NumWords,
+@										const u8* a_CrossFadeTable );
+@
+@ --------------------------------------------------------------------------------------
+SoMode4RendererCrossFadeWords:
+
+	@ Initialize;
+
+		stmfd	sp!, {r4-r11, r14}	@ Save the registers we crush on the stack;
+
+		ldr		r4, [sp, #36]		@ Load the fade table, the fifth argument;
+		add		r12, r4, #256		@ The inverse fade table comes right after it;
+		mov		r11, #0xFF			@ Load the byte mask;
+
+	@ Loop over the words;
+
+	crossFadeLoop:
+
+		ldr		r5, [r1], #4		@ Load four pixels of image 0;
+		ldr		r6, [r2], #4		@ Load four pixels of image 1;
+
+		cmp		r5, r6				@ Are they the same;
+		beq		crossFadeSame
+
+		eor		r8, r5, r6			@ Find out which pixel pairs differ;
+
+		movs	r9, r8, lsl #16		@ Is the first pair the same;
+		bne		crossFadeFirstPair
+		mov		r7, r5, lsl #16		@ Then just take it from image 0;
+		mov		r7, r7, lsr #16
+		b		crossFadeSecondPair
+
+	crossFadeFirstPair:
+
+		CROSS_FADE_BYTE 0, r7
+		CROSS_FADE_BYTE 1, r7
+
+	crossFadeSecondPair:
+
+		movs	r9, r8, lsr #16		@ Is the second pair the same;
+		bne		crossFadeSecondPairDiffers
+		mov		r9, r5, lsr #16		@ Then just take it from image 0;
+		orr		r7, r7, r9, lsl #16
+		b		crossFadePlot
+
+	crossFadeSecondPairDiffers:
+
+		CROSS_FADE_BYTE 2, r7
+		CROSS_FADE_BYTE 3, r7
+
+	crossFadePlot:
+
+		str		r7, [r0], #4		@ Plot the four pixels;
+		subs	r3, r3, #1			@ One word done;
+		bne		crossFadeLoop		@ Jump back if we're not done yet;
+		b		crossFadeDone
+
+	crossFadeSame:
+
+		str		r5, [r0], #4		@ Just plot them;
+		subs	r3, r3, #1			@ One word done;
+		bne		crossFadeLoop		@ Jump back if we're not done yet;
+
+	@ Return;
+
+	crossFadeDone:
+
+		ldmfd	sp!, {r4-r11, r14}	@ Restore the registers from the stack;
+		bx		lr					@ Return;
+
+@ --------------------------------------------------------------------------------------
+
+@ --------------------------------------------------------------------------------------
+@ EOF;
+@ --------------------------------------------------------------------------------------
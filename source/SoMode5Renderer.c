@@ -0,0 +1,141 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoMode5Renderer.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoMode5Renderer
+
+	See the \a SoMode5Renderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoMode5Renderer.h"
+#include "SoRenderer.h"
+#include "SoDisplay.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! \internal Pointer to the first mode 5 buffer
+#define SO_MODE5_RENDERER_BUFFER_0	((u16*)0x6000000)
+
+//! \internal Pointer to the second mode 5 buffer
+#define SO_MODE5_RENDERER_BUFFER_1	((u16*)0x600A000)
+
+// ----------------------------------------------------------------------------
+// Variables;
+// ----------------------------------------------------------------------------
+
+//!	\internal Pointer to the current mode 5 backbuffer.
+static u16* s_BackBuffer = SO_MODE5_RENDERER_BUFFER_1;
+
+// ----------------------------------------------------------------------------
+// Function implementations;
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Switches the Gameboy Advance to mode 5.
+
+	Use this method before you are going to use any other mode 5 rendering function.
+	Buffer 0 is shown, and buffer 1 is the backbuffer.
+
+	Make sure you have already called \a SoDisplayInitialize too.
+*/
+// ----------------------------------------------------------------------------
+void SoMode5RendererEnable( void )
+{
+	s_BackBuffer = SO_MODE5_RENDERER_BUFFER_1;
+
+	SoDisplaySetMode( 5 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Flips the two mode 5 buffers.
+
+	If buffer 0 is visible then buffer 1 becomes visible, and vice versa.
+*/
+// ----------------------------------------------------------------------------
+void SoMode5RendererFlip( void )
+{
+	// Let the gameboy display the other buffer;
+	SO_REG_DISP_CNT ^= SO_BIT_4;
+
+	// Set the new backbuffer;
+	s_BackBuffer = ( SO_REG_DISP_CNT & SO_BIT_4 ) ? SO_MODE5_RENDERER_BUFFER_0 : SO_MODE5_RENDERER_BUFFER_1;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Clears the mode 5 backbuffer to palette index zero.
+
+	See \a SoRendererSetPalette.
+*/
+// ----------------------------------------------------------------------------
+void SoMode5RendererClear( void )
+{
+	SoRendererClear16( s_BackBuffer, SO_MODE5_RENDERER_WIDTH * SO_MODE5_RENDERER_HEIGHT );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a pointer to the current backbuffer;
+
+	Note that if you call \a SoMode5RendererFlip after using this function, the 
+	pointer you have suddenly becomes the frontbuffer.
+*/
+// ----------------------------------------------------------------------------
+void* SoMode5RendererGetBuffer( void )
+{
+	return (void*) s_BackBuffer;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws (part of) an image of any size into the mode 5 backbuffer.
+
+	Takes the same parameters as \a SoMode4RendererBlit, see \a SoRendererBlit16.
+	The image is clipped against the 160 by 128 buffer.
+*/
+// ----------------------------------------------------------------------------
+void SoMode5RendererBlit( const SoImage* a_Image, s32 a_X, s32 a_Y,
+						  const SoMode4RendererRectangle* a_Source, u32 a_Flags )
+{
+	SoRendererBlit16( s_BackBuffer, SO_MODE5_RENDERER_WIDTH, SO_MODE5_RENDERER_HEIGHT,
+					  a_Image, a_X, a_Y, a_Source, a_Flags );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Plots a single pixel into the mode 5 backbuffer.
+
+	\param a_X			X position of the pixel in the range 0 to 159.
+	\param a_Y			Y position of the pixel in the range 0 to 127.
+	\param a_Color		16 bit color of the pixel.
+*/
+// ----------------------------------------------------------------------------
+void SoMode5RendererDrawPixel( u32 a_X, u32 a_Y, u16 a_Color )
+{
+	SO_ASSERT( a_X < SO_MODE5_RENDERER_WIDTH && a_Y < SO_MODE5_RENDERER_HEIGHT, "Pixel is offscreen." );
+
+	s_BackBuffer[ SO_MODE5_RENDERER_WIDTH * a_Y + a_X ] = a_Color;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
@@ -17,8 +17,14 @@
 // ----------------------------------------------------------------------------
 
 #include "SoPolygon.h"
+#include "SoMath.h"
 #include "SoDebug.h"
 
+// ----------------------------------------------------------------------------
+// Function forwards
+// ----------------------------------------------------------------------------
+static void SoPolygonScaleToRange( SoVector3* a_Vector );
+
 // ----------------------------------------------------------------------------
 // Function implementations
 // ----------------------------------------------------------------------------
@@ -106,6 +112,171 @@ void SoPolygonSetPaletteIndex( SoPolygon* a_This, u32 a_PaletteIndex )
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Calculates the plane the polygon lies in.
+
+	\param	a_This		This pointer
+	\param	a_Vertices	Vertices the vertex indices of the polygon index, in object space. 
+						Usually those of the \a SoMesh the polygon is part of.
+
+	The plane is spanned by the first three vertices. Its normal points to the 
+	side the polygon is seen from, where its vertices are clockwise on the screen.
+	The \a SoCamera uses it to throw away polygons that face away from it, before 
+	anything is transformed. Call this at load time, \a SoMeshCalculatePolygonPlanes
+	does it for every polygon of a mesh. 
+	
+	Degenerate polygons get no plane, and are left to the screen space test. The 
+	edges and the normal are scaled to a range that doesn't overflow before their 
+	products are taken, so tiny and huge polygons work too.
+*/
+// ----------------------------------------------------------------------------
+void SoPolygonCalculatePlane( SoPolygon* a_This, SoVector3* a_Vertices )
+{
+	// Vertices the plane goes through;
+	SoVector3* vertex0 = &a_Vertices[ SoPolygonGetVertexIndex( a_This, 0 ) ];
+	SoVector3* vertex1 = &a_Vertices[ SoPolygonGetVertexIndex( a_This, 1 ) ];
+	SoVector3* vertex2 = &a_Vertices[ SoPolygonGetVertexIndex( a_This, 2 ) ];
+
+	// Edges from the first vertex, and their cross product;
+	SoVector3 edge0, edge1, normal;
+
+	sofixedpoint length;
+
+	edge0.m_X = vertex1->m_X - vertex0->m_X;
+	edge0.m_Y = vertex1->m_Y - vertex0->m_Y;
+	edge0.m_Z = vertex1->m_Z - vertex0->m_Z;
+	edge1.m_X = vertex2->m_X - vertex0->m_X;
+	edge1.m_Y = vertex2->m_Y - vertex0->m_Y;
+	edge1.m_Z = vertex2->m_Z - vertex0->m_Z;
+
+	// Scaling the edges doesn't change the direction of their cross product;
+	SoPolygonScaleToRange( &edge0 );
+	SoPolygonScaleToRange( &edge1 );
+
+	normal.m_X = SoMathFixedMultiply( edge0.m_Y, edge1.m_Z ) - SoMathFixedMultiply( edge0.m_Z, edge1.m_Y );
+	normal.m_Y = SoMathFixedMultiply( edge0.m_Z, edge1.m_X ) - SoMathFixedMultiply( edge0.m_X, edge1.m_Z );
+	normal.m_Z = SoMathFixedMultiply( edge0.m_X, edge1.m_Y ) - SoMathFixedMultiply( edge0.m_Y, edge1.m_X );
+
+	SoPolygonScaleToRange( &normal );
+
+	length = SoMathFixedSqrt( SoMathFixedMultiply( normal.m_X, normal.m_X ) +
+							  SoMathFixedMultiply( normal.m_Y, normal.m_Y ) +
+							  SoMathFixedMultiply( normal.m_Z, normal.m_Z ) );
+
+	// Is the polygon degenerate;
+	if ( length == 0 )
+	{
+		a_This->m_Normal.m_X	 = 0;
+		a_This->m_Normal.m_Y	 = 0;
+		a_This->m_Normal.m_Z	 = 0;
+		a_This->m_PlaneDistance	 = 0;
+		return;
+	}
+
+	// Make it unit length;
+	length = SO_FIXED_ONE_OVER_SLOW_ACCURATE( length );
+
+	a_This->m_Normal.m_X = SoMathFixedMultiply( normal.m_X, length );
+	a_This->m_Normal.m_Y = SoMathFixedMultiply( normal.m_Y, length );
+	a_This->m_Normal.m_Z = SoMathFixedMultiply( normal.m_Z, length );
+
+	a_This->m_PlaneDistance = SoMathFixedMultiply( a_This->m_Normal.m_X, vertex0->m_X ) +
+							  SoMathFixedMultiply( a_This->m_Normal.m_Y, vertex0->m_Y ) +
+							  SoMathFixedMultiply( a_This->m_Normal.m_Z, vertex0->m_Z );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns whether \a SoPolygonCalculatePlane gave the polygon a plane.
+
+	\param	a_This	This pointer
+*/
+// ----------------------------------------------------------------------------
+bool SoPolygonHasPlane( SoPolygon* a_This )
+{
+	return ( a_This->m_Normal.m_X | a_This->m_Normal.m_Y | a_This->m_Normal.m_Z ) != 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the unit normal of the polygon, in object space.
+
+	\param	a_This	This pointer
+
+	All zero if the polygon has no plane, see \a SoPolygonCalculatePlane.
+*/
+// ----------------------------------------------------------------------------
+SoVector3* SoPolygonGetNormal( SoPolygon* a_This )
+{
+	return &a_This->m_Normal;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns whether a point can see the front of the polygon.
+
+	\param	a_This	This pointer
+	\param	a_Point	Point in the same space as the vertices, usually the camera
+					position in object space.
+
+	\return	\a false if the point lies behind the plane of the polygon. Always \a true
+			if the polygon has no plane.
+
+	Points up to a whole unit behind the plane count as in front, so the fixed
+	point error never throws away a polygon that is seen almost edge on.
+*/
+// ----------------------------------------------------------------------------
+bool SoPolygonFacesPoint( SoPolygon* a_This, SoVector3* a_Point )
+{
+	return SoMathFixedMultiply( a_This->m_Normal.m_X, a_Point->m_X ) +
+		   SoMathFixedMultiply( a_This->m_Normal.m_Y, a_Point->m_Y ) +
+		   SoMathFixedMultiply( a_This->m_Normal.m_Z, a_Point->m_Z ) >
+		   a_This->m_PlaneDistance - SO_FIXED_FROM_WHOLE( 1 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Scales a vector by a power of two, so its largest component is 
+		   between 32 and 64.
+
+	\internal
+
+	\param	a_Vector	Vector to scale. Zero vectors are left alone.
+
+	Products of the components then fit in 16.16 fixed point, without losing
+	the precision of small vectors.
+*/
+// ----------------------------------------------------------------------------
+static void SoPolygonScaleToRange( SoVector3* a_Vector )
+{
+	sofixedpoint largest = SO_MAX( SO_ABS( a_Vector->m_X ), SO_ABS( a_Vector->m_Y ) );
+	largest = SO_MAX( SO_ABS( a_Vector->m_Z ), largest );
+
+	if ( largest == 0 ) return;
+
+	while ( largest >= SO_FIXED_FROM_WHOLE( 64 ) )
+	{
+		a_Vector->m_X >>= 1;
+		a_Vector->m_Y >>= 1;
+		a_Vector->m_Z >>= 1;
+		largest		  >>= 1;
+	}
+
+	while ( largest < SO_FIXED_FROM_WHOLE( 32 ) )
+	{
+		a_Vector->m_X <<= 1;
+		a_Vector->m_Y <<= 1;
+		a_Vector->m_Z <<= 1;
+		largest		  <<= 1;
+	}
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 // EOF
 // ----------------------------------------------------------------------------
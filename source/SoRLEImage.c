@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoRLEImage.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoRLEImage
+
+	See the \a SoRLEImage module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoRLEImage.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Function forwards
+// ----------------------------------------------------------------------------
+u32 SoRLEImageEncodeInto( const SoImage* a_Image, u8* a_Buffer );
+
+// ----------------------------------------------------------------------------
+// Function implementations
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of bytes \a SoRLEImageEncode needs for an image.
+
+	\param	a_Image		A palettized \a SoImage, at most \a SO_RLE_IMAGE_MAX_WIDTH wide.
+
+	Always a multiple of 4.
+*/
+// ----------------------------------------------------------------------------
+u32 SoRLEImageGetEncodedSize( const SoImage* a_Image )
+{
+	return SoRLEImageEncodeInto( a_Image, NULL );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Run length encodes an image.
+
+	\param	a_This		This pointer
+	\param	a_Image		A palettized \a SoImage, at most \a SO_RLE_IMAGE_MAX_WIDTH wide.
+						Palette index 0 is transparent.
+	\param	a_Buffer	Memory for the encoded data, on a 32 bit boundary and at least
+						\a SoRLEImageGetEncodedSize bytes big. It has to stay around 
+						as long as \a a_This is used.
+*/
+// ----------------------------------------------------------------------------
+void SoRLEImageEncode( SoRLEImage* a_This, const SoImage* a_Image, void* a_Buffer )
+{
+	SO_ASSERT( ((u32) a_Buffer & 3) == 0, "Buffer should be on a 32 bit boundary." );
+
+	a_This->m_Width	 = SoImageGetWidth(	 a_Image );
+	a_This->m_Height = SoImageGetHeight( a_Image );
+	a_This->m_Size	 = SoRLEImageEncodeInto( a_Image, a_Buffer );
+	a_This->m_Data	 = a_Buffer;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Encodes an image, or only counts the bytes that takes.
+
+	\internal Used by \a SoRLEImageGetEncodedSize and \a SoRLEImageEncode.
+
+	\param	a_Image		Image to encode.
+	\param	a_Buffer	Buffer on a 32 bit boundary to encode into, or \a NULL to 
+						only count.
+
+	\return	Number of bytes of the encoded data, rounded up to a multiple of 4.
+
+	See the \a SoRLEImage module for the format.
+*/
+// ----------------------------------------------------------------------------
+u32 SoRLEImageEncodeInto( const SoImage* a_Image, u8* a_Buffer )
+{
+	u32 width  = SoImageGetWidth(  a_Image );
+	u32 height = SoImageGetHeight( a_Image );
+	u8* pixels = (u8*) SoImageGetData( a_Image );
+
+	// Current scanline, run and pixel;
+	u32 y, x, i, start, skip, pad;
+	u32 numRunsOffset;
+	u32 numRuns;
+
+	// Bytes written so far, the offset table comes first;
+	u32 size = height << 2;
+
+	SO_ASSERT( SoImageIsPalettized( a_Image ), "Image must be palettized." );
+	SO_ASSERT( width <= SO_RLE_IMAGE_MAX_WIDTH, "Image is too wide to run length encode." );
+
+	for ( y = 0; y < height; y++, pixels += width )
+	{
+		if ( a_Buffer ) ((u32*) a_Buffer)[ y ] = size;
+
+		numRunsOffset = size++;
+		numRuns		  = 0;
+		x			  = 0;
+
+		while ( true )
+		{
+			// Find the start of the next run;
+			start = x;
+			while ( x < width && pixels[ x ] == 0 ) x++;
+
+			if ( x == width ) break;
+
+			skip  = x - start;
+			start = x;
+
+			// Find its end;
+			while ( x < width && pixels[ x ] != 0 ) x++;
+
+			if ( a_Buffer )
+			{
+				a_Buffer[ size + 0 ] = skip;
+				a_Buffer[ size + 1 ] = x - start;
+			}
+			size += 2;
+
+			// Line the pixels up with their X coordinate;
+			pad = (start - size) & 3;
+
+			if ( a_Buffer )
+			{
+				while ( pad-- ) a_Buffer[ size++ ] = 0;
+				for ( i = start; i < x; i++ ) a_Buffer[ size++ ] = pixels[ i ];
+			}
+			else
+			{
+				size += pad + x - start;
+			}
+
+			numRuns++;
+		}
+
+		SO_ASSERT( numRuns < 256, "Too many runs in a scanline." );
+
+		if ( a_Buffer ) a_Buffer[ numRunsOffset ] = numRuns;
+	}
+
+	return (size + 3) & ~3;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
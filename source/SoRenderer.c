@@ -0,0 +1,320 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoRenderer.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoRenderer
+
+	See the \a SoRenderer module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoRenderer.h"
+#include "SoMode3Renderer.h"
+#include "SoMode5Renderer.h"
+#include "SoPalette.h"
+#include "SoDisplay.h"
+#include "SoDMA.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Function forwards
+// ----------------------------------------------------------------------------
+void SoRendererFlipNothing( void );
+
+// ----------------------------------------------------------------------------
+// Renderers
+// ----------------------------------------------------------------------------
+
+const SoRenderer g_SoMode3Renderer =
+{
+	SoMode3RendererEnable,
+	SoRendererFlipNothing,
+	SoMode3RendererClear,
+	SoMode3RendererGetBuffer,
+	SoMode3RendererBlit,
+	SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT, 16
+};
+
+const SoRenderer g_SoMode4Renderer =
+{
+	SoMode4RendererEnable,
+	SoMode4RendererFlip,
+	SoMode4RendererClear,
+	SoMode4RendererGetBuffer,
+	SoMode4RendererBlit,
+	SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT, 8
+};
+
+const SoRenderer g_SoMode5Renderer =
+{
+	SoMode5RendererEnable,
+	SoMode5RendererFlip,
+	SoMode5RendererClear,
+	SoMode5RendererGetBuffer,
+	SoMode5RendererBlit,
+	SO_MODE5_RENDERER_WIDTH, SO_MODE5_RENDERER_HEIGHT, 16
+};
+
+// ----------------------------------------------------------------------------
+// Variables
+// ----------------------------------------------------------------------------
+
+//! \internal Palette the 16 bit renderers look palette indices up in.
+static const u16* s_Palette = SO_SCREEN_PALETTE;
+
+// ----------------------------------------------------------------------------
+// Function implementations
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the palette the 16 bit renderers use for palettized pixels.
+
+	\param	a_Palette	256 colors. Has to stay around as long as it's used.
+						Pass \a SO_SCREEN_PALETTE to go back to the default.
+
+	Used for blitting palettized images, for clearing (palette index zero),
+	and by \a SoCamera. Reading from EWRAM is slower than from palette
+	memory, so only set another palette when the screen palette is in use.
+*/
+// ----------------------------------------------------------------------------
+void SoRendererSetPalette( const u16* a_Palette )
+{
+	SO_ASSERT( a_Palette != NULL, "Palette can't be NULL." );
+
+	s_Palette = a_Palette;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the palette set by \a SoRendererSetPalette.
+*/
+// ----------------------------------------------------------------------------
+const u16* SoRendererGetPalette( void )
+{
+	return s_Palette;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Does nothing, the flip of the single buffered renderers.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+void SoRendererFlipNothing( void )
+{
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Fills a 16 bit buffer with palette index zero.
+
+	\param	a_Buffer	Buffer, on a 32 bit boundary.
+	\param	a_NumPixels	Number of pixels, even.
+
+	Clears two pixels per DMA transfer.
+*/
+// ----------------------------------------------------------------------------
+void SoRendererClear16( u16* a_Buffer, u32 a_NumPixels )
+{
+	u32 color = s_Palette[ 0 ];
+
+	SO_ASSERT( ((u32) a_Buffer & 3) == 0, "Buffer should be on a 32 bit boundary." );
+	SO_ASSERT( (a_NumPixels & 1) == 0, "Number of pixels should be even." );
+
+	SO_DMA_MEMSET( a_Buffer, a_NumPixels >> 1, color | (color << 16) );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Draws (part of) an image of any size into a 16 bit buffer.
+
+	\param a_Buffer		Top left pixel of the buffer.
+	\param a_Width		Width of the buffer, which is its pitch too.
+	\param a_Height		Height of the buffer.
+	\param a_Image		A \a SoImage instance, palettized or not.
+	\param a_X			X of the top left pixel of the part that is drawn.
+	\param a_Y			Y of the top left pixel of the part that is drawn.
+	\param a_Source		Part of the image you want to draw, or \a NULL for all of it.
+	\param a_Flags		Any combination of \a SO_MODE4_RENDERER_BLIT_TRANSPARENT and
+						\a SO_MODE4_RENDERER_BLIT_FLIP_X, or 0.
+
+	Clips exactly like \a SoMode4RendererBlit. Palettized pixels are looked up in
+	the palette set by \a SoRendererSetPalette, and are transparent if their
+	index is zero. Pixels of images that aren't palettized are copied as they are,
+	and are transparent if they are zero (black). Scanlines of those are DMA'd
+	when the image is neither transparent nor flipped.
+*/
+// ----------------------------------------------------------------------------
+void SoRendererBlit16( u16* a_Buffer, s32 a_Width, s32 a_Height,
+					   const SoImage* a_Image, s32 a_X, s32 a_Y,
+					   const SoMode4RendererRectangle* a_Source, u32 a_Flags )
+{
+	// Part of the image to draw, the right and bottom are exclusive;
+	s32 left, top, right, bottom;
+
+	// Pixels that fall off the right or bottom of the buffer;
+	s32 overflow;
+
+	s32  width		 = SoImageGetWidth( a_Image );
+	bool flip		 = (a_Flags & SO_MODE4_RENDERER_BLIT_FLIP_X)	  != 0;
+	bool transparent = (a_Flags & SO_MODE4_RENDERER_BLIT_TRANSPARENT) != 0;
+	s32  step		 = flip ? -1 : 1;
+	s32  x, y, n;
+
+	u16* scanline;
+
+	if ( a_Source )
+	{
+		SO_ASSERT( a_Source->m_Left >= 0 && a_Source->m_Right  <= SoImageGetWidth(  a_Image ) &&
+				   a_Source->m_Top  >= 0 && a_Source->m_Bottom <= SoImageGetHeight( a_Image ),
+				   "Source rectangle must lie inside the image." );
+
+		left   = a_Source->m_Left;
+		top	   = a_Source->m_Top;
+		right  = a_Source->m_Right;
+		bottom = a_Source->m_Bottom;
+	}
+	else
+	{
+		left   = 0;
+		top	   = 0;
+		right  = width;
+		bottom = SoImageGetHeight( a_Image );
+	}
+
+	// Clip against the buffer. When flipped, the left of the buffer
+	// shows the right of the image;
+	if ( a_X < 0 )
+	{
+		if ( flip ) right += a_X; else left -= a_X;
+		a_X = 0;
+	}
+
+	if ( a_Y < 0 )
+	{
+		top -= a_Y;
+		a_Y  = 0;
+	}
+
+	overflow = a_X + (right - left) - a_Width;
+	if ( overflow > 0 )
+	{
+		if ( flip ) left += overflow; else right -= overflow;
+	}
+
+	overflow = a_Y + (bottom - top) - a_Height;
+	if ( overflow > 0 ) bottom -= overflow;
+
+	if ( right <= left || bottom <= top ) return;
+
+	n		 = right - left;
+	scanline = a_Buffer + a_Width * a_Y + a_X;
+
+	if ( SoImageIsPalettized( a_Image ) )
+	{
+		const u8* source = (const u8*) SoImageGetData( a_Image ) + width * top + (flip ? right - 1 : left);
+
+		for ( y = top; y < bottom; y++ )
+		{
+			if ( transparent )
+			{
+				for ( x = 0; x < n; x++ )
+				{
+					if ( source[ x * step ] ) scanline[ x ] = s_Palette[ source[ x * step ] ];
+				}
+			}
+			else if ( ! flip )
+			{
+				SoRendererExpandScanline16( scanline, source, n );
+			}
+			else
+			{
+				for ( x = 0; x < n; x++ )
+				{
+					scanline[ x ] = s_Palette[ source[ -x ] ];
+				}
+			}
+
+			source	 += width;
+			scanline += a_Width;
+		}
+	}
+	else
+	{
+		const u16* source = SoImageGetData( a_Image ) + width * top + (flip ? right - 1 : left);
+
+		for ( y = top; y < bottom; y++ )
+		{
+			if ( ! transparent && ! flip )
+			{
+				SoDMATransfer( 3, (void*) source, scanline, n,
+							   SO_DMA_SOURCE_INC | SO_DMA_DEST_INC | SO_DMA_16 );
+			}
+			else
+			{
+				for ( x = 0; x < n; x++ )
+				{
+					if ( ! transparent || source[ x * step ] ) scanline[ x ] = source[ x * step ];
+				}
+			}
+
+			source	 += width;
+			scanline += a_Width;
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Turns a row of palette indices into 16 bit colors.
+
+	\param	a_Destination	16 bit pixels.
+	\param	a_Source		Palette indices.
+	\param	a_NumPixels		Number of pixels.
+
+	Uses the palette set by \a SoRendererSetPalette. Used by \a SoCamera to
+	copy the bands it renders into a 16 bit renderer, see \a SoCameraSetRenderer.
+*/
+// ----------------------------------------------------------------------------
+void SoRendererExpandScanline16( u16* a_Destination, const u8* a_Source, u32 a_NumPixels )
+{
+	const u16* palette = s_Palette;
+
+	// Four at a time;
+	while ( a_NumPixels >= 4 )
+	{
+		a_Destination[ 0 ] = palette[ a_Source[ 0 ] ];
+		a_Destination[ 1 ] = palette[ a_Source[ 1 ] ];
+		a_Destination[ 2 ] = palette[ a_Source[ 2 ] ];
+		a_Destination[ 3 ] = palette[ a_Source[ 3 ] ];
+
+		a_Destination += 4;
+		a_Source	  += 4;
+		a_NumPixels	  -= 4;
+	}
+
+	// The rest;
+	while ( a_NumPixels-- )
+	{
+		*a_Destination++ = palette[ *a_Source++ ];
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
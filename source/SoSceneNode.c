@@ -0,0 +1,290 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoSceneNode.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoSceneNode
+
+	See the \a SoSceneNode module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoSceneNode.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Function implementations
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Initializes a scene node.
+
+	\param	a_This	This pointer
+	\param	a_Mesh	Mesh drawn at the node, or \a NULL for a node that only
+					moves its children.
+
+	The node gets an identity transform and no parent or children.
+*/
+// ----------------------------------------------------------------------------
+void SoSceneNodeInitialize( SoSceneNode* a_This, SoMesh* a_Mesh )
+{
+	SoTransformMakeIdentity( &a_This->m_Transform );
+
+	a_This->m_Mesh		  = a_Mesh;
+	a_This->m_Parent	  = NULL;
+	a_This->m_FirstChild  = NULL;
+	a_This->m_NextSibling = NULL;
+	a_This->m_Dirty		  = true;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Makes a node a child of this node.
+
+	\param	a_This	This pointer
+	\param	a_Child	Node without a parent. Use \a SoSceneNodeRemove first to
+					move a node to another parent.
+
+	The child now moves with this node, so its world matrix is recalculated.
+*/
+// ----------------------------------------------------------------------------
+void SoSceneNodeAddChild( SoSceneNode* a_This, SoSceneNode* a_Child )
+{
+	SO_ASSERT( a_Child->m_Parent == NULL, "Node already has a parent." );
+	SO_ASSERT( a_Child != a_This, "Node can't be its own child." );
+
+	// Put it in front, the order of the children doesn't matter;
+	a_Child->m_Parent	   = a_This;
+	a_Child->m_NextSibling = a_This->m_FirstChild;
+	a_This->m_FirstChild   = a_Child;
+
+	SoSceneNodeSetDirty( a_Child );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Removes a node from its parent.
+
+	\param	a_This	This pointer
+
+	The node keeps its own children, and becomes a root. Does nothing if it
+	has no parent.
+*/
+// ----------------------------------------------------------------------------
+void SoSceneNodeRemove( SoSceneNode* a_This )
+{
+	SoSceneNode** link;
+
+	if ( a_This->m_Parent == NULL ) return;
+
+	// Find the pointer to this node in the list of children;
+	link = &a_This->m_Parent->m_FirstChild;
+
+	while ( *link != a_This )
+	{
+		SO_ASSERT( *link != NULL, "Node is not a child of its parent." );
+
+		link = &(*link)->m_NextSibling;
+	}
+
+	*link				  = a_This->m_NextSibling;
+	a_This->m_Parent	  = NULL;
+	a_This->m_NextSibling = NULL;
+
+	SoSceneNodeSetDirty( a_This );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the parent of the node, or \a NULL if it is a root.
+
+	\param	a_This	This pointer
+*/
+// ----------------------------------------------------------------------------
+SoSceneNode* SoSceneNodeGetParent( SoSceneNode* a_This )
+{
+	return a_This->m_Parent;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the first child of the node, or \a NULL if it has none.
+
+	\param	a_This	This pointer
+
+	Use \a SoSceneNodeGetNextSibling on it to get the others.
+*/
+// ----------------------------------------------------------------------------
+SoSceneNode* SoSceneNodeGetFirstChild( SoSceneNode* a_This )
+{
+	return a_This->m_FirstChild;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the next child of the parent of the node, or \a NULL.
+
+	\param	a_This	This pointer
+*/
+// ----------------------------------------------------------------------------
+SoSceneNode* SoSceneNodeGetNextSibling( SoSceneNode* a_This )
+{
+	return a_This->m_NextSibling;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the mesh drawn at the node.
+
+	\param	a_This	This pointer
+	\param	a_Mesh	Mesh, or \a NULL for none.
+
+	Several nodes can share the same mesh.
+*/
+// ----------------------------------------------------------------------------
+void SoSceneNodeSetMesh( SoSceneNode* a_This, SoMesh* a_Mesh )
+{
+	a_This->m_Mesh = a_Mesh;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the mesh drawn at the node, or \a NULL.
+
+	\param	a_This	This pointer
+*/
+// ----------------------------------------------------------------------------
+SoMesh* SoSceneNodeGetMesh( SoSceneNode* a_This )
+{
+	return a_This->m_Mesh;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the transform of the node, relative to its parent.
+
+	\param	a_This	This pointer
+
+	Use this to move the node, it is marked dirty. So don't call it just to
+	look at the transform, or the world matrices below the node are
+	recalculated for nothing. If you hold on to the pointer and change the
+	transform later, call \a SoSceneNodeSetDirty yourself.
+*/
+// ----------------------------------------------------------------------------
+SoTransform* SoSceneNodeGetTransform( SoSceneNode* a_This )
+{
+	SoSceneNodeSetDirty( a_This );
+
+	return &a_This->m_Transform;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Marks the world matrix of the node and of everything below it out of date.
+
+	\param	a_This	This pointer
+
+	Stops at nodes that are already dirty, because everything below those is
+	too. So moving the same node many times in a frame costs nothing extra.
+*/
+// ----------------------------------------------------------------------------
+void SoSceneNodeSetDirty( SoSceneNode* a_This )
+{
+	SoSceneNode* child;
+
+	if ( a_This->m_Dirty ) return;
+
+	a_This->m_Dirty = true;
+
+	for ( child = a_This->m_FirstChild; child != NULL; child = child->m_NextSibling )
+	{
+		SoSceneNodeSetDirty( child );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the object to world matrix of the node.
+
+	\param	a_This	This pointer
+
+	\return	Pointer to the cached matrix, valid until the node or one of its
+			parents is changed.
+
+	Recalculated only if the node is dirty, from the world matrix of the parent
+	(which is recalculated first if needed) and the matrix of the transform.
+*/
+// ----------------------------------------------------------------------------
+SoMatrix* SoSceneNodeGetWorldMatrix( SoSceneNode* a_This )
+{
+	SoMatrix	 localMatrix;
+	sofixedpoint stretchBound;
+
+	if ( ! a_This->m_Dirty ) return &a_This->m_WorldMatrix;
+
+	stretchBound = SoTransformGetStretchBound( &a_This->m_Transform );
+
+	if ( a_This->m_Parent == NULL )
+	{
+		SoTransformToMatrix( &a_This->m_Transform, &a_This->m_WorldMatrix );
+	}
+	else
+	{
+		SoTransformToMatrix( &a_This->m_Transform, &localMatrix );
+		SoMatrixMultiply( &a_This->m_WorldMatrix, SoSceneNodeGetWorldMatrix( a_This->m_Parent ), &localMatrix );
+
+		// Keep it exactly one if nothing is scaled;
+		if ( a_This->m_Parent->m_StretchBound != SO_FIXED_FROM_WHOLE( 1 ) )
+		{
+			stretchBound = SoMathFixedMultiply( stretchBound, a_This->m_Parent->m_StretchBound );
+		}
+	}
+
+	a_This->m_StretchBound = stretchBound;
+	a_This->m_Dirty		   = false;
+
+	return &a_This->m_WorldMatrix;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns how much longer the world matrix can make a vector.
+
+	\param	a_This	This pointer
+
+	\return	Fixed point factor, exactly one if neither the node nor its parents
+			are scaled.
+
+	The product of \a SoTransformGetStretchBound of the node and its parents.
+	Used by \a SoCamera to grow bounding spheres.
+*/
+// ----------------------------------------------------------------------------
+sofixedpoint SoSceneNodeGetStretchBound( SoSceneNode* a_This )
+{
+	SoSceneNodeGetWorldMatrix( a_This );
+
+	return a_This->m_StretchBound;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
@@ -0,0 +1,416 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoTextureCache.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+	\ingroup	SoTextureCache
+
+	See the \a SoTextureCache module for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes
+// ----------------------------------------------------------------------------
+#include "SoTextureCache.h"
+#include "SoDMA.h"
+#include "SoDebug.h"
+
+// ----------------------------------------------------------------------------
+// Typedefs
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief	A texture in the cache.
+
+	\internal
+*/
+typedef struct
+{
+	const SoImage*	m_Texture;	//!< \internal Texture this is a copy of.
+	u32				m_Level;	//!< \internal Mipmap level of the texture this is a copy of.
+	u8*				m_Data;		//!< \internal Copy of the texture data.
+	u32				m_Size;		//!< \internal Number of bytes of the copy, a multiple of four.
+	u32				m_LastUse;	//!< \internal Value of \a s_UseCounter when last used.
+
+} SoTextureCacheEntry;
+
+// ----------------------------------------------------------------------------
+// Statics
+// ----------------------------------------------------------------------------
+
+//! \internal Textures in the cache, sorted on increasing address of their copy.
+static SoTextureCacheEntry s_Entries[ SO_TEXTURE_CACHE_MAX_NUM_ENTRIES ];
+
+static u32	s_NumEntries	= 0;	//!< \internal Number of textures in the cache.
+static u8*	s_Memory		= NULL;	//!< \internal Memory the copies live in, NULL if disabled.
+static u32	s_MemorySize	= 0;	//!< \internal Number of bytes of \a s_Memory.
+
+static u32	s_UseCounter	= 0;	//!< \internal Increased every time a texture is asked for.
+static u32	s_FrameStart	= 0;	//!< \internal Value of \a s_UseCounter at the start of the frame.
+
+static u32	s_NumHits		= 0;	//!< \internal Number of times a texture was in the cache.
+static u32	s_NumMisses		= 0;	//!< \internal Number of times a texture was not in the cache.
+static u32	s_NumEvictions	= 0;	//!< \internal Number of textures thrown out.
+
+// ----------------------------------------------------------------------------
+// Function forwards
+// ----------------------------------------------------------------------------
+u8*	 SoTextureCacheAllocate( u32 a_Size, u32* a_Index );
+bool SoTextureCacheEvict(	 void );
+void SoTextureCacheCompact(	 void );
+
+// ----------------------------------------------------------------------------
+// Function implementations.
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Gives the cache the memory to store textures in.
+
+	\param	a_Memory	Word aligned block of memory, preferably in IWRAM. NULL
+						disables the cache.
+	\param	a_Size		Number of bytes of \a a_Memory.
+
+	Throws out all textures that were in the cache. The memory belongs to the cache
+	until you call this function again.
+*/
+// ----------------------------------------------------------------------------
+void SoTextureCacheInitialize( void* a_Memory, u32 a_Size )
+{
+	SO_ASSERT( ((u32) a_Memory & 3) == 0, "Texture cache memory should be word aligned." );
+
+	s_Memory	 = a_Memory;
+	s_MemorySize = a_Memory == NULL ? 0 : a_Size & ~3;
+
+	SoTextureCacheFlush();
+	SoTextureCacheResetStatistics();
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Throws out all textures.
+
+	Call this if you change the data of a texture that might be in the cache.
+*/
+// ----------------------------------------------------------------------------
+void SoTextureCacheFlush( void )
+{
+	s_NumEntries = 0;
+	s_FrameStart = s_UseCounter;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Tells the cache a new frame starts.
+
+	Textures used since the previous call may be thrown out again from now on.
+	Call this once per frame, before drawing anything. \a SoCameraBeginFrame 
+	calls it, so only frames drawn without it need to call it themselves. 
+	Until it is called, nothing in the cache is ever thrown out.
+*/
+// ----------------------------------------------------------------------------
+void SoTextureCacheNextFrame( void )
+{
+	s_FrameStart = s_UseCounter;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the fastest copy of the data of the given texture.
+
+	\param	a_Texture	Palettized texture.
+	\param	a_Level		Mipmap level of the texture, 0 for the full size texture.
+						Every level is cached on its own, so only the levels 
+						in use take up room.
+
+	\return	The cached copy of the texture data if there is one, or if there is room
+			to make one. Otherwise the original data.
+
+	Copying a texture into the cache throws out the textures that weren't used
+	the longest, until there is room. Textures used in the current frame are never
+	thrown out (see \a SoTextureCacheNextFrame).
+
+	\warning The returned pointer is only valid until the next call to this
+			 function, because textures can be moved around to make room.
+*/
+// ----------------------------------------------------------------------------
+u8* SoTextureCacheGetData( const SoImage* a_Texture, u32 a_Level )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Size of the copy;
+	u32 size;
+
+	// Copy of the texture, and its index;
+	u8* data;
+	u32 index;
+
+	// Maybe the cache is disabled;
+	if ( s_Memory == NULL )
+	{
+		return (u8*) SoImageGetMipLevelData( a_Texture, a_Level );
+	}
+
+	++s_UseCounter;
+
+	// Is it in the cache already;
+	for ( i = 0; i < s_NumEntries; i++ )
+	{
+		if ( s_Entries[ i ].m_Texture == a_Texture && s_Entries[ i ].m_Level == a_Level )
+		{
+			++s_NumHits;
+			s_Entries[ i ].m_LastUse = s_UseCounter;
+			return s_Entries[ i ].m_Data;
+		}
+	}
+
+	++s_NumMisses;
+
+	// Find room for it, throwing out other textures if we have to;
+	size = (SoImageGetMipLevelWidth( a_Texture, a_Level ) * SoImageGetMipLevelHeight( a_Texture, a_Level ) + 3) & ~3;
+
+	if ( size > s_MemorySize )
+	{
+		return (u8*) SoImageGetMipLevelData( a_Texture, a_Level );
+	}
+
+	while ( (data = SoTextureCacheAllocate( size, &index )) == NULL )
+	{
+		if ( ! SoTextureCacheEvict() )
+		{
+			// Everything in the cache is used in this frame;
+			return (u8*) SoImageGetMipLevelData( a_Texture, a_Level );
+		}
+	}
+
+	// Copy it, the source is only halfword aligned;
+	SoDMATransfer( 3, SoImageGetMipLevelData( a_Texture, a_Level ), data, size >> 1,
+				   SO_DMA_SOURCE_INC | SO_DMA_DEST_INC | SO_DMA_16 );
+
+	s_Entries[ index ].m_Texture = a_Texture;
+	s_Entries[ index ].m_Level	 = a_Level;
+	s_Entries[ index ].m_Data	 = data;
+	s_Entries[ index ].m_Size	 = size;
+	s_Entries[ index ].m_LastUse = s_UseCounter;
+
+	return data;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of times a texture was found in the cache.
+*/
+// ----------------------------------------------------------------------------
+u32 SoTextureCacheGetNumHits( void )
+{
+	return s_NumHits;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of times a texture was not found in the cache.
+
+	This includes textures that could not be copied into the cache.
+*/
+// ----------------------------------------------------------------------------
+u32 SoTextureCacheGetNumMisses( void )
+{
+	return s_NumMisses;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Returns the number of times a texture was thrown out to make room.
+*/
+// ----------------------------------------------------------------------------
+u32 SoTextureCacheGetNumEvictions( void )
+{
+	return s_NumEvictions;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Sets the hit, miss and eviction counters to zero.
+*/
+// ----------------------------------------------------------------------------
+void SoTextureCacheResetStatistics( void )
+{
+	s_NumHits	   = 0;
+	s_NumMisses	   = 0;
+	s_NumEvictions = 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Finds room for a copy of the given size.
+
+	\internal
+
+	\param	a_Size		Number of bytes, a multiple of four.
+	\retval	a_Index		Index in \a s_Entries the new entry has to be filled in at.
+
+	\return	Address of the room, or NULL if there is not enough free memory.
+
+	Takes the first gap in between the copies that is big enough. If there is
+	enough free memory, but no gap is big enough, the copies are moved together first.
+	An entry is inserted at the returned index, keeping \a s_Entries sorted.
+*/
+// ----------------------------------------------------------------------------
+u8* SoTextureCacheAllocate( u32 a_Size, u32* a_Index )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Start of the current gap, and bytes in use;
+	u8* gapStart = s_Memory;
+	u32 used	 = 0;
+
+	// Is there a free entry;
+	if ( s_NumEntries == SO_TEXTURE_CACHE_MAX_NUM_ENTRIES )
+	{
+		return NULL;
+	}
+
+	// Look for a gap;
+	for ( i = 0; i <= s_NumEntries; i++ )
+	{
+		u8* gapEnd = i < s_NumEntries ? s_Entries[ i ].m_Data : s_Memory + s_MemorySize;
+
+		if ( (u32) (gapEnd - gapStart) >= a_Size )
+		{
+			break;
+		}
+
+		if ( i < s_NumEntries )
+		{
+			gapStart = s_Entries[ i ].m_Data + s_Entries[ i ].m_Size;
+			used	+= s_Entries[ i ].m_Size;
+		}
+	}
+
+	// No gap big enough, maybe there is after moving everything together;
+	if ( i > s_NumEntries )
+	{
+		if ( s_MemorySize - used < a_Size )
+		{
+			return NULL;
+		}
+
+		SoTextureCacheCompact();
+
+		i		 = s_NumEntries;
+		gapStart = s_NumEntries == 0 ? s_Memory
+				 : s_Entries[ i - 1 ].m_Data + s_Entries[ i - 1 ].m_Size;
+	}
+
+	// Make room for the new entry;
+	*a_Index = i;
+
+	for ( i = s_NumEntries; i > *a_Index; i-- )
+	{
+		s_Entries[ i ] = s_Entries[ i - 1 ];
+	}
+
+	++s_NumEntries;
+
+	return gapStart;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Throws out the least recently used texture.
+
+	\internal
+
+	\return	False if all textures are used in the current frame, and nothing
+			was thrown out.
+*/
+// ----------------------------------------------------------------------------
+bool SoTextureCacheEvict( void )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Least recently used entry;
+	u32 oldest = 0;
+
+	if ( s_NumEntries == 0 )
+	{
+		return false;
+	}
+
+	for ( i = 1; i < s_NumEntries; i++ )
+	{
+		if ( s_Entries[ i ].m_LastUse < s_Entries[ oldest ].m_LastUse )
+		{
+			oldest = i;
+		}
+	}
+
+	// Don't throw out what's on the screen;
+	if ( s_Entries[ oldest ].m_LastUse > s_FrameStart )
+	{
+		return false;
+	}
+
+	// Remove it, keeping the entries sorted;
+	--s_NumEntries;
+	for ( i = oldest; i < s_NumEntries; i++ )
+	{
+		s_Entries[ i ] = s_Entries[ i + 1 ];
+	}
+
+	++s_NumEvictions;
+
+	return true;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief	Moves all copies to the start of the cache memory, so all free memory
+			is one big gap at the end.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+void SoTextureCacheCompact( void )
+{
+	// Dummy counter;
+	u32 i;
+
+	// Where the next copy goes;
+	u8* destination = s_Memory;
+
+	for ( i = 0; i < s_NumEntries; i++ )
+	{
+		// The copies are sorted, so moving down never overwrites a copy we
+		// still need to move;
+		if ( s_Entries[ i ].m_Data != destination )
+		{
+			SO_DMA_MEMCPY( s_Entries[ i ].m_Data, destination, s_Entries[ i ].m_Size >> 2 );
+			s_Entries[ i ].m_Data = destination;
+		}
+
+		destination += s_Entries[ i ].m_Size;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF
+// ----------------------------------------------------------------------------
@@ -205,6 +205,32 @@ void SoTransformSetScale(
 }
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns how much longer the matrix of the transform can make a vector.
+
+	\return Fixed point factor, exactly one if the transform isn't scaled.
+
+	\a SoMatrixScale only scales the diagonal of the rotation, so the largest scale
+	doesn't bound how much longer a vector gets. One plus the largest difference 
+	of the scale from one does, both for that and for a real scale. Used to grow 
+	bounding spheres, see \a SoMeshCalculateBoundingSphere.
+*/
+// ----------------------------------------------------------------------------
+sofixedpoint SoTransformGetStretchBound( 
+									   SoTransform* a_This	//!< This pointer
+									   )
+{
+	sofixedpoint difference;
+
+	difference = SO_MAX( SO_ABS( a_This->m_Scale.m_X - SO_FIXED_FROM_WHOLE( 1 ) ), 
+						 SO_ABS( a_This->m_Scale.m_Y - SO_FIXED_FROM_WHOLE( 1 ) ) );
+	difference = SO_MAX( SO_ABS( a_This->m_Scale.m_Z - SO_FIXED_FROM_WHOLE( 1 ) ), difference );
+
+	return SO_FIXED_FROM_WHOLE( 1 ) + difference;
+}
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 /*!
 	\brief Returns a 3 by 4 matrix representation of the transform.
@@ -0,0 +1,335 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoCrossFadeTest.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+
+	Checks \a SoMode4RendererDrawCrossFadeImage on a PC. Images on a 32 bit
+	boundary are cross faded by the assembly routine SoMode4RendererCrossFadeWords,
+	which is run in \a SoArmEmulator. Images that are not are cross faded by
+	the C loop. Both should draw exactly the same bytes, for every fade level.
+
+	Run it with the object file of the assembly routine as argument, or just
+	do "make" in this directory. Returns 0 if all is well.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SoSystem.h"
+#include "SoDisplay.h"
+#include "SoTables.h"
+#include "SoImage.h"
+#include "SoFont.h"
+#include "SoDMA.h"
+#include "SoMode4Renderer.h"
+
+#include "SoArmEmulator.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! Number of bytes of a full screen image.
+#define SO_CROSS_FADE_TEST_IMAGE_SIZE	(SO_SCREEN_WIDTH * SO_SCREEN_HEIGHT)
+
+//! Number of different image pairs that are cross faded.
+#define SO_CROSS_FADE_TEST_NUM_IMAGES	4
+
+//! Value of the bytes the cross fade should overwrite.
+#define SO_CROSS_FADE_TEST_BACKGROUND	0xCD
+
+// ----------------------------------------------------------------------------
+// Variables;
+// ----------------------------------------------------------------------------
+
+//! The backbuffer of \a SoMode4Renderer.
+extern u16* s_SoMode4RendererBackBuffer;
+
+//! Pixels of the two images, on a 32 bit boundary.
+static u32 s_AlignedPixels[ 2 ][ SO_CROSS_FADE_TEST_IMAGE_SIZE / 4 ];
+
+//! The same pixels, two bytes after a 32 bit boundary.
+static u32 s_UnalignedPixels[ 2 ][ SO_CROSS_FADE_TEST_IMAGE_SIZE / 4 + 1 ];
+
+//! What the C loop and the assembly routine drew, with a guard word after each.
+static u32 s_Buffers[ 2 ][ SO_CROSS_FADE_TEST_IMAGE_SIZE / 4 + 1 ];
+
+//! Emulated addresses of the arguments of the assembly routine.
+static u32 s_EmulatedDestination;
+static u32 s_EmulatedImage0;
+static u32 s_EmulatedImage1;
+static u32 s_EmulatedTable;
+
+//! Number of times the assembly routine ran.
+static u32 s_NumEmulatedCalls = 0;
+
+//! State of the random number generator.
+static u32 s_Random = 1;
+
+//! Number of failed checks.
+static u32 s_NumFailures = 0;
+
+// ----------------------------------------------------------------------------
+// Stubs of the library functions the renderer calls;
+// ----------------------------------------------------------------------------
+
+void SoDebugAssert( bool a_Assertion, char* a_Message, char* a_Expression, char* a_File, u32 a_Line )
+{
+	if ( ! a_Assertion )
+	{
+		fprintf( stderr, "%s(%u): Assertion %s failed: %s\n", a_File, a_Line, a_Expression, a_Message );
+		exit( 1 );
+	}
+}
+
+s32	  SoMathDivide( s32 a_Numerator, s32 a_Denominator )			{ return a_Numerator / a_Denominator; }
+void  SoDisplaySetMode( u32 a_Mode )								{}
+void  SoDMATransfer( u32 a_Channel, void* a_Source, void* a_Destination, u32 a_WordCount, u32 a_Control ) {}
+void  SoDMA3Transfer( const void *a_Source, void *a_Destination, u32 a_WordCount, u32 a_Control ) {}
+u32	  SoFontGetGlyphWidth( const SoFont* a_This, char a_Character )	{ return 0; }
+u32	  SoFontGetAdvance( const SoFont* a_This, char a_Character, char a_Next ) { return 0; }
+char* ditoa( s32 num, char *buf, int len, int base )				{ return buf; }
+void  SoMode4PolygonRasterizerSetBuffer( void* a_Buffer )			{}
+void  SoMode4RendererClear( void )									{}
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Runs the assembly routine in the emulator, in place of the real one.
+
+	Copies the images and the table into emulated memory, and the result back.
+	The emulated destination starts out like the real one, so bytes the routine
+	doesn't write stay the same. The word after it should stay untouched.
+*/
+// ----------------------------------------------------------------------------
+void SoMode4RendererCrossFadeWords( u32* a_Destination, const u32* a_Image0,
+									const u32* a_Image1, u32 a_NumWords,
+									const u8* a_CrossFadeTable )
+{
+	u32	 size		   = a_NumWords * 4;
+	u32	 arguments[ 5 ] = { s_EmulatedDestination, s_EmulatedImage0, s_EmulatedImage1, a_NumWords, s_EmulatedTable };
+	u32* destination;
+
+	SO_ASSERT( size <= SO_CROSS_FADE_TEST_IMAGE_SIZE, "Too many words" );
+
+	destination = SoArmEmulatorGetPointer( s_EmulatedDestination, size + 4 );
+
+	memcpy( destination, a_Destination, size + 4 );
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedImage0, size ), a_Image0, size );
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedImage1, size ), a_Image1, size );
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedTable,  512  ), a_CrossFadeTable, 512 );
+
+	SoArmEmulatorCall( SoArmEmulatorGetSymbol( "SoMode4RendererCrossFadeWords" ), 5, arguments );
+
+	memcpy( a_Destination, destination, size + 4 );
+
+	s_NumEmulatedCalls++;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief The assembly routine needs no symbols from elsewhere.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoCrossFadeTestResolve( const char* a_Name )
+{
+	return 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a random number in between 0 and \a a_Range - 1.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoCrossFadeTestRandom( u32 a_Range )
+{
+	s_Random = s_Random * 1103515245 + 12345;
+
+	return (s_Random >> 8) % a_Range;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a random palette index, often the first or the last one.
+*/
+// ----------------------------------------------------------------------------
+static u8 SoCrossFadeTestRandomPixel( void )
+{
+	switch ( SoCrossFadeTestRandom( 8 ) )
+	{
+		case 0:	 return 0;
+		case 1:	 return 255;
+		default: return SoCrossFadeTestRandom( 256 );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Fills the two images with random pixels.
+
+	\param a_Similarity	Chance out of 8 that a pixel pair of the second image is
+						the same as in the first one. The more there are, the more
+						words are the same too, which both routines just copy.
+*/
+// ----------------------------------------------------------------------------
+static void SoCrossFadeTestMakeImages( u32 a_Similarity )
+{
+	u8* pixels0 = (u8*) s_AlignedPixels[ 0 ];
+	u8* pixels1 = (u8*) s_AlignedPixels[ 1 ];
+	u32 i;
+
+	for ( i = 0; i < SO_CROSS_FADE_TEST_IMAGE_SIZE; i += 2 )
+	{
+		pixels0[ i	   ] = SoCrossFadeTestRandomPixel();
+		pixels0[ i + 1 ] = SoCrossFadeTestRandomPixel();
+
+		if ( SoCrossFadeTestRandom( 8 ) < a_Similarity )
+		{
+			pixels1[ i	   ] = pixels0[ i	  ];
+			pixels1[ i + 1 ] = pixels0[ i + 1 ];
+		}
+		else
+		{
+			pixels1[ i	   ] = SoCrossFadeTestRandomPixel();
+			pixels1[ i + 1 ] = SoCrossFadeTestRandomPixel();
+		}
+	}
+
+	for ( i = 0; i < 2; i++ )
+	{
+		memcpy( (u8*) s_UnalignedPixels[ i ] + 2, s_AlignedPixels[ i ], SO_CROSS_FADE_TEST_IMAGE_SIZE );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Cross fades the images with both routines and compares the result.
+
+	\param a_Fade	Fade level.
+*/
+// ----------------------------------------------------------------------------
+static void SoCrossFadeTestLevel( u32 a_Fade )
+{
+	SoImage images[ 2 ][ 2 ];
+	u32		numCalls = s_NumEmulatedCalls;
+	u32		i, j;
+	bool	failed = false;
+
+	for ( i = 0; i < 2; i++ )
+	{
+		for ( j = 0; j < 2; j++ )
+		{
+			memset( &images[ i ][ j ], 0, sizeof( SoImage ) );
+
+			images[ i ][ j ].m_Width	   = SO_SCREEN_WIDTH;
+			images[ i ][ j ].m_Height	   = SO_SCREEN_HEIGHT;
+			images[ i ][ j ].m_Palettized  = true;
+			images[ i ][ j ].m_Data		   = i ? (u16*) s_AlignedPixels[ j ] : (u16*)( (u8*) s_UnalignedPixels[ j ] + 2 );
+		}
+	}
+
+	memset( s_Buffers, SO_CROSS_FADE_TEST_BACKGROUND, sizeof( s_Buffers ) );
+
+	// The C loop;
+	s_SoMode4RendererBackBuffer = (u16*) s_Buffers[ 0 ];
+	SoMode4RendererDrawCrossFadeImage( &images[ 0 ][ 0 ], &images[ 0 ][ 1 ], a_Fade );
+
+	if ( s_NumEmulatedCalls != numCalls )
+	{
+		printf( "FAILED: Images off a 32 bit boundary went to the assembly routine\n" );
+		failed = true;
+	}
+
+	// The assembly routine;
+	s_SoMode4RendererBackBuffer = (u16*) s_Buffers[ 1 ];
+	SoMode4RendererDrawCrossFadeImage( &images[ 1 ][ 0 ], &images[ 1 ][ 1 ], a_Fade );
+
+	if ( s_NumEmulatedCalls != numCalls + 1 )
+	{
+		printf( "FAILED: Images on a 32 bit boundary didn't go to the assembly routine\n" );
+		failed = true;
+	}
+
+	for ( i = 0; i < sizeof( s_Buffers[ 0 ] ) && ((u8*) s_Buffers[ 0 ])[ i ] == ((u8*) s_Buffers[ 1 ])[ i ]; i++ );
+
+	if ( i != sizeof( s_Buffers[ 0 ] ) )
+	{
+		printf( "FAILED: Fade level %2u: byte %u is 0x%02X instead of 0x%02X\n", a_Fade, i,
+				((u8*) s_Buffers[ 1 ])[ i ], ((u8*) s_Buffers[ 0 ])[ i ] );
+		failed = true;
+	}
+
+	if ( failed )
+	{
+		s_NumFailures++;
+	}
+	else
+	{
+		printf( "CrossFadeWords (ARM) and the C loop, fade level %2u, %6u instructions: same bytes\n",
+				a_Fade, SoArmEmulatorGetNumInstructions() );
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Loads the assembly routine, and runs the tests on a few images.
+*/
+// ----------------------------------------------------------------------------
+int main( int a_NumArguments, char** a_Arguments )
+{
+	s32 i;
+	u32 image;
+	u32 fade;
+
+	SoArmEmulatorReset();
+
+	s_EmulatedDestination = SoArmEmulatorAllocate( SO_CROSS_FADE_TEST_IMAGE_SIZE + 4 );
+	s_EmulatedImage0	  = SoArmEmulatorAllocate( SO_CROSS_FADE_TEST_IMAGE_SIZE );
+	s_EmulatedImage1	  = SoArmEmulatorAllocate( SO_CROSS_FADE_TEST_IMAGE_SIZE );
+	s_EmulatedTable		  = SoArmEmulatorAllocate( 512 );
+
+	for ( i = 1; i < a_NumArguments; i++ )
+	{
+		SoArmEmulatorLoadObject( a_Arguments[ i ], SoCrossFadeTestResolve );
+	}
+
+	for ( image = 0; image < SO_CROSS_FADE_TEST_NUM_IMAGES; image++ )
+	{
+		SoCrossFadeTestMakeImages( image * 8 / SO_CROSS_FADE_TEST_NUM_IMAGES );
+
+		// Every level, then a few again, so the table in IWRAM is reused and refilled;
+		for ( fade = 0; fade <= SO_FADE_MAX; fade++ ) SoCrossFadeTestLevel( fade );
+
+		SoCrossFadeTestLevel( SO_FADE_MAX );
+		SoCrossFadeTestLevel( SO_FADE_MAX / 2 );
+		SoCrossFadeTestLevel( 0 );
+	}
+
+	if ( s_NumFailures )
+	{
+		printf( "%u checks FAILED\n", s_NumFailures );
+		return 1;
+	}
+
+	printf( "All checks passed\n" );
+	return 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
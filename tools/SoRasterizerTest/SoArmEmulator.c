@@ -0,0 +1,1161 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoArmEmulator.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+
+	See SoArmEmulator.h for more information.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SoMath.h"
+#include "SoArmEmulator.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! \internal Return address of \a SoArmEmulatorCall. Running into it ends the call.
+#define SO_ARM_EMULATOR_RETURN_ADDRESS	0x0BADC0DC
+
+//! \internal Initial stack pointer, the same as on the GBA.
+#define SO_ARM_EMULATOR_STACK			0x03007F00
+
+//! \internal Number of instructions after which a call is considered stuck.
+#define SO_ARM_EMULATOR_MAX_INSTRUCTIONS	100000000
+
+//! \internal Maximum number of symbols of a loaded object file that are remembered.
+#define SO_ARM_EMULATOR_MAX_SYMBOLS		256
+
+// Flags in the status register;
+#define SO_ARM_EMULATOR_N	SO_BIT_31
+#define SO_ARM_EMULATOR_Z	SO_BIT_30
+#define SO_ARM_EMULATOR_C	SO_BIT_29
+#define SO_ARM_EMULATOR_V	SO_BIT_28
+
+// ELF constants we need;
+#define SO_ELF_SHT_SYMTAB		2
+#define SO_ELF_SHT_NOBITS		8
+#define SO_ELF_SHT_REL			9
+#define SO_ELF_SHF_ALLOC		2
+#define SO_ELF_SHN_UNDEF		0
+#define SO_ELF_R_ARM_NONE		0
+#define SO_ELF_R_ARM_ABS32		2
+#define SO_ELF_R_ARM_V4BX		40
+
+// ----------------------------------------------------------------------------
+// Typedefs;
+// ----------------------------------------------------------------------------
+
+typedef unsigned long long u64;	//!< \internal Unsigned 64 bit data type, for the long multiplies and the carry.
+
+//! \internal Symbol of a loaded object file.
+typedef struct
+{
+	char m_Name[ 64 ];	//!< \internal Name of the symbol.
+	u32	 m_Address;		//!< \internal Emulated address of the symbol.
+
+} SoArmEmulatorSymbol;
+
+// ----------------------------------------------------------------------------
+// Static variables;
+// ----------------------------------------------------------------------------
+
+static u8	s_Ewram[ SO_ARM_EMULATOR_EWRAM_SIZE ];	//!< \internal The emulated EWRAM.
+static u8	s_Iwram[ SO_ARM_EMULATOR_IWRAM_SIZE ];	//!< \internal The emulated IWRAM.
+
+static u32	s_EwramUsed;							//!< \internal Bytes handed out by \a SoArmEmulatorAllocate.
+static u32	s_IwramUsed;							//!< \internal Bytes used by loaded object files.
+
+static u32	s_Registers[ 16 ];						//!< \internal r0 to r15.
+static u32	s_Flags;								//!< \internal N, Z, C and V.
+static u32	s_NumInstructions;						//!< \internal Executed by the last call.
+static u32	s_NumCycles;							//!< \internal Taken by the last call.
+static u32	s_NumDivides;							//!< \internal BIOS divides of the last call.
+static u32	s_NumRangeCycles;						//!< \internal Taken by the last call in the profile range.
+static u32	s_RangeStart;							//!< \internal First address of the profile range.
+static u32	s_RangeEnd;								//!< \internal Address after the profile range.
+static bool	s_Jumped;								//!< \internal True if the current instruction wrote the PC.
+
+static SoArmEmulatorSymbol	s_Symbols[ SO_ARM_EMULATOR_MAX_SYMBOLS ];	//!< \internal Loaded symbols.
+static u32					s_NumSymbols;								//!< \internal Number of them.
+
+// ----------------------------------------------------------------------------
+// Private functions;
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Stops the test with a message, and the state of the processor.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorFail( const char* a_Message, u32 a_Value )
+{
+	u32 i;
+
+	fprintf( stderr, "SoArmEmulator: %s (0x%08X)\n", a_Message, a_Value );
+
+	for ( i = 0; i < 16; i++ )
+	{
+		fprintf( stderr, "r%-2u = 0x%08X%s", i, s_Registers[ i ], (i & 3) == 3 ? "\n" : "  " );
+	}
+
+	exit( 1 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the host address of some emulated memory, or NULL.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static u8* SoArmEmulatorMap( u32 a_Address, u32 a_Size )
+{
+	if ( a_Address >= SO_ARM_EMULATOR_EWRAM &&
+		 a_Address - SO_ARM_EMULATOR_EWRAM + a_Size <= SO_ARM_EMULATOR_EWRAM_SIZE )
+	{
+		return &s_Ewram[ a_Address - SO_ARM_EMULATOR_EWRAM ];
+	}
+
+	if ( a_Address >= SO_ARM_EMULATOR_IWRAM &&
+		 a_Address - SO_ARM_EMULATOR_IWRAM + a_Size <= SO_ARM_EMULATOR_IWRAM_SIZE )
+	{
+		return &s_Iwram[ a_Address - SO_ARM_EMULATOR_IWRAM ];
+	}
+
+	return NULL;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the cycles of an access, with the wait states of the GBA.
+
+	\internal
+
+	IWRAM takes 1 cycle for any access. EWRAM has a 16 bit bus with 2 wait
+	states, so it takes 3 cycles, and 6 for a word.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoArmEmulatorAccessCycles( u32 a_Address, u32 a_Size )
+{
+	if ( a_Address >= SO_ARM_EMULATOR_IWRAM ) return 1;
+
+	return a_Size == 4 ? 6 : 3;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Reads 1, 2 or 4 bytes. Misaligned and stray accesses stop the test.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static u32 SoArmEmulatorRead( u32 a_Address, u32 a_Size )
+{
+	u8* memory = SoArmEmulatorMap( a_Address, a_Size );
+
+	if ( memory == NULL )			 SoArmEmulatorFail( "Read outside of RAM", a_Address );
+	if ( a_Address & (a_Size - 1) )	 SoArmEmulatorFail( "Misaligned read", a_Address );
+
+	s_NumCycles += SoArmEmulatorAccessCycles( a_Address, a_Size );
+
+	if ( a_Size == 1 ) return memory[ 0 ];
+	if ( a_Size == 2 ) return memory[ 0 ] | (memory[ 1 ] << 8);
+
+	return memory[ 0 ] | (memory[ 1 ] << 8) | (memory[ 2 ] << 16) | ((u32) memory[ 3 ] << 24);
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Writes 1, 2 or 4 bytes. Misaligned and stray accesses stop the test.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorWrite( u32 a_Address, u32 a_Size, u32 a_Value )
+{
+	u8* memory = SoArmEmulatorMap( a_Address, a_Size );
+	u32 i;
+
+	if ( memory == NULL )			 SoArmEmulatorFail( "Write outside of RAM", a_Address );
+	if ( a_Address & (a_Size - 1) )	 SoArmEmulatorFail( "Misaligned write", a_Address );
+
+	s_NumCycles += SoArmEmulatorAccessCycles( a_Address, a_Size );
+
+	for ( i = 0; i < a_Size; i++ ) memory[ i ] = a_Value >> (i * 8);
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns true if the condition of an instruction holds.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static bool SoArmEmulatorCondition( u32 a_Condition )
+{
+	bool n = (s_Flags & SO_ARM_EMULATOR_N) != 0;
+	bool z = (s_Flags & SO_ARM_EMULATOR_Z) != 0;
+	bool c = (s_Flags & SO_ARM_EMULATOR_C) != 0;
+	bool v = (s_Flags & SO_ARM_EMULATOR_V) != 0;
+
+	switch ( a_Condition )
+	{
+		case 0x0: return z;
+		case 0x1: return ! z;
+		case 0x2: return c;
+		case 0x3: return ! c;
+		case 0x4: return n;
+		case 0x5: return ! n;
+		case 0x6: return v;
+		case 0x7: return ! v;
+		case 0x8: return c && ! z;
+		case 0x9: return ! c || z;
+		case 0xA: return n == v;
+		case 0xB: return n != v;
+		case 0xC: return ! z && n == v;
+		case 0xD: return z || n != v;
+		case 0xE: return true;
+	}
+
+	SoArmEmulatorFail( "Unknown condition", a_Condition );
+	return false;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Shifts a value like the barrel shifter does.
+
+	\internal
+
+	\param	a_Value		Value to shift.
+	\param	a_Type		0 for LSL, 1 for LSR, 2 for ASR and 3 for ROR.
+	\param	a_Amount	Number of bits.
+	\param	a_Immediate	True if the amount comes from the instruction. Then
+						an amount of 0 means 32 for LSR and ASR, and RRX for ROR.
+	\param	a_Carry		Carry in, set to the carry out.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoArmEmulatorShift( u32 a_Value, u32 a_Type, u32 a_Amount, bool a_Immediate, bool* a_Carry )
+{
+	if ( a_Immediate && a_Amount == 0 )
+	{
+		switch ( a_Type )
+		{
+			case 0: return a_Value;
+			case 1: a_Amount = 32; break;
+			case 2: a_Amount = 32; break;
+			case 3:
+			{
+				u32 result = (a_Value >> 1) | ((*a_Carry ? 1u : 0u) << 31);
+				*a_Carry = a_Value & 1;
+				return result;
+			}
+		}
+	}
+
+	if ( a_Amount == 0 ) return a_Value;
+
+	switch ( a_Type )
+	{
+		case 0:
+			if ( a_Amount < 32 )  { *a_Carry = (a_Value >> (32 - a_Amount)) & 1; return a_Value << a_Amount; }
+			if ( a_Amount == 32 ) { *a_Carry = a_Value & 1; return 0; }
+			*a_Carry = false;
+			return 0;
+
+		case 1:
+			if ( a_Amount < 32 )  { *a_Carry = (a_Value >> (a_Amount - 1)) & 1; return a_Value >> a_Amount; }
+			if ( a_Amount == 32 ) { *a_Carry = a_Value >> 31; return 0; }
+			*a_Carry = false;
+			return 0;
+
+		case 2:
+			if ( a_Amount < 32 )  { *a_Carry = (a_Value >> (a_Amount - 1)) & 1; return (u32)((s32) a_Value >> a_Amount); }
+			*a_Carry = a_Value >> 31;
+			return *a_Carry ? 0xFFFFFFFF : 0;
+
+		default:
+			a_Amount &= 31;
+			if ( a_Amount == 0 ) { *a_Carry = a_Value >> 31; return a_Value; }
+			*a_Carry = (a_Value >> (a_Amount - 1)) & 1;
+			return (a_Value >> a_Amount) | (a_Value << (32 - a_Amount));
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Sets N and Z from a result, and optionally C and V.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorSetFlags( u32 a_Result, bool a_Carry, bool a_Overflow, bool a_Arithmetic )
+{
+	u32 flags = s_Flags & (a_Arithmetic ? 0 : SO_ARM_EMULATOR_V);
+
+	if ( a_Result & SO_BIT_31 ) flags |= SO_ARM_EMULATOR_N;
+	if ( a_Result == 0 )		flags |= SO_ARM_EMULATOR_Z;
+	if ( a_Carry )				flags |= SO_ARM_EMULATOR_C;
+	if ( a_Arithmetic && a_Overflow ) flags |= SO_ARM_EMULATOR_V;
+
+	s_Flags = flags;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes a data processing instruction.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorDataProcessing( u32 a_Instruction )
+{
+	u32  opcode		= (a_Instruction >> 21) & 0xF;
+	bool setFlags	= (a_Instruction >> 20) & 1;
+	u32  rn			= (a_Instruction >> 16) & 0xF;
+	u32  rd			= (a_Instruction >> 12) & 0xF;
+	bool carry		= (s_Flags & SO_ARM_EMULATOR_C) != 0;
+	bool carryIn	= carry;
+	bool overflow	= false;
+	bool arithmetic = false;
+	bool writeBack	= true;
+	u32  operand1	= s_Registers[ rn ];
+	u32  operand2;
+	u32  result;
+	u64	 wide;
+
+	// Calculate the second operand;
+	if ( a_Instruction & SO_BIT_25 )
+	{
+		u32 rotate = ((a_Instruction >> 8) & 0xF) * 2;
+
+		operand2 = a_Instruction & 0xFF;
+
+		if ( rotate )
+		{
+			operand2 = (operand2 >> rotate) | (operand2 << (32 - rotate));
+			carry	 = operand2 >> 31;
+		}
+	}
+	else if ( a_Instruction & SO_BIT_4 )
+	{
+		u32 rs = (a_Instruction >> 8) & 0xF;
+		u32 rm = a_Instruction & 0xF;
+
+		if ( rm == 15 || rn == 15 || rs == 15 ) SoArmEmulatorFail( "PC in a register shifted instruction", a_Instruction );
+
+		// Reading the third register takes a cycle;
+		s_NumCycles++;
+
+		operand2 = SoArmEmulatorShift( s_Registers[ rm ], (a_Instruction >> 5) & 3,
+									   s_Registers[ rs ] & 0xFF, false, &carry );
+	}
+	else
+	{
+		operand2 = SoArmEmulatorShift( s_Registers[ a_Instruction & 0xF ], (a_Instruction >> 5) & 3,
+									   (a_Instruction >> 7) & 0x1F, true, &carry );
+	}
+
+	switch ( opcode )
+	{
+		case 0x0: result = operand1 & operand2; break;
+		case 0x1: result = operand1 ^ operand2; break;
+		case 0x8: result = operand1 & operand2; writeBack = false; break;
+		case 0x9: result = operand1 ^ operand2; writeBack = false; break;
+		case 0xC: result = operand1 | operand2; break;
+		case 0xD: result = operand2; break;
+		case 0xE: result = operand1 & ~operand2; break;
+		case 0xF: result = ~operand2; break;
+
+		case 0x2: case 0x6: case 0xA:
+			// SUB, SBC and CMP;
+			wide	   = (u64) operand1 + (u32) ~operand2 + (opcode == 0x6 ? carryIn : 1);
+			result	   = (u32) wide;
+			carry	   = (wide >> 32) != 0;
+			overflow   = ((operand1 ^ operand2) & (operand1 ^ result)) >> 31;
+			arithmetic = true;
+			writeBack  = opcode != 0xA;
+			break;
+
+		case 0x3: case 0x7:
+			// RSB and RSC;
+			wide	   = (u64) operand2 + (u32) ~operand1 + (opcode == 0x7 ? carryIn : 1);
+			result	   = (u32) wide;
+			carry	   = (wide >> 32) != 0;
+			overflow   = ((operand2 ^ operand1) & (operand2 ^ result)) >> 31;
+			arithmetic = true;
+			break;
+
+		default:
+			// ADD, ADC and CMN;
+			wide	   = (u64) operand1 + operand2 + (opcode == 0x5 ? carryIn : 0);
+			result	   = (u32) wide;
+			carry	   = (wide >> 32) != 0;
+			overflow   = (~(operand1 ^ operand2) & (operand1 ^ result)) >> 31;
+			arithmetic = true;
+			writeBack  = opcode != 0xB;
+			break;
+	}
+
+	if ( ! writeBack && ! setFlags ) SoArmEmulatorFail( "Status register transfers are not supported", a_Instruction );
+
+	if ( setFlags )
+	{
+		if ( rd == 15 && writeBack ) SoArmEmulatorFail( "Mode changes are not supported", a_Instruction );
+
+		SoArmEmulatorSetFlags( result, carry, overflow, arithmetic );
+	}
+
+	if ( writeBack )
+	{
+		s_Registers[ rd ] = result;
+		s_Jumped		 |= rd == 15;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes MUL, MLA and the long multiplies.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorMultiply( u32 a_Instruction )
+{
+	bool setFlags = (a_Instruction >> 20) & 1;
+	bool add	  = (a_Instruction >> 21) & 1;
+	u32  rdHi	  = (a_Instruction >> 16) & 0xF;
+	u32  rdLo	  = (a_Instruction >> 12) & 0xF;
+	u32  rs		  = (a_Instruction >>  8) & 0xF;
+	u32  rm		  = a_Instruction & 0xF;
+	u32  top	  = s_Registers[ rs ];
+	u64  result;
+
+	// The multiplier does 8 bits of Rs per cycle, and stops early when
+	// the rest is all zeroes, or all ones for the signed multiplies;
+	if ( (top & SO_BIT_31) && ! ( (a_Instruction & SO_BIT_23) && ! (a_Instruction & SO_BIT_22) ) ) top = ~top;
+
+	s_NumCycles += top < 0x100 ? 1 : top < 0x10000 ? 2 : top < 0x1000000 ? 3 : 4;
+	if ( add )							s_NumCycles++;
+	if ( a_Instruction & SO_BIT_23 )	s_NumCycles++;
+
+	if ( a_Instruction & SO_BIT_23 )
+	{
+		// Long multiplies;
+		if ( a_Instruction & SO_BIT_22 )
+		{
+			result = (u64)( (s64)(s32) s_Registers[ rm ] * (s32) s_Registers[ rs ] );
+		}
+		else
+		{
+			result = (u64) s_Registers[ rm ] * s_Registers[ rs ];
+		}
+
+		if ( add ) result += ((u64) s_Registers[ rdHi ] << 32) | s_Registers[ rdLo ];
+
+		s_Registers[ rdLo ] = (u32) result;
+		s_Registers[ rdHi ] = (u32)( result >> 32 );
+
+		if ( setFlags )
+		{
+			s_Flags &= ~(SO_ARM_EMULATOR_N | SO_ARM_EMULATOR_Z);
+			if ( result >> 63 ) s_Flags |= SO_ARM_EMULATOR_N;
+			if ( result == 0 )	s_Flags |= SO_ARM_EMULATOR_Z;
+		}
+	}
+	else
+	{
+		// MUL and MLA. The destination is in the Rn position;
+		result = (u32)( s_Registers[ rm ] * s_Registers[ rs ] + (add ? s_Registers[ rdLo ] : 0) );
+
+		s_Registers[ rdHi ] = (u32) result;
+
+		if ( setFlags )
+		{
+			s_Flags &= ~(SO_ARM_EMULATOR_N | SO_ARM_EMULATOR_Z);
+			if ( result & SO_BIT_31 ) s_Flags |= SO_ARM_EMULATOR_N;
+			if ( result == 0 )		  s_Flags |= SO_ARM_EMULATOR_Z;
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes LDRH, STRH, LDRSB and LDRSH.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorHalfwordTransfer( u32 a_Instruction )
+{
+	bool preIndex  = (a_Instruction >> 24) & 1;
+	bool up		   = (a_Instruction >> 23) & 1;
+	bool writeBack = (a_Instruction >> 21) & 1;
+	bool load	   = (a_Instruction >> 20) & 1;
+	u32  rn		   = (a_Instruction >> 16) & 0xF;
+	u32  rd		   = (a_Instruction >> 12) & 0xF;
+	u32  type	   = (a_Instruction >> 5) & 3;
+	u32  offset;
+	u32  address;
+	u32  value;
+
+	if ( a_Instruction & SO_BIT_22 )
+	{
+		offset = ((a_Instruction >> 4) & 0xF0) | (a_Instruction & 0xF);
+	}
+	else
+	{
+		offset = s_Registers[ a_Instruction & 0xF ];
+	}
+
+	if ( ! up ) offset = -offset;
+
+	address = s_Registers[ rn ] + (preIndex ? offset : 0);
+
+	if ( load )
+	{
+		switch ( type )
+		{
+			case 1:	 value = SoArmEmulatorRead( address, 2 ); break;
+			case 2:	 value = (u32)(s32)(s8) SoArmEmulatorRead( address, 1 ); break;
+			default: value = (u32)(s32)(s16) SoArmEmulatorRead( address, 2 ); break;
+		}
+
+		// Writing the loaded register back takes a cycle;
+		s_NumCycles++;
+	}
+	else
+	{
+		if ( type != 1 ) SoArmEmulatorFail( "Unknown halfword store", a_Instruction );
+
+		SoArmEmulatorWrite( address, 2, s_Registers[ rd ] );
+	}
+
+	if ( ! preIndex || writeBack ) s_Registers[ rn ] += offset;
+	if ( load )					   s_Registers[ rd ]  = value;
+
+	s_Jumped |= ( load && rd == 15 ) || ( (! preIndex || writeBack) && rn == 15 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes LDR, STR, LDRB and STRB.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorSingleTransfer( u32 a_Instruction )
+{
+	bool preIndex  = (a_Instruction >> 24) & 1;
+	bool up		   = (a_Instruction >> 23) & 1;
+	bool byte	   = (a_Instruction >> 22) & 1;
+	bool writeBack = (a_Instruction >> 21) & 1;
+	bool load	   = (a_Instruction >> 20) & 1;
+	u32  rn		   = (a_Instruction >> 16) & 0xF;
+	u32  rd		   = (a_Instruction >> 12) & 0xF;
+	bool carry	   = (s_Flags & SO_ARM_EMULATOR_C) != 0;
+	u32  offset;
+	u32  address;
+	u32  value = 0;
+
+	if ( a_Instruction & SO_BIT_25 )
+	{
+		if ( a_Instruction & SO_BIT_4 ) SoArmEmulatorFail( "Undefined instruction", a_Instruction );
+
+		offset = SoArmEmulatorShift( s_Registers[ a_Instruction & 0xF ], (a_Instruction >> 5) & 3,
+									 (a_Instruction >> 7) & 0x1F, true, &carry );
+	}
+	else
+	{
+		offset = a_Instruction & 0xFFF;
+	}
+
+	if ( ! up ) offset = -offset;
+
+	address = s_Registers[ rn ] + (preIndex ? offset : 0);
+
+	if ( load )
+	{
+		value = SoArmEmulatorRead( address, byte ? 1 : 4 );
+		s_NumCycles++;
+	}
+	else
+	{
+		// A stored PC is 12 ahead on the ARM7;
+		SoArmEmulatorWrite( address, byte ? 1 : 4, s_Registers[ rd ] + (rd == 15 ? 4 : 0) );
+	}
+
+	if ( ! preIndex || writeBack ) s_Registers[ rn ] += offset;
+	if ( load )					   s_Registers[ rd ]  = value;
+
+	s_Jumped |= ( load && rd == 15 ) || ( (! preIndex || writeBack) && rn == 15 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes LDM and STM.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorBlockTransfer( u32 a_Instruction )
+{
+	bool preIndex  = (a_Instruction >> 24) & 1;
+	bool up		   = (a_Instruction >> 23) & 1;
+	bool writeBack = (a_Instruction >> 21) & 1;
+	bool load	   = (a_Instruction >> 20) & 1;
+	u32  rn		   = (a_Instruction >> 16) & 0xF;
+	u32  list	   = a_Instruction & 0xFFFF;
+	u32  count	   = 0;
+	u32  base	   = s_Registers[ rn ];
+	u32  address;
+	u32  i;
+
+	if ( a_Instruction & SO_BIT_22 ) SoArmEmulatorFail( "User bank transfers are not supported", a_Instruction );
+	if ( list == 0 )				 SoArmEmulatorFail( "Empty register list", a_Instruction );
+
+	for ( i = 0; i < 16; i++ ) if ( list & (1 << i) ) count++;
+
+	// The lowest register always goes to the lowest address;
+	address = up ? base : base - count * 4;
+	if ( preIndex == up ) address += 4;
+
+	if ( writeBack ) s_Registers[ rn ] = up ? base + count * 4 : base - count * 4;
+	if ( load )		 s_NumCycles++;
+
+	for ( i = 0; i < 16; i++ )
+	{
+		if ( ! (list & (1 << i)) ) continue;
+
+		if ( load )
+		{
+			s_Registers[ i ] = SoArmEmulatorRead( address, 4 );
+			s_Jumped		|= i == 15;
+		}
+		else
+		{
+			SoArmEmulatorWrite( address, 4, i == rn ? base : s_Registers[ i ] + (i == 15 ? 4 : 0) );
+		}
+
+		address += 4;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes the BIOS calls we know about, which is only Div.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorSoftwareInterrupt( u32 a_Instruction )
+{
+	s32 numerator	= s_Registers[ 0 ];
+	s32 denominator = s_Registers[ 1 ];
+
+	// In ARM state the BIOS takes the number from bits 16 to 23;
+	if ( ((a_Instruction >> 16) & 0xFF) != 6 ) SoArmEmulatorFail( "Unknown BIOS call", a_Instruction );
+	if ( denominator == 0 )					  SoArmEmulatorFail( "BIOS division by zero", numerator );
+
+	s_Registers[ 0 ] = numerator / denominator;
+	s_Registers[ 1 ] = numerator % denominator;
+	s_Registers[ 3 ] = SO_ABS( numerator / denominator );
+
+	s_NumCycles += SO_ARM_EMULATOR_DIVIDE_CYCLES;
+	s_NumDivides++;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes one instruction.
+
+	\internal
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorExecute( void )
+{
+	u32 address		= s_Registers[ 15 ];
+	u32 instruction = SoArmEmulatorRead( address, 4 );
+
+	// Reading the PC gives the address of the instruction plus 8;
+	s_Registers[ 15 ] = address + 8;
+	s_Jumped		  = false;
+	s_NumInstructions++;
+
+	if ( SoArmEmulatorCondition( instruction >> 28 ) )
+	{
+		if ( (instruction & 0x0FFFFFF0) == 0x012FFF10 )
+		{
+			// BX;
+			if ( s_Registers[ instruction & 0xF ] & 1 ) SoArmEmulatorFail( "Thumb code is not supported", instruction );
+			s_Registers[ 15 ] = s_Registers[ instruction & 0xF ];
+			s_Jumped		  = true;
+			s_NumCycles		 += 2;
+			return;
+		}
+
+		switch ( (instruction >> 25) & 7 )
+		{
+			case 0:
+				if ( (instruction & 0x0FC000F0) == 0x00000090 || (instruction & 0x0F8000F0) == 0x00800090 )
+				{
+					SoArmEmulatorMultiply( instruction );
+				}
+				else if ( (instruction & 0x90) == 0x90 )
+				{
+					if ( (instruction & 0x60) == 0 ) SoArmEmulatorFail( "Swaps are not supported", instruction );
+					SoArmEmulatorHalfwordTransfer( instruction );
+				}
+				else
+				{
+					SoArmEmulatorDataProcessing( instruction );
+				}
+				break;
+
+			case 1:
+				SoArmEmulatorDataProcessing( instruction );
+				break;
+
+			case 2:
+			case 3:
+				SoArmEmulatorSingleTransfer( instruction );
+				break;
+
+			case 4:
+				SoArmEmulatorBlockTransfer( instruction );
+				break;
+
+			case 5:
+				if ( instruction & SO_BIT_24 ) s_Registers[ 14 ] = address + 4;
+				s_Registers[ 15 ] += (u32)( ((s32)( instruction << 8 )) >> 6 );
+				s_NumCycles		  += 2;
+				return;
+
+			case 7:
+				if ( instruction & SO_BIT_24 )
+				{
+					SoArmEmulatorSoftwareInterrupt( instruction );
+					break;
+				}
+				// Fall through;
+
+			default:
+				SoArmEmulatorFail( "Coprocessor instructions are not supported", instruction );
+		}
+	}
+
+	// Move on, unless the instruction wrote the PC;
+	if ( ! s_Jumped )
+	{
+		s_Registers[ 15 ] = address + 4;
+	}
+	else if ( s_Registers[ 15 ] & 3 )
+	{
+		SoArmEmulatorFail( "Misaligned jump", s_Registers[ 15 ] );
+	}
+	else
+	{
+		s_NumCycles += 2;
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Executes one instruction, and counts its cycles in the profile range.
+
+	\internal
+
+	The cycles are those of the ARM7TDMI of the GBA, running from IWRAM. An
+	instruction that jumps takes two more, to fill the pipeline again.
+*/
+// ----------------------------------------------------------------------------
+static void SoArmEmulatorStep( void )
+{
+	u32 address		= s_Registers[ 15 ];
+	u32 cycles		= s_NumCycles;
+
+	SoArmEmulatorExecute();
+
+	if ( address >= s_RangeStart && address < s_RangeEnd ) s_NumRangeCycles += s_NumCycles - cycles;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Public functions;
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Clears the emulated memory and forgets all allocations and object files.
+*/
+// ----------------------------------------------------------------------------
+void SoArmEmulatorReset( void )
+{
+	memset( s_Ewram, 0, sizeof( s_Ewram ) );
+	memset( s_Iwram, 0, sizeof( s_Iwram ) );
+
+	s_EwramUsed	 = 0;
+	s_IwramUsed	 = 0;
+	s_NumSymbols = 0;
+	s_RangeStart = 0;
+	s_RangeEnd	 = 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the emulated address of some fresh EWRAM, on a 32 bit boundary.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorAllocate( u32 a_Size )
+{
+	u32 address = SO_ARM_EMULATOR_EWRAM + s_EwramUsed;
+
+	s_EwramUsed += (a_Size + 3) & ~3;
+
+	if ( s_EwramUsed > SO_ARM_EMULATOR_EWRAM_SIZE ) SoArmEmulatorFail( "Out of EWRAM", a_Size );
+
+	return address;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a host pointer to some emulated memory, to fill it or check it.
+*/
+// ----------------------------------------------------------------------------
+void* SoArmEmulatorGetPointer( u32 a_Address, u32 a_Size )
+{
+	u8* memory = SoArmEmulatorMap( a_Address, a_Size );
+
+	if ( memory == NULL ) SoArmEmulatorFail( "Pointer outside of RAM", a_Address );
+
+	return memory;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Loads a relocatable ELF object file into IWRAM.
+
+	\param	a_FileName	Name of the object file.
+	\param	a_Resolver	Gives the address of the symbols the file doesn't define.
+
+	Only absolute 32 bit relocations are done, which is what the literal pools
+	of the assembly routines need. The global symbols are remembered for
+	\a SoArmEmulatorGetSymbol.
+*/
+// ----------------------------------------------------------------------------
+void SoArmEmulatorLoadObject( const char* a_FileName, SoArmEmulatorSymbolResolver a_Resolver )
+{
+	FILE* file = fopen( a_FileName, "rb" );
+	u8*   data;
+	long  size;
+	u32	  numSections, sectionHeaders, sectionHeaderSize;
+	u32*  sectionAddresses;
+	u32	  i, j;
+
+	if ( file == NULL )
+	{
+		fprintf( stderr, "SoArmEmulator: Can't open %s\n", a_FileName );
+		exit( 1 );
+	}
+
+	fseek( file, 0, SEEK_END );
+	size = ftell( file );
+	fseek( file, 0, SEEK_SET );
+	data = malloc( size );
+	if ( fread( data, 1, size, file ) != (size_t) size ) SoArmEmulatorFail( "Can't read the object file", 0 );
+	fclose( file );
+
+	#define SO_ELF_U16( o ) ( data[ (o) ] | (data[ (o) + 1 ] << 8) )
+	#define SO_ELF_U32( o ) ( SO_ELF_U16( o ) | ((u32) SO_ELF_U16( (o) + 2 ) << 16) )
+	#define SO_ELF_SECTION( s, o ) SO_ELF_U32( sectionHeaders + (s) * sectionHeaderSize + (o) )
+
+	// 32 bit, little endian, relocatable, ARM;
+	if ( memcmp( data, "\177ELF\1\1", 6 ) != 0 || SO_ELF_U16( 16 ) != 1 || SO_ELF_U16( 18 ) != 40 )
+	{
+		SoArmEmulatorFail( "Not an ARM object file", 0 );
+	}
+
+	sectionHeaders	  = SO_ELF_U32( 32 );
+	sectionHeaderSize = SO_ELF_U16( 46 );
+	numSections		  = SO_ELF_U16( 48 );
+	sectionAddresses  = calloc( numSections, sizeof( u32 ) );
+
+	// Put the sections that take memory in IWRAM;
+	for ( i = 0; i < numSections; i++ )
+	{
+		u32 flags	  = SO_ELF_SECTION( i, 8 );
+		u32 offset	  = SO_ELF_SECTION( i, 16 );
+		u32 length	  = SO_ELF_SECTION( i, 20 );
+		u32 alignment = SO_ELF_SECTION( i, 32 );
+
+		if ( ! (flags & SO_ELF_SHF_ALLOC) || length == 0 ) continue;
+
+		if ( alignment > 1 ) s_IwramUsed = (s_IwramUsed + alignment - 1) & ~(alignment - 1);
+
+		if ( s_IwramUsed + length > SO_ARM_EMULATOR_STACK - 0x1000 - SO_ARM_EMULATOR_IWRAM )
+		{
+			SoArmEmulatorFail( "Out of IWRAM", length );
+		}
+
+		sectionAddresses[ i ] = SO_ARM_EMULATOR_IWRAM + s_IwramUsed;
+
+		if ( SO_ELF_SECTION( i, 4 ) != SO_ELF_SHT_NOBITS )
+		{
+			memcpy( &s_Iwram[ s_IwramUsed ], &data[ offset ], length );
+		}
+
+		s_IwramUsed += length;
+	}
+
+	// Remember the global symbols and the labels, and relocate;
+	for ( i = 0; i < numSections; i++ )
+	{
+		u32 type	   = SO_ELF_SECTION( i, 4 );
+		u32 offset	   = SO_ELF_SECTION( i, 16 );
+		u32 length	   = SO_ELF_SECTION( i, 20 );
+		u32 link	   = SO_ELF_SECTION( i, 24 );
+		u32 info	   = SO_ELF_SECTION( i, 28 );
+		u32 symbols	   = SO_ELF_SECTION( link, 16 );
+		u32 names	   = SO_ELF_SECTION( SO_ELF_SECTION( link, 24 ), 16 );
+
+		if ( type == SO_ELF_SHT_SYMTAB )
+		{
+			names = SO_ELF_SECTION( link, 16 );
+
+			for ( j = 0; j < length / 16; j++ )
+			{
+				u32 symbol = offset + j * 16;
+				u32 index  = SO_ELF_U16( symbol + 14 );
+
+				// Global, or a local label without a type, and defined;
+				if ( (data[ symbol + 12 ] >> 4) > 1 || ( (data[ symbol + 12 ] >> 4) == 0 && (data[ symbol + 12 ] & 0xF) != 0 ) ) continue;
+				if ( index == SO_ELF_SHN_UNDEF || index >= numSections || sectionAddresses[ index ] == 0 ) continue;
+				if ( data[ names + SO_ELF_U32( symbol ) ] == '$' || data[ names + SO_ELF_U32( symbol ) ] == 0 ) continue;
+				if ( s_NumSymbols == SO_ARM_EMULATOR_MAX_SYMBOLS ) SoArmEmulatorFail( "Too many symbols", 0 );
+
+				strncpy( s_Symbols[ s_NumSymbols ].m_Name, (char*) &data[ names + SO_ELF_U32( symbol ) ], 63 );
+				s_Symbols[ s_NumSymbols ].m_Address = sectionAddresses[ index ] + SO_ELF_U32( symbol + 4 );
+				s_NumSymbols++;
+			}
+		}
+		else if ( type == SO_ELF_SHT_REL && sectionAddresses[ info ] != 0 )
+		{
+			for ( j = 0; j < length / 8; j++ )
+			{
+				u32 where	   = SO_ELF_U32( offset + j * 8 );
+				u32 relocation = SO_ELF_U32( offset + j * 8 + 4 );
+				u32 symbol	   = symbols + (relocation >> 8) * 16;
+				u32 index	   = SO_ELF_U16( symbol + 14 );
+				u32 address;
+				u32 value;
+
+				if ( (relocation & 0xFF) == SO_ELF_R_ARM_NONE || (relocation & 0xFF) == SO_ELF_R_ARM_V4BX ) continue;
+				if ( (relocation & 0xFF) != SO_ELF_R_ARM_ABS32 ) SoArmEmulatorFail( "Unknown relocation", relocation );
+
+				if ( index == SO_ELF_SHN_UNDEF )
+				{
+					address = a_Resolver( (char*) &data[ names + SO_ELF_U32( symbol ) ] );
+
+					if ( address == 0 )
+					{
+						fprintf( stderr, "SoArmEmulator: Unknown symbol %s\n", (char*) &data[ names + SO_ELF_U32( symbol ) ] );
+						exit( 1 );
+					}
+				}
+				else
+				{
+					address = sectionAddresses[ index ] + SO_ELF_U32( symbol + 4 );
+				}
+
+				value = SoArmEmulatorRead( sectionAddresses[ info ] + where, 4 );
+				SoArmEmulatorWrite( sectionAddresses[ info ] + where, 4, value + address );
+			}
+		}
+	}
+
+	#undef SO_ELF_SECTION
+	#undef SO_ELF_U32
+	#undef SO_ELF_U16
+
+	free( sectionAddresses );
+	free( data );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the emulated address of a global symbol or a label of a loaded object file.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorGetSymbol( const char* a_Name )
+{
+	u32 i;
+
+	for ( i = 0; i < s_NumSymbols; i++ )
+	{
+		if ( strcmp( s_Symbols[ i ].m_Name, a_Name ) == 0 ) return s_Symbols[ i ].m_Address;
+	}
+
+	fprintf( stderr, "SoArmEmulator: No symbol %s was loaded\n", a_Name );
+	exit( 1 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Calls an ARM function and returns what it returns in r0.
+
+	\param	a_Function		Emulated address of the function.
+	\param	a_NumArguments	Number of arguments. The ones after the fourth go on the stack.
+	\param	a_Arguments		The arguments.
+
+	The other registers are filled with garbage first, and the test stops when
+	the function doesn't preserve r4 to r11 and the stack pointer, as the
+	procedure call standard wants.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorCall( u32 a_Function, u32 a_NumArguments, const u32* a_Arguments )
+{
+	u32 saved[ 16 ];
+	u32 i;
+
+	for ( i = 0; i < 16; i++ ) s_Registers[ i ] = 0xDEAD0000 + i;
+
+	s_Registers[ 13 ] = SO_ARM_EMULATOR_STACK;
+
+	for ( i = a_NumArguments; i-- > 4; )
+	{
+		s_Registers[ 13 ] -= 4;
+		SoArmEmulatorWrite( s_Registers[ 13 ], 4, a_Arguments[ i ] );
+	}
+
+	for ( i = 0; i < a_NumArguments && i < 4; i++ ) s_Registers[ i ] = a_Arguments[ i ];
+
+	s_Registers[ 14 ] = SO_ARM_EMULATOR_RETURN_ADDRESS;
+	s_Registers[ 15 ] = a_Function;
+	s_Flags			  = 0;
+	s_NumInstructions = 0;
+	s_NumCycles		  = 0;
+	s_NumDivides	  = 0;
+	s_NumRangeCycles  = 0;
+
+	memcpy( saved, s_Registers, sizeof( saved ) );
+
+	while ( s_Registers[ 15 ] != SO_ARM_EMULATOR_RETURN_ADDRESS )
+	{
+		SoArmEmulatorStep();
+
+		if ( s_NumInstructions > SO_ARM_EMULATOR_MAX_INSTRUCTIONS ) SoArmEmulatorFail( "The call doesn't return", 0 );
+	}
+
+	for ( i = 4; i <= 13; i++ )
+	{
+		if ( i != 12 && s_Registers[ i ] != saved[ i ] ) SoArmEmulatorFail( "Register not preserved", i );
+	}
+
+	return s_Registers[ 0 ];
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the number of instructions the last \a SoArmEmulatorCall executed.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorGetNumInstructions( void )
+{
+	return s_NumInstructions;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the number of cycles the last \a SoArmEmulatorCall took on a GBA.
+
+	The code is assumed to be in IWRAM, and the data in IWRAM or EWRAM, with
+	the wait states of the GBA. Every BIOS divide counts as 
+	\a SO_ARM_EMULATOR_DIVIDE_CYCLES, which is only an estimate, so also look
+	at \a SoArmEmulatorGetNumDivides.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorGetNumCycles( void )
+{
+	return s_NumCycles;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the number of BIOS divides the last \a SoArmEmulatorCall did.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorGetNumDivides( void )
+{
+	return s_NumDivides;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Sets the instructions \a SoArmEmulatorGetNumRangeCycles counts.
+
+	\param a_Start	Emulated address of the first instruction.
+	\param a_End	Emulated address after the last one.
+
+	Use it to see how much of a routine is spent in one of its loops.
+*/
+// ----------------------------------------------------------------------------
+void SoArmEmulatorSetProfileRange( u32 a_Start, u32 a_End )
+{
+	s_RangeStart = a_Start;
+	s_RangeEnd	 = a_End;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the number of cycles the last \a SoArmEmulatorCall spent on
+		   the instructions of \a SoArmEmulatorSetProfileRange.
+*/
+// ----------------------------------------------------------------------------
+u32 SoArmEmulatorGetNumRangeCycles( void )
+{
+	return s_NumRangeCycles;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoArmEmulator.h
+	\author		Jaap Suter
+	\date		Oct 17 2026
+
+	A tiny ARM7TDMI interpreter, so the hand written ARM routines of the SGADE
+	can be run and checked on a PC. Only what those routines use is there: the
+	ARM instruction set without coprocessors and status register transfers,
+	the EWRAM and IWRAM areas, and the BIOS divide. Thumb code, interrupts and
+	the other hardware are not emulated. Anything it doesn't know stops the test.
+
+	It also counts the cycles a call would take on the GBA, so the routines
+	can be compared without one.
+
+	Object files are loaded right from the assembler output, so no GBA linker
+	is needed. Their sections all go in IWRAM, like the routines do on the GBA.
+*/
+// ----------------------------------------------------------------------------
+
+#ifndef SO_ARM_EMULATOR_H
+#define SO_ARM_EMULATOR_H
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include "SoSystem.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+#define SO_ARM_EMULATOR_EWRAM		0x02000000	//!< Start of the emulated EWRAM.
+#define SO_ARM_EMULATOR_EWRAM_SIZE	0x00040000	//!< Size of the emulated EWRAM.
+#define SO_ARM_EMULATOR_IWRAM		0x03000000	//!< Start of the emulated IWRAM.
+#define SO_ARM_EMULATOR_IWRAM_SIZE	0x00008000	//!< Size of the emulated IWRAM.
+
+/*!
+	\brief Cycles a BIOS divide counts as, the call and return included.
+
+	Only an estimate, the real number depends on the operands.
+*/
+#define SO_ARM_EMULATOR_DIVIDE_CYCLES	100
+
+// ----------------------------------------------------------------------------
+// Typedefs;
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief Returns the emulated address of a symbol an object file needs.
+
+	Return 0 if you don't know it, which stops the test.
+*/
+typedef u32 (*SoArmEmulatorSymbolResolver)( const char* a_Name );
+
+// ----------------------------------------------------------------------------
+// Functions;
+// ----------------------------------------------------------------------------
+
+void  SoArmEmulatorReset( void );
+
+u32	  SoArmEmulatorAllocate( u32 a_Size );
+void* SoArmEmulatorGetPointer( u32 a_Address, u32 a_Size );
+
+void  SoArmEmulatorLoadObject( const char* a_FileName, SoArmEmulatorSymbolResolver a_Resolver );
+u32	  SoArmEmulatorGetSymbol( const char* a_Name );
+
+u32	  SoArmEmulatorCall( u32 a_Function, u32 a_NumArguments, const u32* a_Arguments );
+u32	  SoArmEmulatorGetNumInstructions( void );
+u32	  SoArmEmulatorGetNumCycles( void );
+u32	  SoArmEmulatorGetNumDivides( void );
+
+void  SoArmEmulatorSetProfileRange( u32 a_Start, u32 a_End );
+u32	  SoArmEmulatorGetNumRangeCycles( void );
+
+#endif
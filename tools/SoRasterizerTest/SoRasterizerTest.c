@@ -0,0 +1,871 @@
+// ----------------------------------------------------------------------------
+/*!
+	Copyright (C) 2002 by the SGADE authors
+	For conditions of distribution and use, see copyright notice in SoLicense.txt
+
+	\file		SoRasterizerTest.c
+	\author		Jaap Suter
+	\date		Oct 17 2026
+
+	Checks the filling convention of the \a SoMode4PolygonRasterizer routines
+	on a PC. A render target is tessellated into a mesh of jittered quads, and
+	every triangle of it is drawn on its own. Every pixel of the target should
+	then have been written exactly once, and nothing outside of it. The assembly
+	routines are run in \a SoArmEmulator, and should write exactly the same
+	pixels as the C routines.
+
+	Run it with the object files of the assembly routines as arguments, or just
+	do "make" in this directory. Returns 0 if all is well.
+*/
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Includes;
+// ----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SoSystem.h"
+#include "SoMath.h"
+#include "SoDisplay.h"
+#include "SoTables.h"
+#include "SoMode4PolygonRasterizer.h"
+
+#include "SoArmEmulator.h"
+
+// ----------------------------------------------------------------------------
+// Defines;
+// ----------------------------------------------------------------------------
+
+//! Minimum distance between two grid lines of a mesh, in pixels.
+#define SO_RASTERIZER_TEST_MIN_CELL			3
+
+//! Maximum number of pixels a mesh sticks out on the left and on the right.
+#define SO_RASTERIZER_TEST_MAX_OVERHANG		30
+
+//! Maximum number of vertical grid lines of a mesh.
+#define SO_RASTERIZER_TEST_MAX_COLUMNS		((SO_SCREEN_WIDTH + 2 * SO_RASTERIZER_TEST_MAX_OVERHANG) / SO_RASTERIZER_TEST_MIN_CELL + 1)
+
+//! Maximum number of horizontal grid lines of a mesh.
+#define SO_RASTERIZER_TEST_MAX_ROWS			(SO_SCREEN_HEIGHT / SO_RASTERIZER_TEST_MIN_CELL + 1)
+
+//! Maximum number of vertices of a mesh.
+#define SO_RASTERIZER_TEST_MAX_VERTICES		(SO_RASTERIZER_TEST_MAX_COLUMNS * SO_RASTERIZER_TEST_MAX_ROWS)
+
+//! Maximum number of quads of a mesh.
+#define SO_RASTERIZER_TEST_MAX_QUADS		(SO_RASTERIZER_TEST_MAX_COLUMNS * SO_RASTERIZER_TEST_MAX_ROWS)
+
+//! Rows of pixels above and below a render target that should stay untouched.
+#define SO_RASTERIZER_TEST_GUARD_ROWS		2
+
+//! Maximum pitch of a render target, in bytes.
+#define SO_RASTERIZER_TEST_MAX_PITCH		256
+
+//! Value of the pixels nothing was drawn on.
+#define SO_RASTERIZER_TEST_BACKGROUND		0
+
+// ----------------------------------------------------------------------------
+// Typedefs;
+// ----------------------------------------------------------------------------
+
+/*!
+	\brief A render target filled with a mesh of quads.
+
+	The quads are split in two triangles each, alternating the diagonal.
+*/
+typedef struct
+{
+	SoVector2	m_Vertices[ SO_RASTERIZER_TEST_MAX_VERTICES ];	//!< Screen coordinates.
+	u32			m_NumVertices;									//!< Number of vertices.
+	u16			m_Quads[ SO_RASTERIZER_TEST_MAX_QUADS ][ 4 ];	//!< Clockwise vertex indices.
+	u32			m_NumQuads;										//!< Number of quads.
+
+} SoRasterizerTestMesh;
+
+/*!
+	\brief Draws one triangle of a mesh into the current render target.
+
+	\param a_Triangle	The corner points, clockwise.
+	\param a_Color		Palette index to draw it with, if the routine draws solid triangles.
+*/
+typedef void (*SoRasterizerTestDrawTriangle)( SoVector2 a_Triangle[ 3 ], u32 a_Color );
+
+// ----------------------------------------------------------------------------
+// Static variables;
+// ----------------------------------------------------------------------------
+
+static SoRasterizerTestMesh s_Mesh;		//!< Mesh that is being drawn.
+
+//! Render target the C routines draw on, with the guard rows.
+static u16 s_Buffer[ (SO_SCREEN_HEIGHT + 2 * SO_RASTERIZER_TEST_GUARD_ROWS) * SO_RASTERIZER_TEST_MAX_PITCH / 2 ];
+
+//! Number of times each pixel of the target was written.
+static u8  s_Counts[ SO_SCREEN_WIDTH * SO_SCREEN_HEIGHT ];
+
+//! Number of the triangle that wrote each pixel, for two routines that should be the same.
+static u16 s_Owners[ 2 ][ SO_SCREEN_WIDTH * SO_SCREEN_HEIGHT ];
+
+//! Render target both the C and the emulated routines draw on.
+static SoMode4PolygonRasterizerRenderTarget s_Target;
+
+//! Emulated addresses of the render target and the rasterizer globals.
+static u32 s_EmulatedBuffer;
+static u32 s_EmulatedBufferVariable;
+static u32 s_EmulatedWidthVariable;
+static u32 s_EmulatedHeightVariable;
+static u32 s_EmulatedPitchVariable;
+static u32 s_EmulatedTriangle;
+static u32 s_EmulatedIndices;
+static u32 s_EmulatedColors;
+static u32 s_EmulatedVertices;
+
+/*!
+	\brief Render targets the tests run on: width, height and pitch in bytes.
+
+	Besides the screen, there are targets with a pitch that isn't 240, targets
+	that are narrower than their pitch, and targets with an uneven width.
+*/
+static const u32 s_Targets[][ 3 ] =
+{
+	{ SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT, SO_SCREEN_WIDTH },
+	{ SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT, SO_RASTERIZER_TEST_MAX_PITCH },
+	{ 160, 128, 200 },
+	{ 101,  70, 112 },
+	{  64,  64,  64 },
+	{  17,  33,  20 }
+};
+
+//! Texture of 8 by 8 texels that are all 1, so textured triangles write 1.
+static u8  s_Texture[ 8 * 8 ];
+
+//! State of the random number generator.
+static u32 s_Random = 1;
+
+//! Number of failed checks.
+static u32 s_NumFailures = 0;
+
+// ----------------------------------------------------------------------------
+// Stubs of the library functions the rasterizer calls;
+// ----------------------------------------------------------------------------
+
+void SoDebugAssert( bool a_Assertion, char* a_Message, char* a_Expression, char* a_File, u32 a_Line )
+{
+	if ( ! a_Assertion )
+	{
+		fprintf( stderr, "%s(%u): Assertion %s failed: %s\n", a_File, a_Line, a_Expression, a_Message );
+		exit( 1 );
+	}
+}
+
+s32 SoMathDivide( s32 a_Numerator, s32 a_Denominator )
+{
+	return a_Numerator / a_Denominator;
+}
+
+u8* SoTextureCacheGetData( const SoImage* a_Texture, u32 a_Level )
+{
+	return s_Texture;
+}
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a random number in between 0 and \a a_Range - 1.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoRasterizerTestRandom( u32 a_Range )
+{
+	s_Random = s_Random * 1103515245 + 12345;
+
+	return (s_Random >> 8) % a_Range;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the emulated address of the rasterizer globals the assembly uses.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoRasterizerTestResolve( const char* a_Name )
+{
+	if ( strcmp( a_Name, "g_SoMode4PolygonRasterizerBuffer"		  ) == 0 ) return s_EmulatedBufferVariable;
+	if ( strcmp( a_Name, "g_SoMode4PolygonRasterizerBufferWidth"  ) == 0 ) return s_EmulatedWidthVariable;
+	if ( strcmp( a_Name, "g_SoMode4PolygonRasterizerBufferHeight" ) == 0 ) return s_EmulatedHeightVariable;
+	if ( strcmp( a_Name, "g_SoMode4PolygonRasterizerBufferPitch"  ) == 0 ) return s_EmulatedPitchVariable;
+
+	return 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Writes a word into emulated memory.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestPoke( u32 a_Address, u32 a_Value )
+{
+	memcpy( SoArmEmulatorGetPointer( a_Address, 4 ), &a_Value, 4 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Makes both the C and the emulated routines render to a target of the given size.
+
+	\param a_Width	Width in pixels.
+	\param a_Height	Height in pixels.
+	\param a_Pitch	Bytes from one row to the next.
+
+	The target starts \a SO_RASTERIZER_TEST_GUARD_ROWS rows into its buffer, and
+	the whole buffer is cleared.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestSetTarget( u32 a_Width, u32 a_Height, u32 a_Pitch )
+{
+	u32 size = (a_Height + 2 * SO_RASTERIZER_TEST_GUARD_ROWS) * a_Pitch;
+
+	memset( s_Buffer, SO_RASTERIZER_TEST_BACKGROUND, sizeof( s_Buffer ) );
+	memset( SoArmEmulatorGetPointer( s_EmulatedBuffer, size ), SO_RASTERIZER_TEST_BACKGROUND, size );
+
+	s_Target.m_Buffer = (u8*) s_Buffer + SO_RASTERIZER_TEST_GUARD_ROWS * a_Pitch;
+	s_Target.m_Width  = a_Width;
+	s_Target.m_Height = a_Height;
+	s_Target.m_Pitch  = a_Pitch;
+
+	SoMode4PolygonRasterizerSetRenderTarget( &s_Target );
+
+	SoRasterizerTestPoke( s_EmulatedBufferVariable, s_EmulatedBuffer + SO_RASTERIZER_TEST_GUARD_ROWS * a_Pitch );
+	SoRasterizerTestPoke( s_EmulatedWidthVariable,  a_Width );
+	SoRasterizerTestPoke( s_EmulatedHeightVariable, a_Height );
+	SoRasterizerTestPoke( s_EmulatedPitchVariable,  a_Pitch >> 1 );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Puts grid lines from \a a_Start to \a a_End, with random distances in between.
+
+	\return The number of lines.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoRasterizerTestMakeLines( s32* a_Lines, s32 a_Start, s32 a_End, s32 a_MinCell, s32 a_MaxCell )
+{
+	u32 numLines = 1;
+	s32 position = a_Start;
+
+	a_Lines[ 0 ] = a_Start;
+
+	while ( position < a_End )
+	{
+		position += a_MinCell + SoRasterizerTestRandom( a_MaxCell - a_MinCell + 1 );
+
+		// Don't leave a sliver at the end;
+		if ( position > a_End - a_MinCell ) position = a_End;
+
+		a_Lines[ numLines++ ] = position;
+	}
+
+	return numLines;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a random fixed point offset of less than \a a_Range pixels either way.
+
+	Half of them are whole pixels, to test corners that lie right on a pixel.
+	With \a a_AlmostWhole some of those are one fixed point step away from a
+	whole pixel instead, to test the rounding up of the edges.
+
+	That is only done for X. A corner one step below a scanline makes the 
+	edges that meet in it all cross that scanline within a fraction of a 
+	fixed point step. The rounding of the tangents can then swap them, and
+	write the pixel there twice. It never leaves a hole, and edges that two
+	triangles share still give the same pixels, but a test that counts every
+	pixel can't allow it.
+
+	\param a_Range			Maximum offset in pixels.
+	\param a_AlmostWhole	True to also return offsets just next to a whole pixel.
+*/
+// ----------------------------------------------------------------------------
+static sofixedpoint SoRasterizerTestJitter( s32 a_Range, bool a_AlmostWhole )
+{
+	sofixedpoint jitter;
+
+	if ( a_Range <= 0 ) return 0;
+
+	jitter = SoRasterizerTestRandom( 2 * SO_FIXED_FROM_WHOLE( a_Range ) ) - SO_FIXED_FROM_WHOLE( a_Range );
+
+	switch ( SoRasterizerTestRandom( 8 ) )
+	{
+		case 0: 
+		case 1: jitter -= SO_FIXED_TO_FRACTION( jitter ); break;
+		case 2: jitter -= SO_FIXED_TO_FRACTION( jitter ) + ( a_AlmostWhole ? 1 : 0 ); break;
+		case 3: jitter -= SO_FIXED_TO_FRACTION( jitter ) - ( a_AlmostWhole ? 1 : 0 ); break;
+	}
+
+	return jitter;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Tessellates the render target into \a s_Mesh.
+
+	\param a_MinCell	Minimum distance between two grid lines, in pixels.
+	\param a_MaxCell	Maximum distance between two grid lines, in pixels.
+	\param a_Jitter		True to move the vertices around. Vertices on the border
+						only move along it, so the mesh always covers the target.
+	\param a_Overhang	Number of pixels the mesh sticks out on the left and 
+						on the right of the target. Only the solid triangle
+						rasterizers clamp their scanlines to the target.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestMakeMesh( s32 a_MinCell, s32 a_MaxCell, bool a_Jitter, s32 a_Overhang )
+{
+	s32 columns[ SO_RASTERIZER_TEST_MAX_COLUMNS ];
+	s32 rows[ SO_RASTERIZER_TEST_MAX_ROWS ];
+	u32 numColumns = SoRasterizerTestMakeLines( columns, -a_Overhang, s_Target.m_Width + a_Overhang, a_MinCell, a_MaxCell );
+	u32 numRows	   = SoRasterizerTestMakeLines( rows,	 0,			  s_Target.m_Height,			  a_MinCell, a_MaxCell );
+	u32 x, y;
+	u16 corners[ 4 ];
+
+	SO_ASSERT( a_MinCell >= SO_RASTERIZER_TEST_MIN_CELL, "Cells are too small" );
+	SO_ASSERT( a_Overhang <= SO_RASTERIZER_TEST_MAX_OVERHANG, "Mesh sticks out too far" );
+
+	// Place the vertices. Moving them less than a quarter of the
+	// smallest cell next to them keeps all quads convex;
+	for ( y = 0; y < numRows; y++ )
+	{
+		for ( x = 0; x < numColumns; x++ )
+		{
+			SoVector2* vertex = &s_Mesh.m_Vertices[ y * numColumns + x ];
+			s32 rangeX = 0, rangeY = 0;
+
+			if ( a_Jitter && x != 0 && x != numColumns - 1 )
+			{
+				rangeX = SO_MIN( columns[ x ] - columns[ x - 1 ], columns[ x + 1 ] - columns[ x ] ) / 4;
+			}
+
+			if ( a_Jitter && y != 0 && y != numRows - 1 )
+			{
+				rangeY = SO_MIN( rows[ y ] - rows[ y - 1 ], rows[ y + 1 ] - rows[ y ] ) / 4;
+			}
+
+			vertex->m_X = SO_FIXED_FROM_WHOLE( columns[ x ] ) + SoRasterizerTestJitter( rangeX, true );
+			vertex->m_Y = SO_FIXED_FROM_WHOLE( rows[ y ] )	  + SoRasterizerTestJitter( rangeY, false );
+		}
+	}
+
+	s_Mesh.m_NumVertices = numRows * numColumns;
+
+	// Make the quads, clockwise on the screen. Start every other one at
+	// another corner, so the triangles alternate their diagonal;
+	s_Mesh.m_NumQuads = 0;
+
+	for ( y = 0; y < numRows - 1; y++ )
+	{
+		for ( x = 0; x < numColumns - 1; x++ )
+		{
+			u32 start = (x + y) & 1;
+			u32 i;
+
+			corners[ 0 ] = y * numColumns + x;
+			corners[ 1 ] = y * numColumns + x + 1;
+			corners[ 2 ] = (y + 1) * numColumns + x + 1;
+			corners[ 3 ] = (y + 1) * numColumns + x;
+
+			for ( i = 0; i < 4; i++ ) s_Mesh.m_Quads[ s_Mesh.m_NumQuads ][ i ] = corners[ (i + start) & 3 ];
+
+			s_Mesh.m_NumQuads++;
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns a triangle of \a s_Mesh, two per quad.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestGetTriangle( u32 a_Index, SoVector2 a_Triangle[ 3 ], u16 a_Indices[ 3 ] )
+{
+	u16* quad = s_Mesh.m_Quads[ a_Index >> 1 ];
+
+	a_Indices[ 0 ] = quad[ 0 ];
+	a_Indices[ 1 ] = quad[ (a_Index & 1) + 1 ];
+	a_Indices[ 2 ] = quad[ (a_Index & 1) + 2 ];
+
+	a_Triangle[ 0 ] = s_Mesh.m_Vertices[ a_Indices[ 0 ] ];
+	a_Triangle[ 1 ] = s_Mesh.m_Vertices[ a_Indices[ 1 ] ];
+	a_Triangle[ 2 ] = s_Mesh.m_Vertices[ a_Indices[ 2 ] ];
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Returns the palette index triangle \a a_Index is drawn with, never 0.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoRasterizerTestGetColor( u32 a_Index )
+{
+	return 1 + a_Index % 255;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Counts the pixels written since the last call, and clears them again.
+
+	\param a_Buffer		Buffer of the render target, including the guard rows.
+	\param a_Owner		Number of the triangle that was drawn.
+	\param a_Owners		Gets \a a_Owner for every pixel that was written.
+
+	\return The number of pixels that were written outside of the target.
+*/
+// ----------------------------------------------------------------------------
+static u32 SoRasterizerTestCount( u8* a_Buffer, u16 a_Owner, u16* a_Owners )
+{
+	u32 numRows = s_Target.m_Height + 2 * SO_RASTERIZER_TEST_GUARD_ROWS;
+	u32 numOutside = 0;
+	u32 x, y;
+
+	for ( y = 0; y < numRows; y++ )
+	{
+		u8* pixel = a_Buffer + y * s_Target.m_Pitch;
+		s32 row	  = (s32) y - SO_RASTERIZER_TEST_GUARD_ROWS;
+
+		for ( x = 0; x < s_Target.m_Pitch; x++ )
+		{
+			if ( pixel[ x ] == SO_RASTERIZER_TEST_BACKGROUND ) continue;
+
+			pixel[ x ] = SO_RASTERIZER_TEST_BACKGROUND;
+
+			if ( row < 0 || row >= (s32) s_Target.m_Height || x >= s_Target.m_Width )
+			{
+				numOutside++;
+				continue;
+			}
+
+			if ( s_Counts[ row * s_Target.m_Width + x ] < 255 ) s_Counts[ row * s_Target.m_Width + x ]++;
+			a_Owners[ row * s_Target.m_Width + x ] = a_Owner;
+		}
+	}
+
+	return numOutside;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Reports a failed check.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestFail( const char* a_Name, const char* a_Message, s32 a_X, s32 a_Y )
+{
+	printf( "FAILED: %s at %d x %d (pitch %u): %s at pixel %d, %d\n", a_Name,
+			s_Target.m_Width, s_Target.m_Height, s_Target.m_Pitch, a_Message, a_X, a_Y );
+
+	s_NumFailures++;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws all triangles of \a s_Mesh one by one, and checks that every
+		   pixel of the target was written exactly once.
+
+	\param a_Name		Name of the routine, for the messages.
+	\param a_Draw		Routine that draws a triangle.
+	\param a_Emulated	True if \a a_Draw draws on the emulated render target.
+	\param a_Owners		Gets the number of the triangle that drew each pixel.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestCoverage( const char* a_Name, SoRasterizerTestDrawTriangle a_Draw,
+									  bool a_Emulated, u16* a_Owners )
+{
+	u32 numPixels  = s_Target.m_Width * s_Target.m_Height;
+	u32 numOutside = 0;
+	u32 numWrong   = 0;
+	u32 firstWrong = 0;
+	u8* buffer;
+	u32 i;
+	SoVector2 triangle[ 3 ];
+	u16		  indices[ 3 ];
+
+	buffer = a_Emulated ? SoArmEmulatorGetPointer( s_EmulatedBuffer, sizeof( s_Buffer ) ) : (u8*) s_Buffer;
+
+	memset( s_Counts, 0, sizeof( s_Counts ) );
+
+	for ( i = 0; i < s_Mesh.m_NumQuads * 2; i++ )
+	{
+		SoRasterizerTestGetTriangle( i, triangle, indices );
+
+		a_Draw( triangle, SoRasterizerTestGetColor( i ) );
+
+		numOutside += SoRasterizerTestCount( buffer, i, a_Owners );
+	}
+
+	for ( i = 0; i < numPixels; i++ )
+	{
+		if ( s_Counts[ i ] != 1 && numWrong++ == 0 ) firstWrong = i;
+	}
+
+	if ( numOutside )
+	{
+		SoRasterizerTestFail( a_Name, "pixels written outside of the target", -1, -1 );
+	}
+
+	if ( numWrong )
+	{
+		SoRasterizerTestFail( a_Name, s_Counts[ firstWrong ] ? "a pixel written more than once"
+															: "a pixel not written",
+							  firstWrong % s_Target.m_Width, firstWrong / s_Target.m_Width );
+		printf( "        %u of the %u pixels are wrong\n", numWrong, numPixels );
+	}
+
+	printf( "%-40s %3u x %3u, pitch %3u, %5u triangles: %s\n", a_Name,
+			s_Target.m_Width, s_Target.m_Height, s_Target.m_Pitch,
+			s_Mesh.m_NumQuads * 2, numOutside || numWrong ? "FAILED" : "ok" );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Checks that two routines drew every pixel with the same triangle.
+
+	Call it after running \a SoRasterizerTestCoverage for both, with
+	\a s_Owners[ 0 ] and \a s_Owners[ 1 ].
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestCompareOwners( const char* a_Name )
+{
+	u32 numPixels = s_Target.m_Width * s_Target.m_Height;
+	u32 i;
+
+	for ( i = 0; i < numPixels; i++ )
+	{
+		if ( s_Owners[ 0 ][ i ] != s_Owners[ 1 ][ i ] )
+		{
+			SoRasterizerTestFail( a_Name, "a pixel drawn by another triangle",
+								  i % s_Target.m_Width, i / s_Target.m_Width );
+			return;
+		}
+	}
+
+	printf( "%-40s %3u x %3u, pitch %3u: same pixels\n", a_Name,
+			s_Target.m_Width, s_Target.m_Height, s_Target.m_Pitch );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Draws all of \a s_Mesh with a single call of the assembly 
+		   \a SoMode4PolygonRasterizerDrawSolidTriangles, and checks that the
+		   result is the same as drawing it with \a SoMode4PolygonRasterizerDrawSolidTriangleC
+		   triangle by triangle, in the same colors.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestSolidTriangleList( void )
+{
+	u32 numTriangles = s_Mesh.m_NumQuads * 2;
+	u32 size		 = (s_Target.m_Height + 2 * SO_RASTERIZER_TEST_GUARD_ROWS) * s_Target.m_Pitch;
+	u16* indices	 = SoArmEmulatorGetPointer( s_EmulatedIndices, numTriangles * 3 * sizeof( u16 ) );
+	u8*  colors		 = SoArmEmulatorGetPointer( s_EmulatedColors,  numTriangles );
+	u8*  buffer		 = SoArmEmulatorGetPointer( s_EmulatedBuffer,  size );
+	u32	 arguments[ 4 ] = { s_EmulatedVertices, s_EmulatedIndices, numTriangles, s_EmulatedColors };
+	u32	 i;
+	SoVector2 triangle[ 3 ];
+
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedVertices, s_Mesh.m_NumVertices * sizeof( SoVector2 ) ),
+			s_Mesh.m_Vertices, s_Mesh.m_NumVertices * sizeof( SoVector2 ) );
+
+	for ( i = 0; i < numTriangles; i++ )
+	{
+		SoRasterizerTestGetTriangle( i, triangle, &indices[ i * 3 ] );
+		colors[ i ] = SoRasterizerTestGetColor( i );
+
+		SoMode4PolygonRasterizerDrawSolidTriangleC( triangle, colors[ i ] );
+	}
+
+	SoArmEmulatorCall( SoArmEmulatorGetSymbol( "SoMode4PolygonRasterizerDrawSolidTriangles" ), 4, arguments );
+
+	for ( i = 0; i < size && buffer[ i ] == ((u8*) s_Buffer)[ i ]; i++ );
+
+	if ( i != size )
+	{
+		SoRasterizerTestFail( "SolidTriangles (ARM)", "not the same as SolidTriangleC",
+							  i % s_Target.m_Pitch, (s32)( i / s_Target.m_Pitch ) - SO_RASTERIZER_TEST_GUARD_ROWS );
+	}
+	else
+	{
+		printf( "%-40s %3u x %3u, pitch %3u, %5u triangles: same bytes\n", "SolidTriangles (ARM), the whole mesh",
+				s_Target.m_Width, s_Target.m_Height, s_Target.m_Pitch, numTriangles );
+	}
+
+	memset( s_Buffer, SO_RASTERIZER_TEST_BACKGROUND, size );
+	memset( buffer,   SO_RASTERIZER_TEST_BACKGROUND, size );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// The routines that are tested;
+// ----------------------------------------------------------------------------
+
+static void SoRasterizerTestDrawSolidTriangleC( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	SoMode4PolygonRasterizerDrawSolidTriangleC( a_Triangle, a_Color );
+}
+
+static void SoRasterizerTestDrawSolidTriangleArm( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	u32 arguments[ 2 ] = { s_EmulatedTriangle, a_Color };
+
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedTriangle, 3 * sizeof( SoVector2 ) ),
+			a_Triangle, 3 * sizeof( SoVector2 ) );
+
+	SoArmEmulatorCall( SoArmEmulatorGetSymbol( "SoMode4PolygonRasterizerDrawSolidTriangle" ), 2, arguments );
+}
+
+static void SoRasterizerTestDrawSolidTrianglesArm( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	u16 indices[ 3 ] = { 0, 1, 2 };
+	u32 arguments[ 4 ] = { s_EmulatedTriangle, s_EmulatedIndices, 1, s_EmulatedColors };
+
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedTriangle, 3 * sizeof( SoVector2 ) ),
+			a_Triangle, 3 * sizeof( SoVector2 ) );
+	memcpy( SoArmEmulatorGetPointer( s_EmulatedIndices, sizeof( indices ) ), indices, sizeof( indices ) );
+	*(u8*) SoArmEmulatorGetPointer( s_EmulatedColors, 1 ) = a_Color;
+
+	SoArmEmulatorCall( SoArmEmulatorGetSymbol( "SoMode4PolygonRasterizerDrawSolidTriangles" ), 4, arguments );
+}
+
+static void SoRasterizerTestDrawSolidPolygon( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	SoMode4PolygonRasterizerDrawSolidPolygon( 3, a_Triangle, a_Color );
+}
+
+static SoVector2 s_TextureCoordinates[ 3 ] =
+{
+	{ 0, 0 }, { SO_FIXED_FROM_WHOLE( 1 ), 0 }, { SO_FIXED_FROM_WHOLE( 1 ), SO_FIXED_FROM_WHOLE( 1 ) }
+};
+
+static void SoRasterizerTestDrawTexturedTriangle( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	SoMode4PolygonRasterizerDrawTexturedTriangle( a_Triangle, s_TextureCoordinates );
+}
+
+static void SoRasterizerTestDrawTexturedTriangles( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	u16 indices[ 3 ] = { 0, 1, 2 };
+
+	SoMode4PolygonRasterizerDrawTexturedTriangles( a_Triangle, indices, 1, s_TextureCoordinates );
+}
+
+static void SoRasterizerTestDrawPerspectiveTexturedTriangle( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	sofixedpoint depths[ 3 ] = { SO_FIXED_FROM_WHOLE( 10 ), SO_FIXED_FROM_WHOLE( 20 ), SO_FIXED_FROM_WHOLE( 40 ) };
+
+	SoMode4PolygonRasterizerDrawPerspectiveTexturedTriangle( a_Triangle, s_TextureCoordinates, depths, 8 );
+}
+
+static void SoRasterizerTestDrawTexturedPolygon( SoVector2 a_Triangle[ 3 ], u32 a_Color )
+{
+	SoMode4PolygonRasterizerDrawTexturedPolygon( 3, a_Triangle, s_TextureCoordinates );
+}
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Runs the tests of the solid triangle rasterizers on the current render target and mesh.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestSolidRoutines( void )
+{
+	SoRasterizerTestCoverage( "SolidTriangleC",			   SoRasterizerTestDrawSolidTriangleC,			   false, s_Owners[ 0 ] );
+	SoRasterizerTestCoverage( "SolidTriangle (ARM)",	   SoRasterizerTestDrawSolidTriangleArm,		   true,  s_Owners[ 1 ] );
+	SoRasterizerTestCompareOwners( "SolidTriangle (ARM) and SolidTriangleC" );
+	SoRasterizerTestCoverage( "SolidTriangles (ARM)",	   SoRasterizerTestDrawSolidTrianglesArm,		   true,  s_Owners[ 1 ] );
+	SoRasterizerTestCompareOwners( "SolidTriangles (ARM) and SolidTriangleC" );
+	SoRasterizerTestSolidTriangleList();
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Prints what the assembly \a SoMode4PolygonRasterizerDrawSolidTriangle
+		   costs on a GBA for the triangles of \a s_Mesh that fit in 8 by 8 pixels.
+
+	The cycles are split in the BIOS divides of the tangents, the plotting
+	of the pixels, and the rest, which is the setup and the edge walk. Any 
+	other routine has to walk the edges exactly the same way to give the 
+	same pixels, so it can only win on the plotting.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestSmallTriangleCycles( void )
+{
+	u8* buffer		 = SoArmEmulatorGetPointer( s_EmulatedBuffer, sizeof( s_Buffer ) );
+	u32 numTriangles = 0;
+	u32 numCycles	 = 0;
+	u32 numDivides	 = 0;
+	u32 numPlotting	 = 0;
+	u32 numPixels	 = 0;
+	u32 i;
+	SoVector2 triangle[ 3 ];
+	u16		  indices[ 3 ];
+
+	SoArmEmulatorSetProfileRange( SoArmEmulatorGetSymbol( "drawScanline" ), SoArmEmulatorGetSymbol( "endOfScanline" ) );
+
+	memset( s_Counts, 0, sizeof( s_Counts ) );
+
+	for ( i = 0; i < s_Mesh.m_NumQuads * 2; i++ )
+	{
+		sofixedpoint minX, maxX, minY, maxY;
+
+		SoRasterizerTestGetTriangle( i, triangle, indices );
+
+		minX = SO_MIN( triangle[ 0 ].m_X, SO_MIN( triangle[ 1 ].m_X, triangle[ 2 ].m_X ) );
+		maxX = SO_MAX( triangle[ 0 ].m_X, SO_MAX( triangle[ 1 ].m_X, triangle[ 2 ].m_X ) );
+		minY = SO_MIN( triangle[ 0 ].m_Y, SO_MIN( triangle[ 1 ].m_Y, triangle[ 2 ].m_Y ) );
+		maxY = SO_MAX( triangle[ 0 ].m_Y, SO_MAX( triangle[ 1 ].m_Y, triangle[ 2 ].m_Y ) );
+
+		if ( SO_FIXED_CEIL_WHOLE( maxX ) - SO_FIXED_CEIL_WHOLE( minX ) > 8 ||
+			 SO_FIXED_CEIL_WHOLE( maxY ) - SO_FIXED_CEIL_WHOLE( minY ) > 8 )
+		{
+			continue;
+		}
+
+		SoRasterizerTestDrawSolidTriangleArm( triangle, SoRasterizerTestGetColor( i ) );
+		SoRasterizerTestCount( buffer, i, s_Owners[ 1 ] );
+
+		numTriangles++;
+		numCycles	+= SoArmEmulatorGetNumCycles();
+		numDivides	+= SoArmEmulatorGetNumDivides();
+		numPlotting += SoArmEmulatorGetNumRangeCycles();
+	}
+
+	SoArmEmulatorSetProfileRange( 0, 0 );
+
+	for ( i = 0; i < s_Target.m_Width * s_Target.m_Height; i++ ) numPixels += s_Counts[ i ];
+
+	if ( numTriangles == 0 ) return;
+
+	printf( "%-40s %5u triangles, %4.1f pixels: %5.1f cycles, %4.2f divides (%5.1f cycles), %5.1f plotting\n",
+			"SolidTriangle (ARM), at most 8 x 8", numTriangles, (float) numPixels / numTriangles,
+			(float) numCycles / numTriangles, (float) numDivides / numTriangles,
+			(float) numDivides * SO_ARM_EMULATOR_DIVIDE_CYCLES / numTriangles,
+			(float) numPlotting / numTriangles );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Runs all tests on the current render target and mesh.
+*/
+// ----------------------------------------------------------------------------
+static void SoRasterizerTestRoutines( void )
+{
+	SoRasterizerTestSolidRoutines();
+
+	SoRasterizerTestCoverage( "SolidPolygon",			   SoRasterizerTestDrawSolidPolygon,			   false, s_Owners[ 1 ] );
+	SoRasterizerTestCoverage( "TexturedTriangle",		   SoRasterizerTestDrawTexturedTriangle,		   false, s_Owners[ 1 ] );
+	SoRasterizerTestCoverage( "TexturedTriangles",		   SoRasterizerTestDrawTexturedTriangles,		   false, s_Owners[ 1 ] );
+	SoRasterizerTestCoverage( "PerspectiveTexturedTriangle", SoRasterizerTestDrawPerspectiveTexturedTriangle, false, s_Owners[ 1 ] );
+	SoRasterizerTestCoverage( "TexturedPolygon",		   SoRasterizerTestDrawTexturedPolygon,			   false, s_Owners[ 1 ] );
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*!
+	\brief Loads the assembly routines, and runs the tests on a few meshes.
+*/
+// ----------------------------------------------------------------------------
+int main( int a_NumArguments, char** a_Arguments )
+{
+	s32 i;
+	u32 target;
+
+	SoArmEmulatorReset();
+
+	s_EmulatedBuffer		 = SoArmEmulatorAllocate( sizeof( s_Buffer ) );
+	s_EmulatedBufferVariable = SoArmEmulatorAllocate( 4 );
+	s_EmulatedWidthVariable	 = SoArmEmulatorAllocate( 4 );
+	s_EmulatedHeightVariable = SoArmEmulatorAllocate( 4 );
+	s_EmulatedPitchVariable	 = SoArmEmulatorAllocate( 4 );
+	s_EmulatedTriangle		 = SoArmEmulatorAllocate( 3 * sizeof( SoVector2 ) );
+	s_EmulatedVertices		 = SoArmEmulatorAllocate( SO_RASTERIZER_TEST_MAX_VERTICES * sizeof( SoVector2 ) );
+	s_EmulatedIndices		 = SoArmEmulatorAllocate( SO_RASTERIZER_TEST_MAX_QUADS * 6 * sizeof( u16 ) );
+	s_EmulatedColors		 = SoArmEmulatorAllocate( SO_RASTERIZER_TEST_MAX_QUADS * 2 );
+
+	for ( i = 1; i < a_NumArguments; i++ )
+	{
+		SoArmEmulatorLoadObject( a_Arguments[ i ], SoRasterizerTestResolve );
+	}
+
+	// Setup the rasterizer;
+	SoMode4PolygonRasterizerInitialize();
+
+	memset( s_Texture, 1, sizeof( s_Texture ) );
+	g_SoMode4PolygonRasterizerTextureData   = s_Texture;
+	g_SoMode4PolygonRasterizerTextureUShift = 3;
+	g_SoMode4PolygonRasterizerTextureVShift = 3;
+	g_SoMode4PolygonRasterizerTextureUMask  = 7;
+	g_SoMode4PolygonRasterizerTextureVMask  = 7;
+
+	for ( target = 0; target < sizeof( s_Targets ) / sizeof( s_Targets[ 0 ] ); target++ )
+	{
+		SoRasterizerTestSetTarget( s_Targets[ target ][ 0 ], s_Targets[ target ][ 1 ], s_Targets[ target ][ 2 ] );
+
+		// A regular grid, with corners on whole pixels and lots of horizontal and vertical edges;
+		SoRasterizerTestMakeMesh( 24, 24, false, 0 );
+		SoRasterizerTestRoutines();
+
+		// A grid of different cell sizes;
+		SoRasterizerTestMakeMesh( 20, 60, false, 0 );
+		SoRasterizerTestRoutines();
+
+		// Jittered grids;
+		for ( i = 0; i < (target == 0 ? 16 : 4); i++ )
+		{
+			SoRasterizerTestMakeMesh( 20, 60, true, 0 );
+			SoRasterizerTestRoutines();
+		}
+
+		// Jittered grids that stick out on the sides, which
+		// only the solid triangle rasterizers can clamp;
+		for ( i = 0; i < 4; i++ )
+		{
+			SoRasterizerTestMakeMesh( 20, 60, true, SO_RASTERIZER_TEST_MAX_OVERHANG );
+			SoRasterizerTestSolidRoutines();
+		}
+
+		// Jittered grids of tiny triangles mixed with bigger ones;
+		for ( i = 0; i < 4; i++ )
+		{
+			SoRasterizerTestMakeMesh( 3, i * 4 + 6, true, i );
+			SoRasterizerTestSolidRoutines();
+		}
+	}
+
+	// What the tiny triangles of a distant mesh cost;
+	SoRasterizerTestSetTarget( SO_SCREEN_WIDTH, SO_SCREEN_HEIGHT, SO_SCREEN_WIDTH );
+
+	for ( i = 0; i < 4; i++ )
+	{
+		SoRasterizerTestMakeMesh( 3, i + 4, true, 0 );
+		SoRasterizerTestSmallTriangleCycles();
+	}
+
+	if ( s_NumFailures )
+	{
+		printf( "%u checks FAILED\n", s_NumFailures );
+		return 1;
+	}
+
+	printf( "All checks passed\n" );
+	return 0;
+}
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// EOF;
+// ----------------------------------------------------------------------------